@@ -13,8 +13,8 @@
 
 namespace tpp {
 
-   // test support
-   bool g_disableAsserts = false;
+   // test support, per thread
+   thread_local bool g_disableAsserts = false;
 
 
 bool MyAssertFunction( bool b, const char* desc, int line, const char* file)
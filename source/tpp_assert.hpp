@@ -9,7 +9,7 @@ namespace tpp {
 #ifndef REVIVER_ASSERT_HPP
 #define REVIVER_ASSERT_HPP
 
-extern bool g_disableAsserts;
+extern thread_local bool g_disableAsserts;
 extern bool MyAssertFunction( bool b, const char* desc, int line, const char* file);
 
 // macro
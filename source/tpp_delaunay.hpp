@@ -19,6 +19,13 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <memory_resource>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <cstdint>
 
 class Triwrap;
 struct triangulateio;
@@ -31,6 +38,7 @@ namespace tpp
    class VoronoiEdgeIterator;
 
    class TriangulationMesh;
+   class TextFileParser;
    struct FacesList;
    struct VertexList;
    struct VoronoiVertexList;
@@ -51,6 +59,214 @@ namespace tpp
       Sweepline
    };
 
+   enum PredicateMode
+   {
+      Robust,        // the default! TriLib's adaptive predicates: a floating-point filter, exact arithmetic if it fails
+      Unchecked      // floating-point only (as TriLib's -X switch), for trusted, e.g. jittered input
+   };
+
+
+   /**
+      @brief: Flat arrays of a triangulation, as filled by Delaunay::exportMesh()
+
+      Vertices are numbered as in the triangulation, i.e. input points first, followed by the Steiner points. 
+      The vertices of a triangle are listed counterclockwise, the i-th neighbor of a triangle is the one 
+      opposite to its i-th vertex, or -1 on the boundary. Triangles are numbered in the order of FaceIterator.
+
+      If a buffer pointer is set, the caller-provided buffer is filled instead of the corresponding vector. 
+      It must be big enough for Delaunay::verticeCount(), triangleCount() resp. edgeCount() entries.
+    */
+   struct MeshBuffers
+   {
+      bool exportNeighbors = true;
+      bool exportEdges = false;
+
+      int vertexCount = 0;
+      int triangleCount = 0;
+      int edgeCount = 0;
+
+      std::vector<double> points;        // x and y for each vertex
+      std::vector<int32_t> triangles;    // 3 vertex indexes for each triangle
+      std::vector<int32_t> neighbors;    // 3 triangle indexes for each triangle
+      std::vector<int32_t> edges;        // 2 vertex indexes for each edge
+      std::vector<int32_t> edgeMarkers;  // boundary marker of each edge, as in TriLib's .edge files
+
+      double* pointsBuffer = nullptr;
+      int32_t* trianglesBuffer = nullptr;
+      int32_t* neighborsBuffer = nullptr;
+      int32_t* edgesBuffer = nullptr;
+      int32_t* edgeMarkersBuffer = nullptr;
+   };
+
+
+   /**
+      @brief: Adjacency of a triangulation in compressed sparse row (CSR) format, as filled by Delaunay::exportAdjacency()
+
+      The entries of the i-th row are at the positions offsets[i] up to offsets[i + 1] - 1 of the row's 
+      entries array, e.g. the vertices adjacent to the vertex v are vertexNeighbors[vertexOffsets[v]] up 
+      to vertexNeighbors[vertexOffsets[v + 1] - 1]. Vertices and triangles are numbered as in MeshBuffers.
+
+      The rows of vertices are sorted ascendingly, the row of a triangle lists its neighbors in the order of
+      MeshBuffers::neighbors, without the boundary (-1) entries.
+    */
+   struct MeshAdjacency
+   {
+      bool exportVertexNeighbors = true;
+      bool exportVertexTriangles = true;
+      bool exportTriangleNeighbors = true;
+
+      int vertexCount = 0;
+      int triangleCount = 0;
+
+      std::vector<int32_t> vertexOffsets;             // vertexCount + 1 offsets into vertexNeighbors
+      std::vector<int32_t> vertexNeighbors;           // vertices sharing an edge with the vertex
+      std::vector<int32_t> vertexTriangleOffsets;     // vertexCount + 1 offsets into vertexTriangles
+      std::vector<int32_t> vertexTriangles;           // triangles having the vertex as corner
+      std::vector<int32_t> triangleOffsets;           // triangleCount + 1 offsets into triangleNeighbors
+      std::vector<int32_t> triangleNeighbors;         // triangles sharing an edge with the triangle
+   };
+
+
+   /**
+      @brief: A finished triangle of a streaming triangulation, @see Delaunay::triangulateStream()
+
+      The vertices are listed counterclockwise. A vertex id is the position of the point in the input file, 
+      starting at 0.
+    */
+   struct StreamedTriangle
+   {
+      int32_t vertexIds[3];
+      double points[3][2];  // x and y of each vertex
+   };
+
+   typedef std::function<void(const StreamedTriangle&)> TriangleSink;
+
+
+   /**
+      @brief: Phases of a triangulation, as reported to a progress callback, @see RunControl
+    */
+   enum TriangulationPhase
+   {
+      Triangulating,      // Delaunay triangulation of the points
+      InsertingSegments,  // recovery of the segment constraints
+      CarvingHoles,       // removal of holes and concavities, spreading of the regional constraints
+      Refining            // insertion of Steiner points for the quality constraints
+   };
+
+
+   /**
+      @brief: Progress of a running triangulation, @see RunControl
+
+      The steps of the phases are the input points, the segments, the holes and regions, and the inserted 
+      Steiner points. The total number of Steiner points isn't known in advance, it's the Steiner point 
+      budget if one was set, until the last report of the phase. Each phase ends with done == total.
+    */
+   struct TriangulationProgress
+   {
+      TriangulationPhase phase;
+      size_t done;            // steps done in this phase
+      size_t total;           // steps of this phase, 0 if unknown
+      double elapsedSeconds;  // since the triangulation was started
+   };
+
+
+   /**
+      @brief: Cancels a triangulation running in another thread, @see RunControl
+
+      Copies share their state, so the cancelling thread keeps a copy of the token passed to the Delaunay
+      object.
+    */
+   class CancellationToken
+   {
+   public:
+      CancellationToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+      void cancel() { m_cancelled->store(true); }
+      void reset() { m_cancelled->store(false); }
+      bool isCancelled() const { return m_cancelled->load(); }
+
+   private:
+      std::shared_ptr<std::atomic<bool>> m_cancelled;
+   };
+
+
+   /**
+      @brief: Thrown if a triangulation was cancelled or ran out of time, @see RunControl
+    */
+   class TriangulationAborted : public std::runtime_error
+   {
+   public:
+      enum Reason
+      {
+         Cancelled,
+         TimeBudgetExceeded
+      };
+
+      TriangulationAborted(Reason reason, TriangulationPhase phase)
+         : std::runtime_error(reason == Cancelled ? "Triangulation cancelled" : "Triangulation ran out of time"),
+           m_reason(reason),
+           m_phase(phase)
+      {}
+
+      Reason reason() const { return m_reason; }
+      TriangulationPhase phase() const { return m_phase; }
+
+   private:
+      Reason m_reason;
+      TriangulationPhase m_phase;
+   };
+
+
+   /**
+      @brief: Progress reports, budgets and cancellation of long triangulations, @see Delaunay::setRunControl()
+
+      The progress callback, the cancellation token and the time budget are checked by the thread which 
+      started the triangulation at safe points of the main loops: at the start and the end of each phase, 
+      every 1024 steps, and after each round of a multi-threaded refinement. The worker threads aren't 
+      interrupted, they finish their current tasks.
+    */
+   struct RunControl
+   {
+      std::function<void(const TriangulationProgress&)> progress;  // may throw to abort the triangulation
+      double progressIntervalSeconds = 0.1;  // min. time between the progress calls within a phase
+      double timeBudgetSeconds = 0.0;        // wall-clock budget, 0 for none
+      int maxSteinerPoints = -1;             // Steiner point budget (as TriLib's -S switch), -1 for none
+      CancellationToken cancellation;
+   };
+
+
+   /**
+      @brief: How often the predicates of the last triangulation needed exact arithmetic, 
+              @see Delaunay::predicateStats()
+    */
+   struct PredicateStats
+   {
+      size_t incircleTests = 0;
+      size_t incircleExact = 0;     // the filter failed, incircleadapt() was called
+      size_t orientationTests = 0;
+      size_t orientationExact = 0;  // the filter failed, counterclockwiseadapt() was called
+   };
+
+
+   /**
+      @brief: A background sizing field given on a regular grid, @see Delaunay::setSizingField()
+
+      The target edge lengths are given at the nodes of the grid and interpolated bilinearly in between. 
+      Outside of the grid the values of the nearest border are used. A nonpositive value at one of the 
+      corners of a grid cell leaves the cell unconstrained.
+    */
+   struct SizingGrid
+   {
+      double xmin = 0.0;  // position of the first node
+      double ymin = 0.0;
+      double dx = 1.0;    // distance of the nodes
+      double dy = 1.0;
+      int nx = 0;         // nodes in a row
+      int ny = 0;         // number of rows
+
+      std::vector<double> edgeLengths;  // nx * ny target edge lengths, row by row starting at ymin
+   };
+
 
    /**
       @brief: The main Delaunay class that wraps original Triangle (aka TriLib) code by J.R. Shewchuk
@@ -63,12 +279,16 @@ namespace tpp
      
       @note: Currently the dpoint class by Piyush Kumar is used: a d-dimensional reviver::dpoint class 
              with d=2. If you want to use your own point class, you might have to work hard :-(...
+      @note: Instances don't share any state, so different Delaunay objects can be used concurrently 
+             by different threads (@see also triangulateBatch()). A single object isn't thread-safe though.
     */
    class TRPP_LIB_EXPORT Delaunay
    {
    public:
       typedef reviver::dpoint<double, 2> Point; // OPEN TODO:: decouple from this dependency!
       typedef reviver::dpoint<double, 4> Point4; // OPEN TODO:: decouple from this dependency!
+      typedef std::function<bool(const Point& org, const Point& dest, const Point& apex, double area)> UserTest;
+      typedef std::function<double(double x, double y)> SizingFunction;
 
       /**
          @brief: constructor
@@ -142,17 +362,209 @@ namespace tpp
       void Tesselate(bool useConformingDelaunay = false, DebugOutputLevel traceLvl = None);
     
       /**
-        @brief: Enable incremental numbering of vertices in the triangulation while iterating over faces
+        @brief: Enable the dense numbering of the vertices in the triangulation, @see FaceIterator::Org()
+
+        The vertices are numbered once after each triangulation and each in-place update, in the order in 
+        which the face iteration meets them (Org, Dest, Apex of each face). So the mesh indexes don't depend 
+        on the iteration and the faces can be iterated by several threads.
 
         @note: must be set before Triangulate() was called to take effect
        */
       void enableMeshIndexGeneration();
 
+      /**
+        @brief: Enable dense triangle ids, @see TriangulationMesh::triangleAt()
+
+        The triangles are numbered from 0 to triangleCount() - 1 after each triangulation and each in-place 
+        update, in the order of the face iteration (and of exportMesh()), so that per-triangle data can be 
+        kept in arrays and the faces and their neighbors can be addressed by integer ids.
+
+        @note: must be set before Triangulate() was called to take effect, it costs an integer per triangle
+       */
+      void enableTriangleIds(bool enable = true) { m_triangleIds = enable; }
+
       /**
         @brief: Change the triangulation algorithm
        */
       void setAlgorithm(AlgorithmType alg);
 
+      /**
+        @brief: Set the number of threads used for triangulation
+
+        The divide-and-conquer algorithm triangulates parts of the input on a work-stealing thread pool, 
+        each thread allocating triangles from its own memory pool. The resulting Delaunay triangulation is the 
+        same as with a single thread (but the triangles are stored in different order, so quality triangulations
+        may choose other Steiner points!). Small inputs are always triangulated by a single thread.
+
+        A quality triangulation inserts its Steiner points in rounds: the points of many bad triangles are 
+        found in parallel together with their cavities (the triangles to be replaced), the points whose cavities 
+        don't touch each other are inserted concurrently and the others are retried in the next round. Points 
+        encroaching upon a segment are handled by a single thread as before, so the angle and area bounds hold 
+        just as with a single thread, but the Steiner points differ.
+
+        @param threadCount: number of threads, 0 for the number of hardware threads, 1 (default) disables 
+                            multi-threading
+        @note: must be set before Triangulate() was called to take effect. Currently only the DivideConquer 
+               algorithm can use multiple threads for the triangulation itself, the quality refinement can
+               use them with all algorithms. Big .node and .poly files are also parsed with these threads.
+       */
+      void setThreadCount(unsigned threadCount) { m_threadCount = threadCount; }
+
+      /**
+        @brief: Set the size of the tiles for a multi-threaded triangulation
+
+        The multi-threaded divide-and-conquer partitions the bounding box of the points into tiles by alternating
+        median cuts, triangulates the tiles in parallel, each in its own memory pool, and stitches the seams 
+        by merging the neighbouring convex hulls, so the result is the exact Delaunay triangulation. By default 
+        the number of tiles depends on the thread count. With a tile size, the points are cut into as many tiles 
+        as possible having at least this many points, regardless of the thread count, so that for huge inputs 
+        the work of a tile stays in the CPU caches. 
+
+        @param pointsPerTile: min. number of points per tile (at least 2048), 0 (default) for automatic tiling 
+        @note: only used if more than one thread is set, @see setThreadCount()
+       */
+      void setTileSize(unsigned pointsPerTile) { m_tileSize = pointsPerTile; }
+
+      /**
+        @brief: Keep the memory of a triangulation for the next one
+
+        Normally all of TriLib's memory pools are freed when Triangulate() (or TriangulateConf(), Tesselate())
+        is called again. With pool reuse enabled, the allocated blocks of vertices, triangles, subsegments 
+        and quality queues are kept and restarted instead, so repeated triangulations of similar-sized inputs
+        (e.g. in an optimization loop) don't have to allocate them again. The memory is freed when the 
+        Delaunay object is destroyed.
+
+        @param enable: true to reuse the memory pools, false (default) to free them between triangulations
+        @note: the kept memory grows to the biggest triangulation done so far
+       */
+      void enableMemoryPoolReuse(bool enable = true) { m_reusePools = enable; }
+
+      /**
+        @brief: Set the memory resource used for all of TriLib's memory
+
+        All memory pool blocks and temporary arrays of the triangulation are allocated from the given 
+        resource, e.g. a std::pmr::monotonic_buffer_resource arena, which can be released at once after the 
+        Delaunay object was destroyed. The allocations are serialized, so the resource doesn't have to be 
+        thread-safe even if several threads are used.
+
+        @param resource: memory resource, nullptr (default) for malloc() and free()
+        @note: the resource must outlive the Delaunay object. Changing the resource discards the current
+               triangulation!
+       */
+      void setMemoryResource(std::pmr::memory_resource* resource);
+
+      /**
+        @brief: Set a hard limit for the memory allocated by TriLib
+
+        If a triangulation would need more memory than the limit, it's aborted with a std::bad_alloc 
+        exception. The same happens if the memory resource set with setMemoryResource() throws. The 
+        Delaunay object can be triangulated again after that.
+
+        @param maxBytes: max. number of bytes in use at once, 0 (default) for no limit
+       */
+      void setMemoryLimit(size_t maxBytes);
+
+      /**
+        @brief: Reserve memory for the expected size of the mesh
+
+        TriLib's memory pools normally start with room for the input points and their Delaunay triangulation, 
+        and grow block by block as Steiner points are added by quality refinement. With a reservation, the 
+        pools start with a single block big enough for the whole mesh, which saves allocations, improves the 
+        locality of traversals and makes the peak memory predictable.
+
+        @param vertices: expected number of vertices (including Steiner points), 0 to estimate it
+        @param triangles: expected number of triangles, 0 to estimate it
+        @param subsegments: expected number of subsegments (i.e. pieces of segments), 0 to estimate it
+        @note: The estimates are derived from the number of input points and segments, the min. angle and 
+               the max. area constraint. Stays in effect for all following triangulations. Reused pools 
+               (@see enableMemoryPoolReuse()) with a smaller first block are allocated anew.
+       */
+      void reserve(size_t vertices = 0, size_t triangles = 0, size_t subsegments = 0);
+
+      /**
+        @brief: Set the progress callback, the budgets and the cancellation token of the triangulations
+
+        A cancelled triangulation is aborted with a TriangulationAborted exception. If the time budget runs
+        out, the quality refinement stops adding Steiner points, as it does when the Steiner point budget is 
+        used up: the result is a valid (constrained or conforming) triangulation, but some of its triangles 
+        may not meet the quality constraints, @see refinementStopped(). If the time runs out before the 
+        refinement, the triangulation is aborted with a TriangulationAborted exception. The Delaunay object 
+        can be triangulated again after an abort.
+
+        @param control: the controls, a default-constructed RunControl for none
+        @note: stays in effect for all following triangulations (Triangulate(), TriangulateConf(), Tesselate())
+       */
+      void setRunControl(const RunControl& control) { m_runControl = control; }
+
+      /**
+        @brief: Was the last quality refinement stopped by the Steiner point or the time budget?
+
+        @return: true if some triangles may not meet the quality constraints
+       */
+      bool refinementStopped() const { return m_refinementStopped; }
+
+      /**
+        @brief: Set the precision of the geometric predicates
+
+        Robust: TriLib's adaptive predicates evaluate a floating-point filter first and use exact arithmetic 
+        only if the filter cannot decide, so the triangulation is always correct.
+        Unchecked: no exact arithmetic (as TriLib's -X switch). Faster, but degenerate or nearly degenerate 
+        input can produce invalid triangulations or crash, so use it only for trusted, e.g. jittered, input.
+
+        @note: the filters depend on the coordinate differences only, so the exact paths are mostly taken for
+               (nearly) degenerate configurations, e.g. cocircular grid points or vertices on segments, and
+               translating or scaling the input doesn't avoid them. Measure with predicateStats() before 
+               switching the mode.
+        @note: stays in effect for all following triangulations
+       */
+      void setPredicateMode(PredicateMode mode) { m_predicateMode = mode; }
+
+      /**
+        @brief: How many predicates of the last triangulation (and of its in-place updates) took the exact
+                paths? None do in the Unchecked mode.
+       */
+      PredicateStats predicateStats() const;
+
+      /**
+        @brief: Replace the input points
+
+        Discards the current triangulation, but keeps all the settings (and the memory pools, if reused, 
+        @see enableMemoryPoolReuse()), so the object can be used for the next, unrelated triangulation.
+
+        @param points: new input points
+        @note: The segment constraints refer to the indexes of the old points, so they are removed! Holes and 
+               regions are kept.
+       */
+      void setPoints(const std::vector<Point>& points);
+
+      /**
+        @brief: Add points to the input, updating an existing triangulation in place
+
+        The new points are appended to the input points, i.e. their vertex indices follow the indices of the 
+        already present points. They are inserted in a spatially sorted order into the live mesh, each point 
+        location starting from the triangle created by the previous insertion.
+
+        @param points: points to be added
+        @note: In-place updates are supported for Delaunay triangulations of points without segments, holes, 
+               quality constraints or Voronoi diagrams, and only for points inside the current convex hull. 
+               In all other cases the last triangulation is simply repeated with the changed input.
+       */
+      void insertPoints(const std::vector<Point>& points);
+
+      /**
+        @brief: Remove points from the input, updating an existing triangulation in place
+
+        The removed points are erased from the input points, so the vertex indices of the points which 
+        follow them are decremented, just like with std::vector::erase(). The vertices are deleted from the 
+        live mesh, and the resulting holes are retriangulated.
+
+        @param pointIndexes: indexes of the input points to be removed
+        @return: false if an index is invalid or used as a segment endpoint, nothing is removed then
+        @note: same restrictions as with insertPoints(), additionally only vertices not lying on the convex 
+               hull can be removed in place
+       */
+      bool removePoints(const std::vector<int>& pointIndexes);
+
       //---------------------------------
       //  constraints API 
       //---------------------------------
@@ -228,10 +640,67 @@ namespace tpp
      bool setRegionsConstraint(const std::vector<Point4>& regionConstr); // OPEN TODO::: remove???
 
      /**
-        @brief:  Set a user test function for the triangulation
-                 OPEN TODO::: NYI!!!
+        @brief: Set a user test for quality triangulations, e.g. a sizing function
+
+        Each triangle tested by the quality refinement is also passed to the user test, and refined if the
+        test returns true, as if it violated the min. angle or max. area constraint. The functor is inlined 
+        into a function generated for its type, which TriLib's testtriangle() calls directly, so there's 
+        a single indirect call per tested triangle and no std::function overhead.
+
+        @param test: functor with the signature bool(const Point& org, const Point& dest, const Point& apex, 
+                     double area), returning true if the triangle must be refined
+        @note: used by quality triangulations only. The test is called by one thread at a time, even if 
+               several threads are set. It must accept all small enough triangles, or the refinement won't 
+               terminate!
+      */
+     template <class UserTestFunctor>
+     void setUserConstraint(UserTestFunctor test)
+     {
+        static_assert(sizeof(Point) == 2 * sizeof(double), "Points must be usable as flat arrays!");
+
+        m_userTestContext = std::make_shared<UserTestFunctor>(std::move(test));
+        m_userTestFunc = [](void* context, double* org, double* dest, double* apex, double area) -> int
+           {
+              const UserTestFunctor& userTest = *static_cast<const UserTestFunctor*>(context);
+              return userTest(*reinterpret_cast<const Point*>(org), *reinterpret_cast<const Point*>(dest),
+                              *reinterpret_cast<const Point*>(apex), area) ? 1 : 0;
+           };
+     }
+
+     /**
+        @brief: Set a user test as a std::function, e.g. if it's passed across a DLL boundary
+
+        @param test: the user test, an empty std::function removes it
       */
-     void setUserConstraint(bool (*f)()) { /* NYI !!!!! */ }
+     void setUserConstraint(const UserTest& test);
+
+     /**
+        @brief: Remove the user test
+      */
+     void setUserConstraint(std::nullptr_t);
+
+     /**
+        @brief: Set a background sizing field for quality triangulations
+
+        The quality refinement also splits each triangle which is bigger than an equilateral triangle with 
+        the target edge length at the triangle's centroid. So a single quality triangulation grades the mesh 
+        towards the features, instead of repeated refinements with per-triangle area constraints. The field 
+        is evaluated once for each tested triangle, i.e. in general once for each created triangle.
+
+        @param grid: target edge lengths on a regular grid
+        @return: false if the grid is invalid (the field is unchanged then)
+        @note: the min. edge length must be positive, or the refinement won't terminate!
+      */
+     bool setSizingField(const SizingGrid& grid);
+
+     /**
+        @brief: Set a background sizing field as a function
+
+        @param sizing: returns the target edge length at (x, y), a nonpositive value for none. An empty 
+                       std::function removes the sizing field.
+        @note: it's called by one thread at a time, even if several threads are set
+      */
+     void setSizingField(const SizingFunction& sizing);
 
       /**
         @brief: Are the quality constraints acceptable?
@@ -280,6 +749,29 @@ namespace tpp
        */
       void getMinMaxPoints(double& minX, double& minY, double& maxX, double& maxY) const;
 
+      /**
+        @brief: Export the triangulation into flat arrays in one pass
+
+        Fills vertex coordinates, triangles, and optionally triangle neighbors and edges, using TriLib's own 
+        output routines. Much faster than collecting the same data with the face iterators.
+
+        @param buffers: the arrays to be filled, @see MeshBuffers
+        @return: false if there's no triangulation
+       */
+      bool exportMesh(MeshBuffers& buffers);
+
+      /**
+        @brief: Export the vertex-vertex, vertex-triangle and triangle-triangle adjacency in CSR format
+
+        Built with a few linear passes over TriLib's triangle pool, split by memory blocks and distributed 
+        over the threads set with setThreadCount(). Much faster than collecting the same data with 
+        TriangulationMesh::trianglesAroundVertex().
+
+        @param adjacency: the arrays to be filled, @see MeshAdjacency
+        @return: false if there's no triangulation
+       */
+      bool exportAdjacency(MeshAdjacency& adjacency);
+
       /**
         @brief: Iterate over resulting faces (i.e. triangles) and vertices
        */
@@ -369,6 +861,54 @@ namespace tpp
                         std::vector<Delaunay::Point>& holeMarkers, std::vector<Point4>& regionConstr, 
                         int* duplicatePointCount = nullptr, DebugOutputLevel traceLvl = None);
 
+      /**
+        @brief: Delaunay triangulate the vertices of a .node file without keeping the whole mesh in memory
+
+        The file is read three times: twice for the finalization tags, i.e. the bounding box and the number of
+        points in each cell of a grid covering it, and then to insert the points one by one. Each triangle is 
+        handed to the sink and freed as soon as no point still to be read can change it. 
+
+        @note: The memory stays small only for spatially coherent files, i.e. if the points of each region follow 
+               each other closely, as e.g. for points sorted by a coordinate or written tile by tile.
+        @note: The current triangulation is discarded, the input points are kept. Duplicate points are skipped.
+
+        @param filePath: directory and the name of file to be read
+        @param sink: called for each triangle of the triangulation
+        @param pointsPerCell: average number of points per cell of the finalization grid, 0 for the default (1024)
+        @return: true if file read, false otherwise
+       */
+      bool triangulateStream(const std::string& filePath, const TriangleSink& sink, unsigned pointsPerCell = 0);
+
+      /**
+        @brief: Write the points, constraints and (if triangulated) the mesh to a binary file
+
+        The format is versioned and little-endian: a 16 byte header ("TPPB", version, section count, reserved),
+        a table of 32 byte section entries (type, value size, values per entry, reserved, entry count, offset),
+        and the 8-byte aligned section arrays, so that a memory-mapped file can be used in place. Sections:
+        1: nodes (2 doubles), 2: segments (2 int32), 3: holes (2 doubles), 4: regions (x, y, attribute, 
+        max area as doubles), 5: elements (3 int32), 6: neighbors (3 int32, -1 on the boundary). 
+        Empty sections are omitted.
+
+        @note: Nodes of a triangulation are its vertices, i.e. the input points followed by the Steiner points.
+
+        @param filePath: directory and the name of file to be written
+        @return: true if file written, false otherwise
+       */
+      bool saveBinary(const std::string& filePath);
+
+      /**
+        @brief: Read points and constraints from a binary file written by saveBinary()
+
+        The file is memory-mapped (where supported) and its arrays are copied in bulk, without any parsing. 
+        Replaces the current points, segments, holes and regions, the current triangulation is discarded. 
+        Nothing is changed if the file is not valid.
+
+        @param filePath: directory and the name of file to be read
+        @param mesh: (optional) receives the stored nodes, elements and neighbors, @see MeshBuffers
+        @return: true if file read, false otherwise
+       */
+      bool readBinary(const std::string& filePath, MeshBuffers* mesh = nullptr);
+
       /**
          @brief: debug helper, works only if TRIANGLE_DBG_TO_FILE is set!
        */
@@ -403,6 +943,17 @@ namespace tpp
 
    private:
       void invokeTriLib(std::string& triswitches);
+      void retriangulate();
+      bool canUpdateInPlace() const;
+      void updateMeshCounts();
+      void numberTriangles();
+      void numberMeshVertices();
+      void mapVertices();
+      void clearVertexMap();
+      void createVoronoiOutput();
+      void freeVoronoiOutput();
+      void setMemoryOptions();
+      void setReservedMeshSize();
       void setQualityOptions(std::string& options, bool quality);
       void setDebugLevelOption(std::string& options, DebugOutputLevel traceLvl);
       void sanitizeInputData(std::unordered_map<int, int> duplicatePointsMap, DebugOutputLevel traceLvl = None);
@@ -413,8 +964,9 @@ namespace tpp
       void readSegmentsFromMesh(std::vector<int>& segmentEndpoints) const;      
       void static SetPoint(Point& point, /*Triwrap::vertex*/ double* vertexptr);
 
-      bool readSegmentsFromFile(char* polyfileName, FILE* polyfile, std::vector<int>& segmentEndpoints);
-      void readHolesFromFile(char* polyfileName, FILE* polyfile, std::vector<Point>& holeMarkers, std::vector<Point4>& regionConstr) const;
+      void readNodesFromFile(TextFileParser& infile);
+      bool readSegmentsFromFile(TextFileParser& polyfile, std::vector<int>& segmentEndpoints);
+      void readHolesFromFile(TextFileParser& polyfile, std::vector<Point>& holeMarkers, std::vector<Point4>& regionConstr) const;
       std::unordered_map<int, int> checkForDuplicatePoints() const;   
       int GetFirstIndexNumber() const;
 
@@ -423,6 +975,8 @@ namespace tpp
       friend class VoronoiVertexIterator;
       friend class VoronoiEdgeIterator;
       friend class TriangulationMesh;
+      friend struct FacesList;
+      friend struct VertexList;
       
    private:
       Triwrap* m_triangleWrap;  // inner helper class grouping the original TriLib's C functions.
@@ -433,19 +987,75 @@ namespace tpp
       void* m_vorout;  // pointer to TriLib's Voronoi output
 
       AlgorithmType m_triAlgorithm;
+      unsigned m_threadCount;
+      unsigned m_tileSize;
       float m_minAngle;
       float m_maxArea;
       bool m_convexHullWithSegments;   
-      bool m_extraVertexAttr;
+      bool m_meshIndexing;
+      bool m_triangleIds;
       bool m_triangulated;
-
+      bool m_reusePools;
+      std::pmr::memory_resource* m_memResource;
+      size_t m_memLimit;
+      bool m_reserveMesh;
+      size_t m_reservedVertices;
+      size_t m_reservedTriangles;
+      size_t m_reservedSubsegs;
+      PredicateMode m_predicateMode;
+      RunControl m_runControl;
+      bool m_refinementStopped;
+      int (*m_userTestFunc)(void* context, double* org, double* dest, double* apex, double area);
+      std::shared_ptr<void> m_userTestContext;
+      SizingGrid m_sizingGrid;
+      SizingFunction m_sizingFunction;
+      std::string m_triSwitches;  // options of the last triangulation
+
+      std::vector<void*> m_triangleTable;  // TriLib's triangles by their ids
+      std::vector<int> m_meshVertexIndex;  // mesh indexes by vertex number
+      std::vector<void*> m_vertexTable;    // TriLib's vertices by their numbers, made on demand
+      std::vector<void*> m_vertexTriangles; // the first triangle of each vertex, dito
+      std::atomic<bool> m_vertexMapReady;  // are the two tables above made?
+      std::mutex m_vertexMapMutex;         // guards making them by concurrent queries
       std::vector<Point> m_pointList;
       std::vector<int> m_segmentList;
       std::vector<Point> m_holesList;
-      std::vector<double> m_defaultExtraAttrs;
       std::vector<Point4> m_regionsConstrList;
    }; 
 
+
+   /**
+      @brief: One triangulation of a batch, @see triangulateBatch()
+    */
+   struct TriangulationJob
+   {
+      // input:
+      std::vector<Delaunay::Point> points;
+      std::vector<int> segments;                // endpoint indexes, as in Delaunay::setSegmentConstraint()
+      std::vector<Delaunay::Point> holes;
+      bool convexHullWithSegments = false;
+      bool quality = false;
+      float minAngle = 0.0f;                    // if quality is set, 0 for TriLib's default 
+      float maxArea = 0.0f;                     // if quality is set, 0 for no area constraint
+
+      // output:
+      MeshBuffers mesh;                         // the flags and buffer pointers of MeshBuffers can be preset
+      bool succeeded = false;
+      std::string error;                        // error message, if not succeeded
+   };
+
+   /**
+      @brief: Run many independent triangulations in parallel
+
+      The jobs are distributed over a thread pool, each thread triangulating its jobs one after the other with 
+      its own Delaunay object, which reuses its memory pools from job to job. The results are exported into 
+      the jobs' MeshBuffers. A job throwing an exception (e.g. for a bad input) only fails that job.
+
+      @param jobs: the triangulations to be done
+      @param threadCount: number of threads, 0 (default) for the number of hardware threads
+    */
+   void TRPP_LIB_EXPORT triangulateBatch(std::vector<TriangulationJob>& jobs, unsigned threadCount = 0);
+
 }
 
 #endif
@@ -43,10 +43,23 @@
 
 // 2. the wrapper itself (TrianglePP)
 #include "tpp_interface.hpp"
+#include "tpp_text_parser.hpp"
 
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
 
 // helper macros
 #include "tpp_triangle_macros.hpp"
@@ -70,9 +83,32 @@ namespace std
 
 namespace tpp {
 
-   // trace support
-   FILE* g_debugFile = nullptr;  // OPEN TODO:: decouple, move to separate file!
-   std::string g_debugFileName;  // dito
+   // trace support, per thread
+   thread_local FILE* g_debugFile = nullptr;  // OPEN TODO:: decouple, move to separate file!
+   thread_local std::string g_debugFileName;  // dito
+
+#ifdef TRIANGLE_DBG_TO_FILE
+   std::string traceFileName(const char* name)
+   {
+      // threads are numbered in the order of their first trace, thread 0 uses the plain name
+      static std::atomic<int> tracingThreads(0);
+      thread_local int threadNr = tracingThreads++;
+
+      std::string fileName(name);
+
+      if (threadNr > 0)
+      {
+         size_t extPos = fileName.rfind('.');
+         if (extPos == std::string::npos)
+         {
+            extPos = fileName.size();
+         }
+         fileName.insert(extPos, "." + std::to_string(threadNr));
+      }
+
+      return fileName;
+   }
+#endif
 
    // impl. constant
    const char* c_trppFileComment =  "\n# Generated by Triangle++" ;
@@ -87,11 +123,25 @@ Delaunay::Delaunay(const std::vector<Point>& points, bool enableMeshIndexing)
      m_pbehavior(nullptr),
      m_vorout(nullptr),
      m_triAlgorithm(DivideConquer),
+     m_threadCount(1),
+     m_tileSize(0),
      m_minAngle(0.0f),
      m_maxArea(0.0f),
      m_convexHullWithSegments(false),
-     m_extraVertexAttr(enableMeshIndexing),
-     m_triangulated(false)
+     m_meshIndexing(enableMeshIndexing),
+     m_triangleIds(false),
+     m_triangulated(false),
+     m_reusePools(false),
+     m_memResource(nullptr),
+     m_memLimit(0),
+     m_reserveMesh(false),
+     m_reservedVertices(0),
+     m_reservedTriangles(0),
+     m_reservedSubsegs(0),
+     m_predicateMode(Robust),
+     m_refinementStopped(false),
+     m_userTestFunc(nullptr),
+     m_vertexMapReady(false)
 {
    m_pointList.assign(points.begin(), points.end());
 }
@@ -145,7 +195,293 @@ void Delaunay::Tesselate(bool useConformingDelaunay, DebugOutputLevel traceLvl)
    options.append("v"); // Voronoi
 
    invokeTriLib(options);
+   createVoronoiOutput();
+}
+
+
+void Delaunay::setPoints(const std::vector<Point>& points)
+{
+   m_pointList.assign(points.begin(), points.end());
+   m_segmentList.clear();
+
+   // the memory pools are freed or reused by the next triangulation
+   freeVoronoiOutput();
+   m_triangulated = false;
+}
+
+
+void Delaunay::insertPoints(const std::vector<Point>& points)
+{
+   if (points.empty())
+   {
+      return;
+   }
+
+   size_t firstNewPoint = m_pointList.size();
+   m_pointList.insert(m_pointList.end(), points.begin(), points.end());
+
+   if (!m_triangulated)
+   {
+      return;
+   }
+
+   if (!canUpdateInPlace())
+   {
+      retriangulate();
+      return;
+   }
+
+   TP_MESH_BEHAVIOR_WRAP();
+   Triwrap::__pmesh* m = tpmesh;          // needed for Triwrap's macros
+   typedef Triwrap::triangle triangle;    // dito
+   triangle ptr;                          // dito
+
+   // create the vertices
+   std::vector<Triwrap::vertex> newVertices;
+   newVertices.reserve(points.size());
+
+   for (size_t i = firstNewPoint; i < m_pointList.size(); ++i)
+   {
+      Triwrap::vertex newvertex = (Triwrap::vertex)pTriangleWrap->poolalloc(&tpmesh->vertices);
+
+      newvertex[0] = m_pointList[i][0];
+      newvertex[1] = m_pointList[i][1];
+
+      for (int j = 0; j < tpmesh->nextras; ++j)
+      {
+         newvertex[2 + j] = -1.0; // no attributes given
+      }
+
+      setvertexmark(newvertex, (int)i + tpbehavior->firstnumber);
+      setvertextype(newvertex, INPUTVERTEX);
+      newVertices.push_back(newvertex);
+
+      tpmesh->xmin = std::min(tpmesh->xmin, newvertex[0]);
+      tpmesh->ymin = std::min(tpmesh->ymin, newvertex[1]);
+      tpmesh->xmax = std::max(tpmesh->xmax, newvertex[0]);
+      tpmesh->ymax = std::max(tpmesh->ymax, newvertex[1]);
+   }
+
+   tpmesh->invertices += (int)newVertices.size();
+
+   // consecutive points will be close to each other
+   pTriangleWrap->briosort(tpmesh, newVertices.data(), (int)newVertices.size());
+
+   for (auto newvertex : newVertices)
+   {
+      Triwrap::__otriangle starttri;
+      Triwrap::__otriangle searchtri;
+      Triwrap::locateresult intersect;
+
+      pTriangleWrap->recentstart(tpmesh, tpbehavior, newvertex, &starttri);
+      otricopy(starttri, searchtri);
+
+      // insertvertex() cannot extend the convex hull, check first
+      if (searchtri.tri == tpmesh->dummytri)
+      {
+         searchtri.orient = 0;
+         symself(searchtri);
+         intersect = pTriangleWrap->locate(tpmesh, tpbehavior, newvertex, &searchtri);
+      }
+      else
+      {
+         intersect = pTriangleWrap->preciselocate(tpmesh, tpbehavior, newvertex, &searchtri, 0);
+      }
+
+      if (intersect == Triwrap::OUTSIDE)
+      {
+         TRACE("insertPoints() - point outside of the convex hull, repeating triangulation");
+         retriangulate();
+         return;
+      }
+
+      // the found triangle is a valid start only if the point lies strictly inside of it
+      if (intersect == Triwrap::INTRIANGLE)
+      {
+         otricopy(searchtri, starttri);
+      }
+
+      if (pTriangleWrap->insertvertex(tpmesh, tpbehavior, newvertex, &starttri, nullptr, 0, 0) 
+            == Triwrap::DUPLICATEVERTEX)
+      {
+         setvertextype(newvertex, UNDEADVERTEX);
+         tpmesh->undeads++;
+      }
+   }
+
+   updateMeshCounts();
+   numberTriangles();
+   numberMeshVertices();
+   clearVertexMap();
+}
+
+
+bool Delaunay::removePoints(const std::vector<int>& pointIndexes)
+{
+   std::vector<int> removed(pointIndexes);
+
+   std::sort(removed.begin(), removed.end());
+   removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+
+   if (removed.empty())
+   {
+      return true;
+   }
+
+   if (removed.front() < 0 || unsigned(removed.back()) >= m_pointList.size())
+   {
+      return false;
+   }
+
+   for (auto pointIdx : m_segmentList)
+   {
+      if (std::binary_search(removed.begin(), removed.end(), pointIdx))
+      {
+         return false;
+      }
+   }
+
+   // number of removed points before a given index
+   auto removedBefore = [&removed](int pointIdx)
+   {
+      return (int)(std::lower_bound(removed.begin(), removed.end(), pointIdx) - removed.begin());
+   };
+
+   bool inPlace = m_triangulated && canUpdateInPlace();
+
+   if (inPlace)
+   {
+      TP_MESH_BEHAVIOR_WRAP();
+      Triwrap::__pmesh* m = tpmesh;          // needed for Triwrap's macros
+      typedef Triwrap::triangle triangle;    // dito
+      triangle ptr;                          // dito
+
+      // duplicate input points would have to be re-inserted
+      inPlace = (tpmesh->undeads == 0);
+
+      std::vector<Triwrap::vertex> removedPoints;
+      removedPoints.reserve(removed.size());
+
+      for (auto pointIdx : removed)
+      {
+         removedPoints.push_back(&m_pointList[pointIdx][0]);
+      }
+
+      // consecutive points will be close to each other
+      pTriangleWrap->briosort(tpmesh, removedPoints.data(), (int)removedPoints.size());
+
+      for (size_t i = 0; inPlace && i < removedPoints.size(); ++i)
+      {
+         Triwrap::vertex point = removedPoints[i];
+         Triwrap::__otriangle searchtri;
+         Triwrap::locateresult intersect;
+
+         pTriangleWrap->recentstart(tpmesh, tpbehavior, point, &searchtri);
+
+         if (searchtri.tri == tpmesh->dummytri)
+         {
+            searchtri.orient = 0;
+            symself(searchtri);
+            intersect = pTriangleWrap->locate(tpmesh, tpbehavior, point, &searchtri);
+         }
+         else
+         {
+            intersect = pTriangleWrap->preciselocate(tpmesh, tpbehavior, point, &searchtri, 0);
+         }
+
+         if (intersect != Triwrap::ONVERTEX)
+         {
+            inPlace = false;
+            break;
+         }
+
+#if defined( _DEBUG )
+         typedef Triwrap::vertex vertex;     // needed for org()
+         Triwrap::vertex delvertex;
+         org(searchtri, delvertex);
+         Assert(delvertex[0] == point[0] && delvertex[1] == point[1], "wrong vertex located");
+#endif
+
+         // vertices on the convex hull cannot be deleted
+         Triwrap::__otriangle aroundtri;
+         otricopy(searchtri, aroundtri);
+
+         do
+         {
+            onextself(aroundtri);
+         } 
+         while (aroundtri.tri != tpmesh->dummytri && !otriequal(aroundtri, searchtri));
+
+         if (aroundtri.tri == tpmesh->dummytri)
+         {
+            inPlace = false;
+            break;
+         }
+
+         pTriangleWrap->deletevertex(tpmesh, tpbehavior, &searchtri);
+         otricopy(searchtri, tpmesh->recenttri);
+      }
+
+      if (inPlace)
+      {
+         // renumber the remaining vertices
+         pTriangleWrap->traversalinit(&tpmesh->vertices);
+         Triwrap::vertex vertexloop = pTriangleWrap->vertextraverse(tpmesh);
+
+         while (vertexloop != nullptr)
+         {
+            int pointIdx = vertexmark(vertexloop) - tpbehavior->firstnumber;
+            setvertexmark(vertexloop, vertexmark(vertexloop) - removedBefore(pointIdx));
+
+            vertexloop = pTriangleWrap->vertextraverse(tpmesh);
+         }
+
+         tpmesh->invertices -= (int)removed.size();
+      }
+   }
+
+   // erase the points in a single pass, correct the segments
+   size_t keptCount = 0;
+
+   for (size_t i = 0, r = 0; i < m_pointList.size(); ++i)
+   {
+      if (r < removed.size() && unsigned(removed[r]) == i)
+      {
+         ++r;
+         continue;
+      }
+      if (keptCount != i)
+      {
+         m_pointList[keptCount] = m_pointList[i]; // dpoint asserts on self-assignment
+      }
+      ++keptCount;
+   }
+
+   m_pointList.resize(keptCount);
+
+   for (auto& pointIdx : m_segmentList)
+   {
+      pointIdx -= removedBefore(pointIdx);
+   }
+
+   if (inPlace)
+   {
+      updateMeshCounts();
+      numberTriangles();
+      numberMeshVertices();
+      clearVertexMap();
+   }
+   else if (m_triangulated)
+   {
+      retriangulate();
+   }
+
+   return true;
+}
+
 
+void Delaunay::createVoronoiOutput()
+{
    // now use the triangulation for a Voronoi diagram
    TP_MESH_BEHAVIOR_WRAP();
 
@@ -181,6 +517,30 @@ void Delaunay::Tesselate(bool useConformingDelaunay, DebugOutputLevel traceLvl)
 }
 
 
+void Delaunay::freeVoronoiOutput()
+{
+   TP_VOROUT();
+
+   if (!tpvorout)
+   {
+      return;
+   }
+
+   // allocated by TriLib, also with a custom memory resource!
+   Triwrap* pTriangleWrap = static_cast<Triwrap*>(m_triangleWrap);
+   
+   pTriangleWrap->trifree((VOID*)tpvorout->pointlist);
+   pTriangleWrap->trifree((VOID*)tpvorout->pointattributelist);
+   pTriangleWrap->trifree((VOID*)tpvorout->pointmarkerlist);
+   pTriangleWrap->trifree((VOID*)tpvorout->edgelist);
+   pTriangleWrap->trifree((VOID*)tpvorout->edgemarkerlist);
+   pTriangleWrap->trifree((VOID*)tpvorout->normlist);
+
+   delete tpvorout;
+   m_vorout = nullptr;
+}
+
+
 bool Delaunay::checkConstraints(bool& possible) const
 {
    //"     If the minimum angle is 28.6"
@@ -298,7 +658,7 @@ bool Delaunay::setSegmentConstraint(const std::vector<int>& segmentPointIndexes,
 
 void Delaunay::enableMeshIndexGeneration() 
 {
-   m_extraVertexAttr = true;
+   m_meshIndexing = true;
 }
 
 
@@ -308,6 +668,41 @@ void Delaunay::setAlgorithm(AlgorithmType alg)
 }
 
 
+void Delaunay::setMemoryResource(std::pmr::memory_resource* resource)
+{
+   if (resource == m_memResource)
+   {
+      return;
+   }
+
+   // memory must be given back to the resource it came from
+   freeTriangleDataStructs();
+   m_triangulated = false;
+
+   m_memResource = resource;
+}
+
+
+void Delaunay::setMemoryLimit(size_t maxBytes)
+{
+   m_memLimit = maxBytes;
+
+   if (m_triangleWrap)
+   {
+      setMemoryOptions();
+   }
+}
+
+
+void Delaunay::reserve(size_t vertices, size_t triangles, size_t subsegments)
+{
+   m_reserveMesh = true;
+   m_reservedVertices = vertices;
+   m_reservedTriangles = triangles;
+   m_reservedSubsegs = subsegments;
+}
+
+
 void Delaunay::useConvexHullWithSegments(bool useConvexHull)
 {
 #if 0
@@ -365,6 +760,47 @@ bool Delaunay::setRegionsConstraint(const std::vector<Point4>& regionConstr)
 }
 
 
+void Delaunay::setUserConstraint(const UserTest& test)
+{
+   if (!test)
+   {
+      setUserConstraint(nullptr);
+      return;
+   }
+
+   setUserConstraint<UserTest>(test);
+}
+
+
+void Delaunay::setUserConstraint(std::nullptr_t)
+{
+   m_userTestFunc = nullptr;
+   m_userTestContext.reset();
+}
+
+
+bool Delaunay::setSizingField(const SizingGrid& grid)
+{
+   if (grid.nx < 1 || grid.ny < 1 || !(grid.dx > 0) || !(grid.dy > 0) || 
+       grid.edgeLengths.size() != (size_t)grid.nx * (size_t)grid.ny)
+   {
+      return false;
+   }
+
+   m_sizingGrid = grid;
+   m_sizingFunction = nullptr;
+
+   return true;
+}
+
+
+void Delaunay::setSizingField(const SizingFunction& sizing)
+{
+   m_sizingGrid = SizingGrid();
+   m_sizingFunction = sizing;
+}
+
+
 void Delaunay::writeoff(std::string& fname)
 {
     if(!m_triangulated)
@@ -475,6 +911,25 @@ bool Delaunay::saveSegments(const std::string& filePath)
 }
 
 
+namespace {
+
+   // as TriLib's readnodes() opens its files
+   void openTextFile(Triwrap* triangleWrap, int quiet, TextFileParser& file, const std::string& filePath)
+   {
+      if (!quiet)
+      {
+         printf("Opening %s.\n", filePath.c_str());
+      }
+
+      if (!file.read(filePath))
+      {
+         printf("  Error:  Cannot access file %s.\n", filePath.c_str());
+         triangleWrap->triexit(1);
+      }
+   }
+}
+
+
 bool Delaunay::readPoints(const std::string& filePath, std::vector<Delaunay::Point>& points)
 {  
     if (!m_triangleWrap)
@@ -483,14 +938,16 @@ bool Delaunay::readPoints(const std::string& filePath, std::vector<Delaunay::Poi
        initTriangleDataForPoints();
     }
 
-    TP_MESH_BEHAVIOR_WRAP();
+    Triwrap::__pbehavior* tpbehavior = TP_BEHAVIOR_PTR();
+    Triwrap* pTriangleWrap = static_cast<Triwrap*>(m_triangleWrap);
 
     tpbehavior->poly = 0; // poly file not provided!
     tpbehavior->usesegments = 0;
-    FILE* polyfile = nullptr;
-    char* polyfileName = nullptr; // no poly file!
 
-    pTriangleWrap->readnodes(tpmesh, tpbehavior, const_cast<char*>(filePath.c_str()), polyfileName, &polyfile);
+    TextFileParser nodefile(m_threadCount);
+    openTextFile(pTriangleWrap, tpbehavior->quiet, nodefile, filePath);
+
+    readNodesFromFile(nodefile);
 
     // read points from the mesh data
     readPointsFromMesh(m_pointList);
@@ -522,96 +979,533 @@ bool Delaunay::readSegments(
 
     tpmesh->steinerleft = tpbehavior->steiner;
 
-    FILE* polyfile = nullptr;
-    char* polyfileName = const_cast<char*>(filePath.c_str());
-    pTriangleWrap->readnodes(tpmesh, tpbehavior, nullptr, polyfileName, &polyfile);
+    TextFileParser polyfile(m_threadCount);
+    openTextFile(pTriangleWrap, tpbehavior->quiet, polyfile, filePath);
+
+    readNodesFromFile(polyfile);
 
     // get points from the mesh data
     readPointsFromMesh(m_pointList);
     points = m_pointList; // OPEN TODO::: make it optional param????
 
-    auto duplicates = checkForDuplicatePoints();
-    if (!duplicates.empty())
+    // read file directly
+    //  - Trilib's code doesn't support duplicate points!
+    if (!readSegmentsFromFile(polyfile, m_segmentList))
     {
-        // read file directly
-        //  - Trilib's code doesn't support duplicate points!
-        if (!readSegmentsFromFile(polyfileName, polyfile, m_segmentList))
-        {
-            fclose(polyfile);
-            return false;
-        }
+        return false;
+    }
 
-        // rebase to start with 0
-        if (tpbehavior->firstnumber != 0)
+    // rebase to start with 0
+    if (tpbehavior->firstnumber != 0)
+    {
+        for (auto& index : m_segmentList)
         {
-            for (auto& index : m_segmentList)
-            {
-                index -= tpbehavior->firstnumber;
-                Assert(index >= 0, "");
-            }
+            index -= tpbehavior->firstnumber;
+            Assert(index >= 0, "");
         }
+    }
 
+    auto duplicates = checkForDuplicatePoints();
+    if (!duplicates.empty())
+    {
         sanitizeInputData(duplicates, traceLvl);
-
         points = m_pointList; // OPEN TODO::: make it optional param????
-        segmentEndpoints = m_segmentList; // OPEN TODO::: make it optional param????
     }
-    else
+
+    segmentEndpoints = m_segmentList; // OPEN TODO::: make it optional param????
+
+    if (duplicatePointCount)
     {
-#if 0 // OPEN TODO::: not working (on Windows!), mysterious file reading problems!!! :-O
-        // triangulate to ensure formskeleton() will read segments!
-        tpmesh->hullsize = pTriangleWrap->delaunay(tpmesh, tpbehavior);
+       *duplicatePointCount = duplicates.size();
+    }
 
-        // Ensure that no vertex can be mistaken for a triangular bounding box
-        // vertex in insertvertex()!
-        tpmesh->infvertex1 = nullptr;
-        tpmesh->infvertex2 = nullptr;
-        tpmesh->infvertex3 = nullptr;
+    // get hole marker points
+    readHolesFromFile(polyfile, m_holesList, m_regionsConstrList);
 
-        tpmesh->checksegments = 1;
+    holeMarkers = m_holesList;      // OPEN TODO::: make it optional param????
+    regionConstr = m_regionsConstrList;   // OPEN TODO::: make it optional param????
 
-        // no holes yet:
-        tpmesh->holes = 0;
-        tpmesh->regions = 0;
+    // ready
+    return true;
+}
 
-        pTriangleWrap->formskeleton4file(tpmesh, tpbehavior, polyfile, polyfileName);
 
-        // get segments from the mesh data
-        readSegmentsFromMesh(m_segmentList);
-#else
-        if (!readSegmentsFromFile(polyfileName, polyfile, m_segmentList))
-        {
-           fclose(polyfile);
-           return false;
-        }
-#endif
+bool Delaunay::triangulateStream(const std::string& filePath, const TriangleSink& sink, unsigned pointsPerCell)
+{
+    freeTriangleDataStructs();
+    m_triangulated = false;
 
-        // rebase to start with 0
-        if (tpbehavior->firstnumber != 0)
-        {
-            for (auto& index : m_segmentList)
+    initTriangleDataForPoints();
+    TP_MESH_BEHAVIOR_WRAP();
+
+    tpbehavior->poly = 0;
+    tpbehavior->usesegments = 0;
+    tpbehavior->incremental = 1;
+
+    StreamedTriangle triangle;
+
+    auto emit = [&](double* org, double* dest, double* apex)
+    {
+       double* corners[3] = { org, dest, apex };
+
+       for (int i = 0; i < 3; ++i)
+       {
+          triangle.vertexIds[i] = ((int*)corners[i])[tpmesh->vertexmarkindex];
+          triangle.points[i][0] = corners[i][0];
+          triangle.points[i][1] = corners[i][1];
+       }
+       sink(triangle);
+    };
+
+    unsigned cellPoints = std::min(pointsPerCell, (unsigned)std::numeric_limits<int>::max());
+
+    long count = pTriangleWrap->streamdelaunay(tpmesh, tpbehavior, const_cast<char*>(filePath.c_str()),
+                                               (int)cellPoints, emit);
+
+    // the pools are empty, don't keep them
+    freeTriangleDataStructs();
+
+    return count >= 0;
+}
+
+
+// binary mesh files
+
+namespace {
+
+   const char c_binaryMagic[4] = { 'T', 'P', 'P', 'B' };
+   const uint32_t c_binaryVersion = 1;
+
+   enum BinarySectionType : uint32_t
+   {
+      NodesSection = 1,   // x, y
+      SegmentsSection,    // 2 vertex indexes
+      HolesSection,       // x, y
+      RegionsSection,     // x, y, region attribute, max area
+      ElementsSection,    // 3 vertex indexes
+      NeighborsSection,   // 3 triangle indexes, -1 on the boundary
+      SectionTypeCount
+   };
+
+   // all fields little-endian
+   struct BinaryHeader
+   {
+      char magic[4];
+      uint32_t version;
+      uint32_t sectionCount;
+      uint32_t reserved;
+   };
+
+   struct BinarySection
+   {
+      uint32_t type;
+      uint32_t valueSize;  // bytes per value
+      uint32_t width;      // values per entry
+      uint32_t reserved;
+      uint64_t count;      // entries
+      uint64_t offset;     // from the start of the file, 8-byte aligned
+   };
+
+   static_assert(sizeof(BinaryHeader) == 16 && sizeof(BinarySection) == 32, "Binary file layout changed!");
+   static_assert(sizeof(Delaunay::Point) == 2 * sizeof(double), "Points must be usable as flat arrays!");
+   static_assert(sizeof(Delaunay::Point4) == 4 * sizeof(double), "Points must be usable as flat arrays!");
+
+   // expected value size and width, by section type
+   const uint32_t c_sectionLayout[SectionTypeCount][2] = 
+   {
+      { 0, 0 }, { 8, 2 }, { 4, 2 }, { 8, 2 }, { 8, 4 }, { 4, 3 }, { 4, 3 }
+   };
+
+   bool littleEndianHost()
+   {
+      const uint16_t probe = 1;
+      return *(const uint8_t*)&probe == 1;
+   }
+
+   void swapBytes(void* data, size_t valueSize, size_t valueCount)
+   {
+      uint8_t* value = (uint8_t*)data;
+
+      for (size_t i = 0; i < valueCount; ++i, value += valueSize)
+      {
+         std::reverse(value, value + valueSize);
+      }
+   }
+
+   void swapHeader(BinaryHeader& header)
+   {
+      swapBytes(&header.version, sizeof(uint32_t), 3);
+   }
+
+   void swapSection(BinarySection& section)
+   {
+      swapBytes(&section.type, sizeof(uint32_t), 4);
+      swapBytes(&section.count, sizeof(uint64_t), 2);
+   }
+
+   uint64_t sectionBytes(const BinarySection& section)
+   {
+      return section.count * section.valueSize * section.width;
+   }
+
+   // a read-only view of a whole file, mapped into memory if possible
+   class MappedFile
+   {
+   public:
+      explicit MappedFile(const std::string& filePath)
+         : m_data(nullptr), m_size(0)
+      {
+#ifndef _WIN32
+         int fd = open(filePath.c_str(), O_RDONLY);
+         if (fd < 0)
+         {
+            return;
+         }
+
+         struct stat info;
+         if (fstat(fd, &info) == 0 && info.st_size > 0)
+         {
+            void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
             {
-                index -= tpbehavior->firstnumber;
+               m_data = (const char*)mapped;
+               m_size = (size_t)info.st_size;
             }
-        }
+         }
+         close(fd);
+#else
+         FILE* file = fopen(filePath.c_str(), "rb");
+         if (!file)
+         {
+            return;
+         }
 
-        segmentEndpoints = m_segmentList; // OPEN TODO::: make it optional param????
-    }
+         char block[65536];
+         size_t read = 0;
 
-    if (duplicatePointCount)
-    {
-       *duplicatePointCount = duplicates.size();
-    }
+         while ((read = fread(block, 1, sizeof(block), file)) > 0)
+         {
+            m_buffer.insert(m_buffer.end(), block, block + read);
+         }
+         fclose(file);
 
-    // get hole marker points
-    readHolesFromFile(polyfileName, polyfile, m_holesList, m_regionsConstrList);
+         m_data = m_buffer.data();
+         m_size = m_buffer.size();
+#endif
+      }
 
-    holeMarkers = m_holesList;      // OPEN TODO::: make it optional param????
-    regionConstr = m_regionsConstrList;   // OPEN TODO::: make it optional param????
+      ~MappedFile()
+      {
+#ifndef _WIN32
+         if (m_data)
+         {
+            munmap(const_cast<char*>(m_data), m_size);
+         }
+#endif
+      }
 
-    // ready
-    fclose(polyfile);
-    return true;
+      const char* data() const { return m_data; }
+      size_t size() const { return m_size; }
+
+   private:
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      const char* m_data;
+      size_t m_size;
+#ifdef _WIN32
+      std::vector<char> m_buffer;  // allocated aligned for any value type
+#endif
+   };
+
+   template <class T>
+   void copySection(const char* fileData, const BinarySection& section, T* target)
+   {
+      if (section.count == 0)
+      {
+         return;
+      }
+
+      memcpy(target, fileData + section.offset, (size_t)sectionBytes(section));
+
+      if (!littleEndianHost())
+      {
+         swapBytes(target, section.valueSize, (size_t)(section.count * section.width));
+      }
+   }
+
+   template <class NumType, unsigned D>
+   void copySection(const char* fileData, const BinarySection& section, reviver::dpoint<NumType, D>* target)
+   {
+      if (section.count == 0)
+      {
+         return;
+      }
+
+      // points are flat arrays of coordinates (see above), but not trivially copyable
+      copySection(fileData, section, &target[0][0]);
+   }
+
+   template <class T>
+   bool indexesInRange(const char* fileData, const BinarySection& section, int32_t minIndex, uint64_t endIndex)
+   {
+      size_t valueCount = (size_t)(section.count * section.width);
+      const char* value = fileData + section.offset;
+
+      for (size_t i = 0; i < valueCount; ++i, value += sizeof(T))
+      {
+         T index;
+         memcpy(&index, value, sizeof(T));
+
+         if (!littleEndianHost())
+         {
+            swapBytes(&index, sizeof(T), 1);
+         }
+         if (index < minIndex || (index >= 0 && (uint64_t)index >= endIndex))
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+}
+
+
+bool Delaunay::saveBinary(const std::string& filePath)
+{
+   struct SectionData
+   {
+      BinarySectionType type;
+      uint64_t count;
+      const void* data;
+   };
+
+   std::vector<SectionData> sections;
+   MeshBuffers mesh;
+
+   if (m_triangulated)
+   {
+      // the triangulation's vertices: input points first, then the Steiner points
+      exportMesh(mesh);
+
+      sections.push_back({ NodesSection, (uint64_t)mesh.vertexCount, mesh.points.data() });
+   }
+   else
+   {
+      sections.push_back({ NodesSection, m_pointList.size(), m_pointList.data() });
+   }
+
+   sections.push_back({ SegmentsSection, m_segmentList.size() / 2, m_segmentList.data() });
+   sections.push_back({ HolesSection, m_holesList.size(), m_holesList.data() });
+   sections.push_back({ RegionsSection, m_regionsConstrList.size(), m_regionsConstrList.data() });
+
+   if (m_triangulated)
+   {
+      sections.push_back({ ElementsSection, (uint64_t)mesh.triangleCount, mesh.triangles.data() });
+      sections.push_back({ NeighborsSection, (uint64_t)mesh.triangleCount, mesh.neighbors.data() });
+   }
+
+   sections.erase(std::remove_if(sections.begin(), sections.end(), [](const SectionData& s) { return s.count == 0; }),
+                  sections.end());
+
+   // layout: header, section table, then the 8-byte aligned arrays
+   BinaryHeader header = {};
+   memcpy(header.magic, c_binaryMagic, sizeof(header.magic));
+   header.version = c_binaryVersion;
+   header.sectionCount = (uint32_t)sections.size();
+
+   std::vector<BinarySection> table(sections.size());
+   uint64_t offset = sizeof(BinaryHeader) + table.size() * sizeof(BinarySection);
+
+   for (size_t i = 0; i < sections.size(); ++i)
+   {
+      BinarySection& entry = table[i];
+      entry.type = sections[i].type;
+      entry.valueSize = c_sectionLayout[entry.type][0];
+      entry.width = c_sectionLayout[entry.type][1];
+      entry.reserved = 0;
+      entry.count = sections[i].count;
+      entry.offset = offset;
+
+      offset += (sectionBytes(entry) + 7) & ~(uint64_t)7;
+   }
+
+   FILE* file = fopen(filePath.c_str(), "wb");
+   if (!file)
+   {
+      return false;
+   }
+
+   bool swap = !littleEndianHost();
+   bool written = true;
+   const char padding[8] = {};
+
+   BinaryHeader fileHeader = header;
+   std::vector<BinarySection> fileTable = table;
+
+   if (swap)
+   {
+      swapHeader(fileHeader);
+      for (auto& entry : fileTable)
+      {
+         swapSection(entry);
+      }
+   }
+
+   written = fwrite(&fileHeader, sizeof(fileHeader), 1, file) == 1;
+   if (written && !fileTable.empty())
+   {
+      written = fwrite(fileTable.data(), sizeof(BinarySection), fileTable.size(), file) == fileTable.size();
+   }
+
+   for (size_t i = 0; written && i < sections.size(); ++i)
+   {
+      size_t bytes = (size_t)sectionBytes(table[i]);
+      const void* data = sections[i].data;
+      std::vector<char> swapped;
+
+      if (swap)
+      {
+         swapped.assign((const char*)data, (const char*)data + bytes);
+         swapBytes(swapped.data(), table[i].valueSize, (size_t)(table[i].count * table[i].width));
+         data = swapped.data();
+      }
+
+      written = fwrite(data, 1, bytes, file) == bytes;
+
+      size_t padBytes = (8 - bytes % 8) % 8;
+      if (written && padBytes > 0)
+      {
+         written = fwrite(padding, 1, padBytes, file) == padBytes;
+      }
+   }
+
+   return fclose(file) == 0 && written;
+}
+
+
+bool Delaunay::readBinary(const std::string& filePath, MeshBuffers* mesh)
+{
+   MappedFile file(filePath);
+   const char* fileData = file.data();
+
+   if (!fileData || file.size() < sizeof(BinaryHeader))
+   {
+      return false;
+   }
+
+   bool swap = !littleEndianHost();
+
+   BinaryHeader header;
+   memcpy(&header, fileData, sizeof(header));
+   if (swap)
+   {
+      swapHeader(header);
+   }
+
+   if (memcmp(header.magic, c_binaryMagic, sizeof(header.magic)) != 0 || 
+       header.version != c_binaryVersion ||
+       header.sectionCount > (file.size() - sizeof(BinaryHeader)) / sizeof(BinarySection))
+   {
+      return false;
+   }
+
+   // check all sections before the current data is replaced, unknown ones are skipped
+   BinarySection found[SectionTypeCount] = {};
+
+   for (uint32_t i = 0; i < header.sectionCount; ++i)
+   {
+      BinarySection entry;
+      memcpy(&entry, fileData + sizeof(BinaryHeader) + i * sizeof(BinarySection), sizeof(entry));
+      if (swap)
+      {
+         swapSection(entry);
+      }
+
+      if (entry.type == 0 || entry.type >= SectionTypeCount)
+      {
+         continue;
+      }
+
+      if (found[entry.type].type != 0 ||
+          entry.valueSize != c_sectionLayout[entry.type][0] ||
+          entry.width != c_sectionLayout[entry.type][1] ||
+          entry.offset % 8 != 0 || 
+          entry.offset > file.size() ||
+          entry.count > (file.size() - entry.offset) / (entry.valueSize * entry.width))
+      {
+         return false;
+      }
+      found[entry.type] = entry;
+   }
+
+   const BinarySection& nodes = found[NodesSection];
+   const BinarySection& segments = found[SegmentsSection];
+   const BinarySection& elements = found[ElementsSection];
+   const BinarySection& neighbors = found[NeighborsSection];
+
+   if (nodes.count > (uint64_t)std::numeric_limits<int>::max() ||
+       elements.count > (uint64_t)std::numeric_limits<int>::max() ||
+       (neighbors.type != 0 && neighbors.count != elements.count))
+   {
+      return false;
+   }
+
+   if (!indexesInRange<int32_t>(fileData, segments, 0, nodes.count) ||
+       !indexesInRange<int32_t>(fileData, elements, 0, nodes.count) ||
+       !indexesInRange<int32_t>(fileData, neighbors, -1, elements.count))
+   {
+      return false;
+   }
+
+   // input data, the points without any parsing
+   m_pointList.resize((size_t)nodes.count);
+   copySection(fileData, nodes, m_pointList.data());
+
+   m_segmentList.resize((size_t)(segments.count * 2));
+   copySection(fileData, segments, m_segmentList.data());
+
+   m_holesList.resize((size_t)found[HolesSection].count);
+   copySection(fileData, found[HolesSection], m_holesList.data());
+
+   m_regionsConstrList.resize((size_t)found[RegionsSection].count);
+   copySection(fileData, found[RegionsSection], m_regionsConstrList.data());
+
+   // the memory pools are freed or reused by the next triangulation
+   freeVoronoiOutput();
+   m_triangulated = false;
+
+   // the stored mesh
+   if (mesh)
+   {
+      mesh->vertexCount = (int)nodes.count;
+      mesh->triangleCount = (int)elements.count;
+      mesh->edgeCount = 0;
+
+      auto target = [](auto*& buffer, auto& vec, size_t size) 
+      {
+         if (buffer)
+         {
+            return buffer;
+         }
+         vec.resize(size);
+         return vec.data();
+      };
+
+      copySection(fileData, nodes, target(mesh->pointsBuffer, mesh->points, 2 * (size_t)nodes.count));
+      copySection(fileData, elements, target(mesh->trianglesBuffer, mesh->triangles, 3 * (size_t)elements.count));
+
+      if (mesh->exportNeighbors && neighbors.type != 0)
+      {
+         copySection(fileData, neighbors, target(mesh->neighborsBuffer, mesh->neighbors, 3 * (size_t)neighbors.count));
+      }
+      else
+      {
+         mesh->neighbors.clear();
+      }
+   }
+
+   return true;
 }
 
 
@@ -799,6 +1693,24 @@ int Delaunay::holeCount() const
 }
 
 
+PredicateStats Delaunay::predicateStats() const
+{
+    PredicateStats stats;
+
+    if (m_pmesh)
+    {
+        TP_MESH();
+
+        stats.incircleTests = (size_t)tpmesh->incirclecount;
+        stats.incircleExact = (size_t)tpmesh->incircleexactcount;
+        stats.orientationTests = (size_t)tpmesh->counterclockcount;
+        stats.orientationExact = (size_t)tpmesh->counterclockexactcount;
+    }
+
+    return stats;
+}
+
+
 bool Delaunay::hasTriangulation() const
 {
     return m_triangulated;
@@ -837,6 +1749,60 @@ FaceIterator FacesList::end()
 }
 
 
+namespace {
+
+   struct PoolBlock
+   {
+      char* firstItem;
+      int itemCount;  // dead items included
+   };
+
+   // the non-empty blocks of one of TriLib's pools, in the order of traverse()
+   std::vector<PoolBlock> poolBlocks(Triwrap* pTriangleWrap, Triwrap::memorypool* pool)
+   {
+      std::vector<PoolBlock> blocks;
+
+      for (VOID** block = pool->firstblock; block != nullptr; block = (VOID**)*block)
+      {
+         int count = 0;
+         VOID* first = pTriangleWrap->poolblockitems(pool, block, &count);
+
+         if (count > 0)
+         {
+            blocks.push_back({ (char*)first, count });
+         }
+         if (block == pool->nowblock)
+         {
+            break;
+         }
+      }
+
+      return blocks;
+   }
+}
+
+
+std::vector<FaceRange> FacesList::ranges() const
+{
+   std::vector<FaceRange> ranges;
+
+   if (!m_delaunay->hasTriangulation())
+   {
+      return ranges;
+   }
+
+   Triwrap::__pmesh* tpmesh = static_cast<Triwrap::__pmesh*>(m_delaunay->m_pmesh);
+   Triwrap* pTriangleWrap = static_cast<Triwrap*>(m_delaunay->m_triangleWrap);
+
+   for (const PoolBlock& block : poolBlocks(pTriangleWrap, &tpmesh->triangles))
+   {
+      ranges.push_back(FaceRange(m_delaunay, block.firstItem, block.itemCount, tpmesh->triangles.itembytes));
+   }
+
+   return ranges;
+}
+
+
 VertexIterator Delaunay::vbegin()
 {
    return VertexIterator(this);
@@ -869,6 +1835,28 @@ VertexList::VertexListIterator VertexList::end()
 }
 
 
+std::vector<VertexRange> VertexList::ranges() const
+{
+   std::vector<VertexRange> ranges;
+
+   if (!m_delaunay->hasTriangulation())
+   {
+      return ranges;
+   }
+
+   Triwrap::__pmesh* tpmesh = static_cast<Triwrap::__pmesh*>(m_delaunay->m_pmesh);
+   Triwrap* pTriangleWrap = static_cast<Triwrap*>(m_delaunay->m_triangleWrap);
+
+   for (const PoolBlock& block : poolBlocks(pTriangleWrap, &tpmesh->vertices))
+   {
+      ranges.push_back(VertexRange(m_delaunay, block.firstItem, block.itemCount, tpmesh->vertices.itembytes, 
+                                   tpmesh->vertexmarkindex + 1));
+   }
+
+   return ranges;
+}
+
+
 VoronoiVertexIterator Delaunay::vvbegin()
 {
    return VoronoiVertexIterator(this);
@@ -944,6 +1932,387 @@ TriangulationMesh Delaunay::mesh()
 }
 
 
+bool Delaunay::exportMesh(MeshBuffers& buffers)
+{
+   static_assert(sizeof(int) == sizeof(int32_t), "TriLib's indexes must be 32 bit!");
+
+   if (!m_triangulated)
+   {
+      return false;
+   }
+
+   TP_MESH_BEHAVIOR_WRAP();
+   typedef Triwrap::triangle triangle;
+   Triwrap::__pmesh* m = tpmesh; // needed for Triwrap's macros
+
+   buffers.vertexCount = verticeCount();
+   buffers.triangleCount = triangleCount();
+   buffers.edgeCount = buffers.exportEdges ? edgeCount() : 0;
+
+   // an empty vector gives nullptr, for which TriLib's output routines would allocate (and leak) their own 
+   // lists, so they aren't called for empty lists
+   auto target = [](auto*& buffer, auto& vec, size_t size) 
+   {
+      if (buffer)
+      {
+         return buffer;
+      }
+      vec.resize(size);
+      return vec.data();
+   };
+
+   // vertices, placed at their numbers (writenodes() would renumber them!)
+   double* pointlist = target(buffers.pointsBuffer, buffers.points, 2 * (size_t)buffers.vertexCount);
+
+   pTriangleWrap->traversalinit(&tpmesh->vertices);
+   Triwrap::vertex vertexloop = pTriangleWrap->vertextraverse(tpmesh);
+
+   while (vertexloop != nullptr)
+   {
+      int vertexIdx = vertexmark(vertexloop) - tpbehavior->firstnumber;
+
+      if ((unsigned)vertexIdx < (unsigned)buffers.vertexCount)
+      {
+         pointlist[2 * vertexIdx] = vertexloop[0];
+         pointlist[2 * vertexIdx + 1] = vertexloop[1];
+      }
+      vertexloop = pTriangleWrap->vertextraverse(tpmesh);
+   }
+
+   // triangles
+   int* trianglelist = target(buffers.trianglesBuffer, buffers.triangles, 3 * (size_t)buffers.triangleCount);
+   double* triangleattriblist = nullptr;
+   int eextras = tpmesh->eextras;
+
+   if (buffers.triangleCount > 0)
+   {
+      tpmesh->eextras = 0; // no attributes wanted
+      pTriangleWrap->writeelements(tpmesh, tpbehavior, &trianglelist, &triangleattriblist);
+      tpmesh->eextras = eextras;
+   }
+
+   // neighbors
+   if (buffers.exportNeighbors)
+   {
+      int* neighborlist = target(buffers.neighborsBuffer, buffers.neighbors, 3 * (size_t)buffers.triangleCount);
+
+      if (buffers.triangleCount > 0)
+      {
+         // writeneighbors() numbers the triangles (and 'dummytri') in their 7th word, which can hold a 
+         // subsegment, an attribute or an area bound!
+         bool slotUsed = tpbehavior->usesegments || tpmesh->eextras > 0 || tpbehavior->regionattrib || tpbehavior->vararea;
+         std::vector<triangle> savedSlots;
+         triangle dummySlot = tpmesh->dummytri[6];
+
+         if (slotUsed)
+         {
+            savedSlots.reserve(buffers.triangleCount);
+            pTriangleWrap->traversalinit(&tpmesh->triangles);
+
+            for (triangle* tri = pTriangleWrap->triangletraverse(tpmesh); tri != nullptr; tri = pTriangleWrap->triangletraverse(tpmesh))
+            {
+               savedSlots.push_back(tri[6]);
+            }
+         }
+
+         pTriangleWrap->writeneighbors(tpmesh, tpbehavior, &neighborlist);
+
+         if (slotUsed)
+         {
+            size_t i = 0;
+            pTriangleWrap->traversalinit(&tpmesh->triangles);
+
+            for (triangle* tri = pTriangleWrap->triangletraverse(tpmesh); tri != nullptr; tri = pTriangleWrap->triangletraverse(tpmesh))
+            {
+               tri[6] = savedSlots[i++];
+            }
+         }
+         tpmesh->dummytri[6] = dummySlot;
+      }
+   }
+
+   // edges
+   if (buffers.exportEdges)
+   {
+      int* edgelist = target(buffers.edgesBuffer, buffers.edges, 2 * (size_t)buffers.edgeCount);
+      int* edgemarkerlist = target(buffers.edgeMarkersBuffer, buffers.edgeMarkers, (size_t)buffers.edgeCount);
+
+      if (buffers.edgeCount > 0)
+      {
+         int nobound = tpbehavior->nobound;
+         tpbehavior->nobound = 0; // markers wanted
+         pTriangleWrap->writeedges(tpmesh, tpbehavior, &edgelist, &edgemarkerlist);
+         tpbehavior->nobound = nobound;
+      }
+   }
+
+   return true;
+}
+
+
+bool Delaunay::exportAdjacency(MeshAdjacency& adjacency)
+{
+   if (!m_triangulated)
+   {
+      return false;
+   }
+
+   TP_MESH_BEHAVIOR_WRAP();
+   Triwrap::__pmesh* m = tpmesh;          // needed for Triwrap's macros
+   typedef Triwrap::triangle triangle;    // dito
+   typedef Triwrap::vertex vertex;        // dito
+
+   adjacency.vertexCount = verticeCount();
+   adjacency.triangleCount = triangleCount();
+
+   const size_t vertexCount = (size_t)adjacency.vertexCount;
+   const size_t triCount = (size_t)adjacency.triangleCount;
+   const bool needTriangleIds = adjacency.exportVertexTriangles || adjacency.exportTriangleNeighbors;
+
+   // the passes below are split by the blocks of the triangle pool
+   std::vector<PoolBlock> blocks = poolBlocks(pTriangleWrap, &tpmesh->triangles);
+   const int itemBytes = tpmesh->triangles.itembytes;
+
+   auto forEachTriangle = [&blocks, itemBytes](size_t b, auto work)
+   {
+      char* end = blocks[b].firstItem + (size_t)blocks[b].itemCount * itemBytes;
+
+      for (char* item = blocks[b].firstItem; item != end; item += itemBytes)
+      {
+         if (!deadtri((triangle*)item))
+         {
+            work((triangle*)item);
+         }
+      }
+   };
+
+   auto vertexNumber = [m, tpbehavior](vertex v)
+   {
+      return vertexmark(v) - tpbehavior->firstnumber;
+   };
+
+   // an edge is visited from the triangle with the lower address, or from its only triangle on the boundary
+   auto ownsEdge = [m](const Triwrap::__otriangle& tri, const Triwrap::__otriangle& neighbor)
+   {
+      return neighbor.tri == m->dummytri || tri.tri < neighbor.tri;
+   };
+
+   auto prefixSum = [](std::vector<int32_t>& offsets)
+   {
+      for (size_t i = 1; i < offsets.size(); ++i)
+      {
+         offsets[i] += offsets[i - 1];
+      }
+   };
+
+   // counters of the rows, and then the positions of their next entries
+   std::unique_ptr<std::atomic<int32_t>[]> vertexCursors(new std::atomic<int32_t>[vertexCount]);
+   std::unique_ptr<std::atomic<int32_t>[]> vertexTriangleCursors(new std::atomic<int32_t>[vertexCount]);
+
+   for (size_t i = 0; i < vertexCount; ++i)
+   {
+      vertexCursors[i].store(0, std::memory_order_relaxed);
+      vertexTriangleCursors[i].store(0, std::memory_order_relaxed);
+   }
+
+   adjacency.vertexOffsets.assign(adjacency.exportVertexNeighbors ? vertexCount + 1 : 0, 0);
+   adjacency.vertexTriangleOffsets.assign(adjacency.exportVertexTriangles ? vertexCount + 1 : 0, 0);
+   adjacency.triangleOffsets.assign(adjacency.exportTriangleNeighbors ? triCount + 1 : 0, 0);
+
+   // the triangles are numbered in the order of the FaceIterator, in their 7th word like in writeneighbors(), 
+   // which can hold a subsegment, an attribute or an area bound!
+   bool slotUsed = tpbehavior->usesegments || tpmesh->eextras > 0 || tpbehavior->regionattrib || tpbehavior->vararea;
+   std::vector<triangle> savedSlots(needTriangleIds && slotUsed ? triCount : 0);
+   std::vector<int32_t> blockFirstIds(blocks.size() + 1, 0);
+
+   auto triangleId = [](triangle* tri)
+   {
+      return *(int*)(tri + 6);
+   };
+
+   if (needTriangleIds)
+   {
+      parallelFor(blocks.size(), [&](size_t b)
+         {
+            int32_t count = 0;
+            forEachTriangle(b, [&count](triangle*) { ++count; });
+            blockFirstIds[b + 1] = count;
+         }, m_threadCount);
+
+      prefixSum(blockFirstIds);
+      Assert((size_t)blockFirstIds.back() == triCount, "Triangle count doesn't match the triangle pool!");
+
+      parallelFor(blocks.size(), [&](size_t b)
+         {
+            int id = blockFirstIds[b];
+
+            forEachTriangle(b, [&](triangle* tri)
+               {
+                  if (slotUsed)
+                  {
+                     savedSlots[id] = tri[6];
+                  }
+                  *(int*)(tri + 6) = id++;
+               });
+         }, m_threadCount);
+   }
+
+   // count the entries of the rows...
+   parallelFor(blocks.size(), [&](size_t b)
+      {
+         forEachTriangle(b, [&](triangle* tri)
+            {
+               triangle ptr; // needed for Triwrap's macros
+               Triwrap::__otriangle triloop = { tri, 0 };
+               Triwrap::__otriangle neighbor;
+               int32_t neighborCount = 0;
+
+               for (triloop.orient = 0; triloop.orient < 3; ++triloop.orient)
+               {
+                  vertex from, to;
+                  org(triloop, from);
+                  dest(triloop, to);
+                  sym(triloop, neighbor);
+
+                  if (neighbor.tri != m->dummytri)
+                  {
+                     ++neighborCount;
+                  }
+                  if (adjacency.exportVertexNeighbors && ownsEdge(triloop, neighbor))
+                  {
+                     vertexCursors[vertexNumber(from)].fetch_add(1, std::memory_order_relaxed);
+                     vertexCursors[vertexNumber(to)].fetch_add(1, std::memory_order_relaxed);
+                  }
+                  if (adjacency.exportVertexTriangles)
+                  {
+                     vertexTriangleCursors[vertexNumber(from)].fetch_add(1, std::memory_order_relaxed);
+                  }
+               }
+
+               if (adjacency.exportTriangleNeighbors)
+               {
+                  adjacency.triangleOffsets[triangleId(tri) + 1] = neighborCount;
+               }
+            });
+      }, m_threadCount);
+
+   // ... turn the counts into offsets...
+   for (size_t i = 0; i < vertexCount; ++i)
+   {
+      if (adjacency.exportVertexNeighbors)
+      {
+         adjacency.vertexOffsets[i + 1] = vertexCursors[i].load(std::memory_order_relaxed);
+      }
+      if (adjacency.exportVertexTriangles)
+      {
+         adjacency.vertexTriangleOffsets[i + 1] = vertexTriangleCursors[i].load(std::memory_order_relaxed);
+      }
+   }
+
+   prefixSum(adjacency.vertexOffsets);
+   prefixSum(adjacency.vertexTriangleOffsets);
+   prefixSum(adjacency.triangleOffsets);
+
+   for (size_t i = 0; i < vertexCount; ++i)
+   {
+      if (adjacency.exportVertexNeighbors)
+      {
+         vertexCursors[i].store(adjacency.vertexOffsets[i], std::memory_order_relaxed);
+      }
+      if (adjacency.exportVertexTriangles)
+      {
+         vertexTriangleCursors[i].store(adjacency.vertexTriangleOffsets[i], std::memory_order_relaxed);
+      }
+   }
+
+   adjacency.vertexNeighbors.resize(adjacency.exportVertexNeighbors ? (size_t)adjacency.vertexOffsets.back() : 0);
+   adjacency.vertexTriangles.resize(adjacency.exportVertexTriangles ? (size_t)adjacency.vertexTriangleOffsets.back() : 0);
+   adjacency.triangleNeighbors.resize(adjacency.exportTriangleNeighbors ? (size_t)adjacency.triangleOffsets.back() : 0);
+
+   // ... and fill them
+   parallelFor(blocks.size(), [&](size_t b)
+      {
+         forEachTriangle(b, [&](triangle* tri)
+            {
+               triangle ptr; // needed for Triwrap's macros
+               Triwrap::__otriangle triloop = { tri, 0 };
+               Triwrap::__otriangle neighbor;
+               int id = needTriangleIds ? triangleId(tri) : -1;
+
+               for (triloop.orient = 0; triloop.orient < 3; ++triloop.orient)
+               {
+                  vertex from, to;
+                  org(triloop, from);
+                  dest(triloop, to);
+                  sym(triloop, neighbor);
+
+                  if (adjacency.exportVertexNeighbors && ownsEdge(triloop, neighbor))
+                  {
+                     int fromIdx = vertexNumber(from);
+                     int toIdx = vertexNumber(to);
+
+                     adjacency.vertexNeighbors[vertexCursors[fromIdx].fetch_add(1, std::memory_order_relaxed)] = toIdx;
+                     adjacency.vertexNeighbors[vertexCursors[toIdx].fetch_add(1, std::memory_order_relaxed)] = fromIdx;
+                  }
+                  if (adjacency.exportVertexTriangles)
+                  {
+                     adjacency.vertexTriangles[vertexTriangleCursors[vertexNumber(from)].fetch_add(1, std::memory_order_relaxed)] = id;
+                  }
+               }
+
+               if (adjacency.exportTriangleNeighbors)
+               {
+                  // in the order of writeneighbors(), i.e. opposite to the Org, Dest and Apex vertices
+                  int32_t* entry = adjacency.triangleNeighbors.data() + adjacency.triangleOffsets[id];
+
+                  for (int orient : { 1, 2, 0 })
+                  {
+                     triloop.orient = orient;
+                     sym(triloop, neighbor);
+
+                     if (neighbor.tri != m->dummytri)
+                     {
+                        *entry++ = triangleId(neighbor.tri);
+                     }
+                  }
+               }
+            });
+      }, m_threadCount);
+
+   // the vertex rows were filled in no defined order
+   const size_t vertexChunkSize = 16 * 1024;
+
+   parallelFor((vertexCount + vertexChunkSize - 1) / vertexChunkSize, [&](size_t chunk)
+      {
+         size_t last = std::min(vertexCount, (chunk + 1) * vertexChunkSize);
+
+         for (size_t i = chunk * vertexChunkSize; i < last; ++i)
+         {
+            if (adjacency.exportVertexNeighbors)
+            {
+               std::sort(adjacency.vertexNeighbors.begin() + adjacency.vertexOffsets[i], 
+                         adjacency.vertexNeighbors.begin() + adjacency.vertexOffsets[i + 1]);
+            }
+            if (adjacency.exportVertexTriangles)
+            {
+               std::sort(adjacency.vertexTriangles.begin() + adjacency.vertexTriangleOffsets[i], 
+                         adjacency.vertexTriangles.begin() + adjacency.vertexTriangleOffsets[i + 1]);
+            }
+         }
+      }, m_threadCount);
+
+   if (!savedSlots.empty())
+   {
+      parallelFor(blocks.size(), [&](size_t b)
+         {
+            forEachTriangle(b, [&](triangle* tri) { tri[6] = savedSlots[triangleId(tri)]; });
+         }, m_threadCount);
+   }
+
+   return true;
+}
+
+
 bool Delaunay::OrderPoints::operator() (const Point& lhs, const Point& rhs) const
 {
    // first sort on X, then on Y coordinates!
@@ -964,17 +2333,131 @@ bool Delaunay::OrderPoints::operator() (const Point& lhs, const Point& rhs) cons
 
 // private methods
 
+namespace {
+
+   static_assert(Triangulating == PROGRESSDELAUNAY && InsertingSegments == PROGRESSSEGMENTS &&
+                 CarvingHoles == PROGRESSHOLES && Refining == PROGRESSQUALITY, "Phases don't match TriLib's!");
+
+   // a running triangulation, @see RunControl
+   struct RunState
+   {
+      typedef std::chrono::steady_clock Clock;
+
+      explicit RunState(const RunControl& runControl)
+         : control(runControl),
+           start(Clock::now()),
+           lastReport(start),
+           lastPhase(-1)
+      {}
+
+      const RunControl& control;
+      Clock::time_point start;
+      Clock::time_point lastReport;
+      int lastPhase;
+   };
+
+   // TriLib's sizing field, interpolated in a grid
+   double gridSizing(void* context, double x, double y)
+   {
+      const SizingGrid& grid = *static_cast<const SizingGrid*>(context);
+
+      // grid coordinates, clamped to the border
+      double u = std::min(std::max((x - grid.xmin) / grid.dx, 0.0), (double)(grid.nx - 1));
+      double v = std::min(std::max((y - grid.ymin) / grid.dy, 0.0), (double)(grid.ny - 1));
+
+      int i0 = (int)u;
+      int j0 = (int)v;
+      int i1 = std::min(i0 + 1, grid.nx - 1);
+      int j1 = std::min(j0 + 1, grid.ny - 1);
+      double fu = u - i0;
+      double fv = v - j0;
+
+      const double* row0 = grid.edgeLengths.data() + (size_t)j0 * grid.nx;
+      const double* row1 = grid.edgeLengths.data() + (size_t)j1 * grid.nx;
+
+      if (row0[i0] <= 0 || row0[i1] <= 0 || row1[i0] <= 0 || row1[i1] <= 0)
+      {
+         return 0.0; // unconstrained
+      }
+
+      return (1 - fv) * ((1 - fu) * row0[i0] + fu * row0[i1]) + fv * ((1 - fu) * row1[i0] + fu * row1[i1]);
+   }
+
+   // TriLib's sizing field, given by the caller
+   double functionSizing(void* context, double x, double y)
+   {
+      return (*static_cast<const Delaunay::SizingFunction*>(context))(x, y);
+   }
+
+   // TriLib's progress hook
+   int checkRunControl(void* context, int phase, long done, long total)
+   {
+      RunState& state = *static_cast<RunState*>(context);
+      const RunControl& control = state.control;
+      TriangulationPhase triPhase = static_cast<TriangulationPhase>(phase);
+
+      if (control.cancellation.isCancelled())
+      {
+         throw TriangulationAborted(TriangulationAborted::Cancelled, triPhase);
+      }
+
+      RunState::Clock::time_point now = RunState::Clock::now();
+      double elapsed = std::chrono::duration<double>(now - state.start).count();
+
+      if (control.progress)
+      {
+         // the start and the end of a phase are always reported
+         if (phase != state.lastPhase || done == total ||
+             std::chrono::duration<double>(now - state.lastReport).count() >= control.progressIntervalSeconds)
+         {
+            state.lastPhase = phase;
+            state.lastReport = now;
+            control.progress(TriangulationProgress{ triPhase, (size_t)done, (size_t)total, elapsed });
+         }
+      }
+
+      if (control.timeBudgetSeconds > 0.0 && elapsed > control.timeBudgetSeconds)
+      {
+         if (phase != PROGRESSQUALITY)
+         {
+            throw TriangulationAborted(TriangulationAborted::TimeBudgetExceeded, triPhase);
+         }
+         return 1; // no more Steiner points
+      }
+
+      return 0;
+   }
+}
+
+
 void Delaunay::invokeTriLib(std::string& triswitches)
 {
    INIT_TRACE("triangle.out.txt");
    TRACE("Triangulate ->");
 
-   if (m_triangulated)
+   m_triSwitches = triswitches;
+
+   // keep TriLib's memory pools of the last triangulation?
+   bool warmStart = m_reusePools && m_triangleWrap != nullptr;
+
+   if (warmStart)
    {
-      freeTriangleDataStructs();
+      freeVoronoiOutput();
+   }
+   else
+   {
+      freeTriangleDataStructs(); // also after an aborted triangulation
    }
+   m_triangulated = false;
+   m_refinementStopped = false;
+   m_triangleTable.clear();
+   m_meshVertexIndex.clear();
+   clearVertexMap();
 
-   m_in = new triangulateio;
+   if (m_in == nullptr)
+   {
+      m_in = new triangulateio;
+   }
    TP_INPUT();
    
    initTriangleInputData(pin, m_pointList);
@@ -1027,80 +2510,305 @@ void Delaunay::invokeTriLib(std::string& triswitches)
    triswitches.push_back('\0');
    char* pTriswitches = &triswitches[0];
 
-   m_pmesh = new Triwrap::__pmesh;
-   m_pbehavior = new Triwrap::__pbehavior;
-   m_triangleWrap = new Triwrap;
+   if (!warmStart)
+   {
+      m_pmesh = new Triwrap::__pmesh();
+      m_pbehavior = new Triwrap::__pbehavior;
+      m_triangleWrap = new Triwrap;
+   }
 
+   setMemoryOptions();
    TP_MESH_BEHAVIOR_WRAP();
 
    pTriangleWrap->parsecommandline(1, &pTriswitches, tpbehavior);
+   tpbehavior->threads = (m_threadCount > 0) ? (int)m_threadCount : (int)WorkStealingPool::defaultThreadCount();
+   tpbehavior->tilesize = (int)std::min<unsigned>(m_tileSize, std::numeric_limits<int>::max());
+
+   tpbehavior->triangleids = m_triangleIds ? 1 : 0;
+
+   if (m_predicateMode == Unchecked)
+   {
+      tpbehavior->noexact = 1; // as the -X switch
+   }
+
+   if (m_runControl.maxSteinerPoints >= 0)
+   {
+      tpbehavior->steiner = m_runControl.maxSteinerPoints; // as the -S switch
+   }
+
+   if (m_reserveMesh)
+   {
+      setReservedMeshSize();
+   }
 
    // initialize data structs
-   pTriangleWrap->triangleinit(tpmesh);
+   if (warmStart)
+   {
+      pTriangleWrap->trianglerestart(tpmesh); // pools are restarted, not reallocated
+   }
+   else
+   {
+      pTriangleWrap->triangleinit(tpmesh);
+   }
    tpmesh->steinerleft = tpbehavior->steiner;
 
-   pTriangleWrap->transfernodes(
-         tpmesh, tpbehavior, pin->pointlist,
-         pin->pointattributelist,
-         pin->pointmarkerlist, pin->numberofpoints,
-         pin->numberofpointattributes);
+   // progress reports and cancellation, from here on an abort discards the mesh
+   RunState runState(m_runControl);
+   pTriangleWrap->progresshook = checkRunControl;
+   pTriangleWrap->progresscontext = &runState;
+   pTriangleWrap->usertestfunc = m_userTestFunc;
+   pTriangleWrap->usertestcontext = m_userTestContext.get();
+
+   if (!m_sizingGrid.edgeLengths.empty())
+   {
+      pTriangleWrap->sizingfunc = gridSizing;
+      pTriangleWrap->sizingcontext = &m_sizingGrid;
+   }
+   else
+   {
+      pTriangleWrap->sizingfunc = m_sizingFunction ? functionSizing : nullptr;
+      pTriangleWrap->sizingcontext = &m_sizingFunction;
+   }
+
+   try
+   {
+      pTriangleWrap->transfernodes(
+            tpmesh, tpbehavior, pin->pointlist,
+            pin->pointattributelist,
+            pin->pointmarkerlist, pin->numberofpoints,
+            pin->numberofpointattributes);
+
+      // MAIN work: triangulate!
+      tpmesh->hullsize = pTriangleWrap->delaunay(tpmesh, tpbehavior);
+
+      // OPEN TODO:: 
+      //    if(concave hull) - compute concave hull with the chi-algorithm,
+      //                     - use it as segments in formskeleton()!!
+
+      // Ensure that no vertex can be mistaken for a triangular bounding box 
+      // vertex in insertvertex()!
+      tpmesh->infvertex1 = nullptr;
+      tpmesh->infvertex2 = nullptr;
+      tpmesh->infvertex3 = nullptr;
+
+      // support for the "-q" option
+      if (tpbehavior->usesegments && (tpmesh->triangles.items > 0))
+      {
+         tpmesh->checksegments = 1;
 
-   // MAIN work: triangulate!
-   tpmesh->hullsize = pTriangleWrap->delaunay(tpmesh, tpbehavior);
+         if (!tpbehavior->refine)
+         {
+            // Insert PSLG segments and/or convex hull segments.
+            pTriangleWrap->formskeleton(tpmesh, tpbehavior, pin->segmentlist,
+                                        pin->segmentmarkerlist, pin->numberofsegments);
+         }
+      }
 
-   // OPEN TODO:: 
-   //    if(concave hull) - compute concave hull with the chi-algorithm,
-   //                     - use it as segments in formskeleton()!!
+      // carve out the holes before enforcing quality constr!
+      if (tpbehavior->poly && (tpmesh->triangles.items > 0))
+      {
+         tpmesh->holes = pin->numberofholes;
+         double* holelist = pin->holelist;
 
-   // Ensure that no vertex can be mistaken for a triangular bounding box 
-   // vertex in insertvertex()!
-   tpmesh->infvertex1 = nullptr;
-   tpmesh->infvertex2 = nullptr;
-   tpmesh->infvertex3 = nullptr;
+         tpmesh->regions = pin->numberofregions;
+         double* regionlist = pin->regionlist; 
 
-   // support for the "-q" option
-   if (tpbehavior->usesegments && (tpmesh->triangles.items > 0))
-   {
-      tpmesh->checksegments = 1;
+         if (!tpbehavior->refine)
+         {
+            // Carve out holes and concavities.
+            pTriangleWrap->carveholes(tpmesh, tpbehavior, holelist, tpmesh->holes, regionlist, tpmesh->regions);
+         }
+      }
 
-      if (!tpbehavior->refine)
+      if (tpbehavior->quality && (tpmesh->triangles.items > 0))
       {
-         // Insert PSLG segments and/or convex hull segments.
-         pTriangleWrap->formskeleton(tpmesh, tpbehavior, pin->segmentlist,
-                                     pin->segmentmarkerlist, pin->numberofsegments);
+         // Enforce angle and area constraints
+         pTriangleWrap->enforcequality(tpmesh, tpbehavior);
+
+         // stopped by a budget before all bad triangles and encroached segments were fixed?
+         m_refinementStopped = (tpmesh->steinerleft == 0) && 
+                               (tpmesh->badtriangles.items > 0 || tpmesh->badsubsegs.items > 0);
       }
+
+      // Calculate the number of edges.
+      tpmesh->edges = (3l * tpmesh->triangles.items + tpmesh->hullsize) / 2l;
+
+      pTriangleWrap->numbernodes(tpmesh, tpbehavior);
+      numberTriangles();
+      numberMeshVertices();
+      TRACE2i("<- Triangulate: triangles= ", tpmesh->triangles.items);
+   }
+   catch (...)
+   {
+      END_TRACE("triangle.out.txt");
+      freeTriangleDataStructs();
+      throw;
+   }
+
+   pTriangleWrap->progresshook = nullptr;
+   pTriangleWrap->progresscontext = nullptr;
+
+   m_triangulated = true;
+   END_TRACE("triangle.out.txt");
+}
+
+
+void Delaunay::retriangulate()
+{
+   // repeat the last triangulation, using the changed input
+   std::string options = m_triSwitches;
+   bool voronoi = (m_vorout != nullptr);
+
+   invokeTriLib(options);
+
+   if (voronoi)
+   {
+      createVoronoiOutput();
+   }
+}
+
+
+bool Delaunay::canUpdateInPlace() const
+{
+   if (!m_triangulated || m_vorout != nullptr)
+   {
+      return false;
+   }
+
+   TP_MESH_BEHAVIOR();
+
+   // segments, holes and Steiner points would have to be re-created
+   return !tpbehavior->usesegments && (tpmesh->triangles.items > 0);
+}
+
+
+void Delaunay::numberTriangles()
+{
+   TP_MESH_BEHAVIOR_WRAP();
+
+   // the triangle pool has room for the ids only if they were enabled before its initialization
+   if (!tpbehavior->triangleids)
+   {
+      m_triangleTable.clear();
+      return;
    }
 
-   // carve out the holes before enforcing quality constr!
-   if (tpbehavior->poly && (tpmesh->triangles.items > 0))
+   m_triangleTable.resize(tpmesh->triangles.items);
+   pTriangleWrap->numbertriangles(tpmesh, reinterpret_cast<Triwrap::triangle**>(m_triangleTable.data()));
+}
+
+
+void Delaunay::numberMeshVertices()
+{
+   m_meshVertexIndex.clear();
+
+   if (!m_meshIndexing)
+   {
+      return;
+   }
+
+   TP_MESH_BEHAVIOR_WRAP();
+   Triwrap::__pmesh* m = tpmesh;       // needed for Triwrap's macros
+   typedef Triwrap::vertex vertex;     // dito
+
+   // numbernodes() numbers all the vertices, also the ones in no triangle
+   m_meshVertexIndex.resize(tpmesh->vertices.items, -1);
+   int meshIndex = 0;
+
+   Triwrap::__otriangle triangleloop;
+   triangleloop.orient = 0;
+   pTriangleWrap->traversalinit(&tpmesh->triangles);
+
+   for (triangleloop.tri = pTriangleWrap->triangletraverse(tpmesh); triangleloop.tri != nullptr; 
+        triangleloop.tri = pTriangleWrap->triangletraverse(tpmesh))
    {
-      tpmesh->holes = pin->numberofholes;
-      double* holelist = pin->holelist;
+      Triwrap::vertex corners[3];
+      org(triangleloop, corners[0]);
+      dest(triangleloop, corners[1]);
+      apex(triangleloop, corners[2]);
+
+      // in the order the face iteration meets them
+      for (Triwrap::vertex corner : corners)
+      {
+         int vertexNumber = vertexmark(corner) - tpbehavior->firstnumber;
+         Assert((unsigned)vertexNumber < m_meshVertexIndex.size(), "Vertex number out of bounds!");
+
+         if (m_meshVertexIndex[vertexNumber] < 0)
+         {
+            m_meshVertexIndex[vertexNumber] = meshIndex++;
+         }
+      }
+   }
+}
+
+
+void Delaunay::mapVertices()
+{
+   TP_MESH_BEHAVIOR_WRAP();
+   Triwrap::__pmesh* m = tpmesh;          // needed for Triwrap's macros
+   typedef Triwrap::triangle triangle;    // dito
+   typedef Triwrap::vertex vertex;        // dito
+   typedef Triwrap::int_ptr_type int_ptr_type; // dito
 
-      tpmesh->regions = pin->numberofregions;
-      double* regionlist = pin->regionlist; 
+   m_vertexTable.assign(tpmesh->vertices.items, nullptr);
+   m_vertexTriangles.assign(tpmesh->vertices.items, nullptr);
 
-      if (!tpbehavior->refine)
+   pTriangleWrap->traversalinit(&tpmesh->vertices);
+
+   for (Triwrap::vertex vertexloop = pTriangleWrap->vertextraverse(tpmesh); vertexloop != nullptr; 
+        vertexloop = pTriangleWrap->vertextraverse(tpmesh))
+   {
+      int vertexNumber = vertexmark(vertexloop) - tpbehavior->firstnumber;
+      Assert((unsigned)vertexNumber < m_vertexTable.size(), "Vertex number out of bounds!");
+
+      // with -j, an undead vertex shares its number with the next vertex
+      if (!m_vertexTable[vertexNumber] || vertextype(vertexloop) != UNDEADVERTEX)
       {
-         // Carve out holes and concavities.
-         pTriangleWrap->carveholes(tpmesh, tpbehavior, holelist, tpmesh->holes, regionlist, tpmesh->regions);
+         m_vertexTable[vertexNumber] = vertexloop;
       }
    }
 
-   if (tpbehavior->quality && (tpmesh->triangles.items > 0))
+   // as makevertexmap(), but each vertex is linked to the first of its triangles in the order of the 
+   // FaceIterator, so locate() finds the first face with the vertex as its origin. The links are kept 
+   // here, TriLib's vertices have no room for them without the -p switch.
+   Triwrap::__otriangle triangleloop;
+   pTriangleWrap->traversalinit(&tpmesh->triangles);
+
+   for (triangleloop.tri = pTriangleWrap->triangletraverse(tpmesh); triangleloop.tri != nullptr; 
+        triangleloop.tri = pTriangleWrap->triangletraverse(tpmesh))
    {
-      // Enforce angle and area constraints
-      pTriangleWrap->enforcequality(tpmesh, tpbehavior);
+      for (triangleloop.orient = 0; triangleloop.orient < 3; ++triangleloop.orient)
+      {
+         vertex triorg;
+         org(triangleloop, triorg);
+         int vertexNumber = vertexmark(triorg) - tpbehavior->firstnumber;
+
+         if (m_vertexTriangles[vertexNumber] == nullptr)
+         {
+            m_vertexTriangles[vertexNumber] = encode(triangleloop);
+         }
+      }
    }
+}
 
-   // Calculate the number of edges.
-   tpmesh->edges = (3l * tpmesh->triangles.items + tpmesh->hullsize) / 2l;
 
-   pTriangleWrap->numbernodes(tpmesh, tpbehavior);
-   TRACE2i("<- Triangulate: triangles= ", tpmesh->triangles.items);
+void Delaunay::clearVertexMap()
+{
+   m_vertexTable.clear();
+   m_vertexTriangles.clear();
+   m_vertexMapReady = false;
+}
+
 
-   m_triangulated = true;
-   END_TRACE("triangle.out.txt");
+void Delaunay::updateMeshCounts()
+{
+   TP_MESH();
+
+   // Euler's formula for a triangulation of a convex point set
+   long meshVertices = tpmesh->vertices.items - tpmesh->undeads;
+
+   tpmesh->hullsize = 2l * meshVertices - 2l - tpmesh->triangles.items;
+   tpmesh->edges = (3l * tpmesh->triangles.items + tpmesh->hullsize) / 2l;
 }
 
 
@@ -1148,6 +2856,11 @@ void Delaunay::setQualityOptions(std::string& options, bool quality)
         {
             options.append("a" + formatFloatConstraint(m_maxArea));
         }
+
+        if (m_userTestFunc)
+        {
+            options.append("u");
+        }
     }
 
     // TEST::: algorithm
@@ -1185,16 +2898,19 @@ void Delaunay::freeTriangleDataStructs()
 
    //struct triangulateio* pin = (struct triangulateio*) m_in;
 
+   freeVoronoiOutput();
+
    TP_MESH_BEHAVIOR_WRAP();
    TP_INPUT();
-   TP_VOROUT();
 
-   pTriangleWrap->triangledeinit(tpmesh, tpbehavior);
+   if (pTriangleWrap)
+   {
+      pTriangleWrap->triangledeinit(tpmesh);
+   }
 
    delete tpmesh;
    delete tpbehavior;
    delete pin;
-   delete tpvorout;
    delete pTriangleWrap;
 
    m_in = nullptr;
@@ -1202,6 +2918,9 @@ void Delaunay::freeTriangleDataStructs()
    m_triangleWrap = nullptr;
    m_pmesh = nullptr;
    m_pbehavior = nullptr;
+   m_triangleTable.clear();
+   m_meshVertexIndex.clear();
+   clearVertexMap();
 }
 
 
@@ -1213,6 +2932,7 @@ void Delaunay::initTriangleDataForPoints()
     m_pmesh = new Triwrap::__pmesh;
     m_pbehavior = new Triwrap::__pbehavior;
 
+    setMemoryOptions();
     TP_MESH_BEHAVIOR_WRAP();
 
     *tpmesh = {};  // OPEN TODO::: .............. {} too big for the stack, warning by VisualStudio!?
@@ -1230,24 +2950,81 @@ void Delaunay::initTriangleDataForPoints()
 }
 
 
+void Delaunay::setMemoryOptions()
+{
+   Triwrap* pTriangleWrap = static_cast<Triwrap*>(m_triangleWrap);
+
+   pTriangleWrap->memresource = m_memResource;
+   pTriangleWrap->memlimit = m_memLimit;
+}
+
+
+void Delaunay::setReservedMeshSize()
+{
+   Triwrap::__pbehavior* tpbehavior = TP_BEHAVIOR_PTR();
+
+   // a Delaunay triangulation has about 2 triangles per vertex
+   double points = (double)m_pointList.size();
+   double triangles = 2.0 * points;
+   double subsegs = (double)m_segmentList.size() / 2;
+
+   if (tpbehavior->quality)
+   {
+      // measured growth of the triangle count for random points, by min. angle (Steiner points are 
+      // added until all triangles are good enough, beyond ~34 degrees refinement may not terminate)
+      const double angleGrowth[][2] = { { 0.0, 1.0 }, { 20.0, 1.6 }, { 25.0, 2.05 }, { 30.0, 2.85 }, { 33.0, 3.85 }, { 35.0, 5.0 } };
+      const size_t angleSteps = sizeof(angleGrowth) / sizeof(angleGrowth[0]);
+
+      double angle = std::min(std::max(tpbehavior->minangle, 0.0), angleGrowth[angleSteps - 1][0]);
+      size_t i = 1;
+
+      while (i < angleSteps - 1 && angleGrowth[i][0] < angle)
+      {
+         ++i;
+      }
+
+      double t = (angle - angleGrowth[i - 1][0]) / (angleGrowth[i][0] - angleGrowth[i - 1][0]);
+      triangles *= angleGrowth[i - 1][1] + t * (angleGrowth[i][1] - angleGrowth[i - 1][1]);
+
+      // area constraint: about 1.6 triangles per max. area, measured with the bounding box. Both constraints
+      // add triangles where the other one doesn't, hence the (generous) geometric sum.
+      if (tpbehavior->fixedarea && tpbehavior->maxarea > 0 && !m_pointList.empty())
+      {
+         auto xRange = std::minmax_element(m_pointList.begin(), m_pointList.end(),
+                                           [](const Point& a, const Point& b) { return a[0] < b[0]; });
+         auto yRange = std::minmax_element(m_pointList.begin(), m_pointList.end(),
+                                           [](const Point& a, const Point& b) { return a[1] < b[1]; });
+
+         double area = ((*xRange.second)[0] - (*xRange.first)[0]) * ((*yRange.second)[1] - (*yRange.first)[1]);
+         triangles = std::hypot(triangles, 1.6 * area / tpbehavior->maxarea);
+      }
+
+      // segments (and the convex hull) are split along with the triangles
+      subsegs = 2.0 * subsegs + 4.0 * std::sqrt(triangles);
+   }
+
+   // each vertex has about 2 triangles
+   double vertices = std::max(points, triangles / 2.0);
+
+   auto reserved = [](size_t count, double estimate) 
+   {
+      double value = (count > 0) ? (double)count : estimate;
+      // TriLib's block sizes are int byte counts!
+      return (int)std::min(value, (double)(std::numeric_limits<int>::max() / 128));
+   };
+
+   tpbehavior->reservevertices = reserved(m_reservedVertices, vertices);
+   tpbehavior->reservetriangles = reserved(m_reservedTriangles, triangles);
+   tpbehavior->reservesubsegs = reserved(m_reservedSubsegs, subsegs);
+}
+
+
 void Delaunay::initTriangleInputData(triangulateio* pin, const std::vector<Point>& points) /*const*/
 {
     pin->numberofpoints = (int)points.size();
-    pin->numberofpointattributes = m_extraVertexAttr ? 1 : 0;
+    pin->numberofpointattributes = 0;
     pin->pointlist = static_cast<double*>((void*)(&points[0]));
-
-    if (m_extraVertexAttr)
-    {       
-       m_defaultExtraAttrs.clear();
-       m_defaultExtraAttrs.insert(m_defaultExtraAttrs.begin(), points.size(), -1.0);
-
-       pin->pointattributelist = static_cast<double*>((void*)(&m_defaultExtraAttrs[0]));
-    }
-    else
-    {
-       pin->pointattributelist = nullptr;
-    }
-    
+    pin->pointattributelist = nullptr;
     pin->pointmarkerlist = nullptr;
     pin->numberofsegments = 0;
     pin->numberofholes = 0;
@@ -1404,67 +3181,114 @@ void Delaunay::readSegmentsFromMesh(std::vector<int>& segmentEndpoints) const
 
 
 void Delaunay::readHolesFromFile(
-        char* polyfileName, 
-        FILE* polyfile,
+        TextFileParser& polyfile,
         std::vector<Point>& holeMarkers, 
         std::vector<Point4>& regionConstr) const
 {
    TP_MESH_BEHAVIOR_WRAP();
 
-   REAL* holearray = nullptr;
-   REAL* regionarray = nullptr;
+   const char* polyfileName = polyfile.fileName().c_str();
 
    holeMarkers.clear();
+   regionConstr.clear();
 
-   // read also the regions!
-   int regionattrib = tpbehavior->regionattrib;
-   tpbehavior->regionattrib = 1;   
-   int regionCt = -1;
+   tpmesh->holes = 0;
+   tpmesh->regions = 0;
 
-   try
+   auto unexpectedEnd = [&]()
+   {
+      printf("  Error:  Unexpected end of file in %s.\n", polyfileName);
+      pTriangleWrap->triexit(1);
+   };
+
+   // maybe no holes in file ???
+   const char* stringptr = polyfile.nextRecord();
+   if (!stringptr)
    {
-      pTriangleWrap->readholes(tpmesh, tpbehavior, polyfile, polyfileName,
-                               &holearray, &tpmesh->holes, &regionarray, &regionCt);
-      tpmesh->regions = regionCt;
+      return;
    }
-   catch (...)
-   {     
-      // maybe no regions in file ???
-      if (regionCt == -1)
+
+   int holes = (int)polyfile.readInt(stringptr);
+
+   for (int i = 0; i < holes; i++)
+   {
+      double coords[2];
+
+      stringptr = polyfile.nextRecord();
+      if (!stringptr)
       {
-         tpmesh->regions = 0;
+         unexpectedEnd();
       }
-      else
+
+      for (int j = 0; j < 2; j++)
       {
-         // real parsing problem
-         throw;
-      }      
+         stringptr = TextFileParser::findField(stringptr);
+         if (TextFileParser::endOfRecord(stringptr))
+         {
+            printf("Error:  Hole %d has no %c coordinate.\n", tpbehavior->firstnumber + i, j == 0 ? 'x' : 'y');
+            pTriangleWrap->triexit(1);
+         }
+         coords[j] = polyfile.readReal(stringptr);
+      }
+
+      holeMarkers.emplace_back(coords[0], coords[1]);
    }
 
-   tpbehavior->regionattrib = regionattrib;
+   tpmesh->holes = holes > 0 ? holes : 0;
 
-   for (int i = 0; i < 2 * tpmesh->holes; i += 2)
+   // read also the regions, maybe there are none in file ???
+   if (tpbehavior->refine)
    {
-      holeMarkers.emplace_back(holearray[i], holearray[i + 1]);
+      return;
    }
 
-   if (tpmesh->holes > 0)
+   stringptr = polyfile.nextRecord();
+   if (!stringptr)
    {
-      pTriangleWrap->trifree((VOID*)holearray);
+      return;
    }
 
-   regionConstr.clear();
+   int regions = (int)polyfile.readInt(stringptr);
 
-   for (int i = 0; i < 4 * tpmesh->regions; i += 4)
+   for (int i = 0; i < regions; i++)
    {
-      double arr[] = { regionarray[i], regionarray[i + 1], regionarray[i + 2],  regionarray[i + 3] };
+      double arr[4];
+
+      stringptr = polyfile.nextRecord();
+      if (!stringptr)
+      {
+         unexpectedEnd();
+      }
+
+      for (int j = 0; j < 4; j++)
+      {
+         stringptr = TextFileParser::findField(stringptr);
+         if (TextFileParser::endOfRecord(stringptr))
+         {
+            if (j == 3)
+            {
+               // the attribute is also the area constraint
+               arr[3] = arr[2];
+               break;
+            }
+
+            if (j < 2)
+            {
+               printf("Error:  Region %d has no %c coordinate.\n", tpbehavior->firstnumber + i, j == 0 ? 'x' : 'y');
+            }
+            else
+            {
+               printf("Error:  Region %d has no region attribute or area constraint.\n", tpbehavior->firstnumber + i);
+            }
+            pTriangleWrap->triexit(1);
+         }
+         arr[j] = polyfile.readReal(stringptr);
+      }
+
       regionConstr.emplace_back(arr);
    }
 
-   if (tpmesh->regions > 0)
-   {
-      pTriangleWrap->trifree((VOID*)regionarray);
-   }
+   tpmesh->regions = regions > 0 ? regions : 0;
 }
 
 
@@ -1488,76 +3312,219 @@ std::unordered_map<int, int> Delaunay::checkForDuplicatePoints() const
         }
     }
 
-    return duplicateMap;    
+    return duplicateMap;    
+}
+
+
+void Delaunay::readNodesFromFile(TextFileParser& infile)
+{
+    TRACE(" -> readNodesFromFile()");
+
+    TP_MESH_BEHAVIOR_WRAP();
+
+    TextFileParser* nodefile = &infile;
+    std::unique_ptr<TextFileParser> separateNodefile;
+    int nodemarkers = 0;
+
+    auto unexpectedEnd = [&]()
+    {
+        printf("  Error:  Unexpected end of file in %s.\n", nodefile->fileName().c_str());
+        pTriangleWrap->triexit(1);
+    };
+
+    // Read number of vertices, number of dimensions, number of vertex 
+    // attributes, and number of boundary markers.
+    auto readHeader = [&]()
+    {
+        const char* stringptr = nodefile->nextRecord();
+        if (!stringptr)
+        {
+            unexpectedEnd();
+        }
+
+        tpmesh->invertices = (int)nodefile->readInt(stringptr);
+
+        stringptr = TextFileParser::findField(stringptr);
+        tpmesh->mesh_dim = TextFileParser::endOfRecord(stringptr) ? 2 : (int)nodefile->readInt(stringptr);
+
+        stringptr = TextFileParser::findField(stringptr);
+        tpmesh->nextras = TextFileParser::endOfRecord(stringptr) ? 0 : (int)nodefile->readInt(stringptr);
+
+        stringptr = TextFileParser::findField(stringptr);
+        nodemarkers = TextFileParser::endOfRecord(stringptr) ? 0 : (int)nodefile->readInt(stringptr);
+    };
+
+    readHeader();
+    int readnodefile = tpbehavior->poly ? 0 : 1;
+
+    if (tpbehavior->poly && tpmesh->invertices == 0)
+    {
+        // If the .poly file claims there are zero vertices, that means that 
+        // the vertices should be read from a separate .node file.
+        std::string nodefileName = infile.fileName();
+        size_t extension = nodefileName.rfind(".poly");
+
+        if (extension != std::string::npos && extension + 5 == nodefileName.size())
+        {
+            nodefileName.erase(extension);
+        }
+        nodefileName += ".node";
+
+        separateNodefile.reset(new TextFileParser(m_threadCount));
+        openTextFile(pTriangleWrap, tpbehavior->quiet, *separateNodefile, nodefileName);
+
+        nodefile = separateNodefile.get();
+        readHeader();
+        readnodefile = 1;
+    }
+
+    if (tpmesh->invertices < 3) 
+    {
+        printf("Error:  Input must have at least three input vertices.\n");
+        pTriangleWrap->triexit(1);
+    }
+    if (tpmesh->mesh_dim != 2) 
+    {
+        printf("Error:  Triangle only works with two-dimensional meshes.\n");
+        pTriangleWrap->triexit(1);
+    }
+    if (tpmesh->nextras < 0)
+    {
+        tpmesh->nextras = 0;
+    }
+
+    // Read the vertices in parallel.
+    size_t invertices = (size_t)tpmesh->invertices;
+    size_t nextras = (size_t)tpmesh->nextras;
+    size_t count = std::min(invertices, nodefile->remaining());
+
+    std::vector<double> pointlist(2 * invertices);
+    std::vector<double> pointattriblist(nextras * invertices);
+    std::vector<int> pointmarkerlist(invertices, 0); // markers default to zero
+
+    auto result = nodefile->parseRecords(count, [&](size_t i, const char* stringptr)
+    {
+        if (i == 0) 
+        {
+            long firstnode = nodefile->readInt(stringptr);
+            if ((firstnode == 0) || (firstnode == 1)) 
+            {
+                tpbehavior->firstnumber = (int)firstnode;
+            }
+        }
+
+        for (size_t j = 0; j < 2; j++)
+        {
+            stringptr = TextFileParser::findField(stringptr);
+            if (TextFileParser::endOfRecord(stringptr))
+            {
+                return (int)j + 1; // no x resp. y coordinate
+            }
+            pointlist[2 * i + j] = nodefile->readReal(stringptr);
+        }
+
+        // Read the vertex attributes.
+        for (size_t j = 0; j < nextras; j++)
+        {
+            stringptr = TextFileParser::findField(stringptr);
+            pointattriblist[nextras * i + j] = 
+                TextFileParser::endOfRecord(stringptr) ? 0.0 : nodefile->readReal(stringptr);
+        }
+
+        if (nodemarkers) 
+        {
+            // Read a vertex marker.
+            stringptr = TextFileParser::findField(stringptr);
+            if (!TextFileParser::endOfRecord(stringptr))
+            {
+                pointmarkerlist[i] = (int)nodefile->readInt(stringptr);
+            }
+        }
+        return 0;
+    });
+
+    if (result.failed < count)
+    {
+        printf("Error:  Vertex %d has no %c coordinate.\n", 
+               tpbehavior->firstnumber + (int)result.failed, result.error == 1 ? 'x' : 'y');
+        pTriangleWrap->triexit(1);
+    }
+    if (count < invertices)
+    {
+        unexpectedEnd();
+    }
+
+    pTriangleWrap->transfernodes(tpmesh, tpbehavior, pointlist.data(), pointattriblist.data(), pointmarkerlist.data(),
+                                 tpmesh->invertices, tpmesh->nextras);
+    tpmesh->readnodefile = readnodefile;
 }
 
 
-bool Delaunay::readSegmentsFromFile(char* polyfileName, FILE* polyfile, std::vector<int>& segmentEndpoints)
+bool Delaunay::readSegmentsFromFile(TextFileParser& polyfile, std::vector<int>& segmentEndpoints)
 {
     TRACE(" -> readSegmentsFromFile()");
 
-    char inputline[INPUTLINESIZE];
-    char* stringptr;
-    int segmentmarkers;
-    int end1, end2;
-    int boundmarker;
-    int i;
-
     TP_MESH_BEHAVIOR_WRAP();
 
-    stringptr = pTriangleWrap->readline(inputline, polyfile, polyfileName);
-    int insegments = (int)strtol(stringptr, &stringptr, 0);
+    const char* polyfileName = polyfile.fileName().c_str();
 
-    stringptr = pTriangleWrap->findfield(stringptr);
-    segmentmarkers = (*stringptr == '\0') 
-                        ? 0 : (int)strtol(stringptr, &stringptr, 0);
-    boundmarker = 0;
+    const char* stringptr = polyfile.nextRecord();
+    if (!stringptr)
+    {
+        printf("  Error:  Unexpected end of file in %s.\n", polyfileName);
+        pTriangleWrap->triexit(1);
+    }
 
-    // Read and insert the segments.
-    segmentEndpoints.clear();
-    segmentEndpoints.reserve(tpmesh->insegments * 2);
+    int insegments = (int)polyfile.readInt(stringptr);
+    // the segment markers are not used
 
-    for (i = 0; i < /*m->*/insegments; i++)
+    // Read the segments in parallel, check them in file order.
+    size_t count = std::min((size_t)std::max(insegments, 0), polyfile.remaining());
+    std::vector<int> endpoints(2 * count);
+
+    auto result = polyfile.parseRecords(count, [&](size_t i, const char* stringptr)
     {
-        stringptr = pTriangleWrap->readline(inputline, polyfile, polyfileName);
-        stringptr = pTriangleWrap->findfield(stringptr);
-        if (*stringptr == '\0') 
-        {
-            printf("Error:  Segment %d has no endpoints in %s.\n", 
-                   tpbehavior->firstnumber + i, polyfileName);
-            return false; 
-        }
-        else 
+        for (size_t j = 0; j < 2; j++)
         {
-            end1 = (int)strtol(stringptr, &stringptr, 0);
+            stringptr = TextFileParser::findField(stringptr);
+            if (TextFileParser::endOfRecord(stringptr))
+            {
+                return (int)j + 1; // no first resp. second endpoint
+            }
+            endpoints[2 * i + j] = (int)polyfile.readInt(stringptr);
         }
-        
-        stringptr = pTriangleWrap->findfield(stringptr);
-        if (*stringptr == '\0') 
+        return 0;
+    });
+
+    segmentEndpoints.clear();
+    segmentEndpoints.reserve(2 * count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int segmentNumber = tpbehavior->firstnumber + (int)i;
+
+        if (i == result.failed)
         {
-            printf("Error:  Segment %d is missing its second endpoint in %s.\n", 
-                   tpbehavior->firstnumber + i, polyfileName);
+            if (result.error == 1)
+            {
+                printf("Error:  Segment %d has no endpoints in %s.\n", segmentNumber, polyfileName);
+            }
+            else
+            {
+                printf("Error:  Segment %d is missing its second endpoint in %s.\n", segmentNumber, polyfileName);
+            }
             return false;
         }
-        else 
-        {
-            end2 = (int)strtol(stringptr, &stringptr, 0);
-        }
 
-        if (segmentmarkers) 
-        {
-            stringptr = pTriangleWrap->findfield(stringptr);
-            boundmarker = (*stringptr == '\0')
-                             ? 0 : (int)strtol(stringptr, &stringptr, 0);
-        }
+        int end1 = endpoints[2 * i];
+        int end2 = endpoints[2 * i + 1];
 
         if ((end1 < tpbehavior->firstnumber) ||
             (end1 >= tpbehavior->firstnumber + tpmesh->invertices)) 
         {
             if (!tpbehavior->quiet) 
             {
-                printf("Warning:  Invalid first endpoint of segment %d in %s.\n",
-                       tpbehavior->firstnumber + i, polyfileName);
+                printf("Warning:  Invalid first endpoint of segment %d in %s.\n", segmentNumber, polyfileName);
             }
         }
         else if ((end2 < tpbehavior->firstnumber) ||
@@ -1565,35 +3532,23 @@ bool Delaunay::readSegmentsFromFile(char* polyfileName, FILE* polyfile, std::vec
         {
             if (!tpbehavior->quiet) 
             {
-                printf("Warning:  Invalid second endpoint of segment %d in %s.\n",
-                       tpbehavior->firstnumber + i, polyfileName);
+                printf("Warning:  Invalid second endpoint of segment %d in %s.\n", segmentNumber, polyfileName);
             }
         }
         else 
         {
-            // OPEN TODO:::  one last check? ????
-#if 0
-            /* Find the vertices numbered `end1' and `end2'. */
-            Triwrap::vertex endpoint1 = pTriangleWrap->getvertex(m, b, end1);
-            Triwrap::vertex endpoint2 = pTriangleWrap->getvertex(m, b, end2);
-            if ((endpoint1[0] == endpoint2[0]) && (endpoint1[1] == endpoint2[1])) 
-            {
-                if (!tpbehavior->quiet) 
-                {
-                    printf("Warning:  Endpoints of segment %d are coincident in %s.\n",
-                           b->firstnumber + i, polyfilename);
-                }
-            }
-            else 
-            {
-                insertsegment(m, b, endpoint1, endpoint2, boundmarker);
-            }
-#endif
+            // OPEN TODO::: check for coincident endpoints as TriLib's formskeleton() does? ????
             segmentEndpoints.push_back(end1);
             segmentEndpoints.push_back(end2);
         }
     }
 
+    if (count < (size_t)std::max(insegments, 0))
+    {
+        printf("  Error:  Unexpected end of file in %s.\n", polyfileName);
+        pTriangleWrap->triexit(1);
+    }
+
     return true;
 }
 
@@ -1629,8 +3584,7 @@ typedef Triwrap::__otriangle trianglelooptype; // i.e. oriented triangle
 ///////////////////////////////
 
 FaceIterator::FaceIterator(Delaunay* triangulator)
-   : m_delaunay(triangulator),
-     meshPointCount(0)
+   : m_delaunay(triangulator)
 {
    floop.tri = nullptr;
 
@@ -1733,7 +3687,7 @@ int FaceIterator::Apex(Delaunay::Point* point) const
 
 void FaceIterator::Org(Delaunay::Point& point, int& meshIndex) const
 {
-   Assert(m_delaunay->m_extraVertexAttr, "");
+   Assert(m_delaunay->m_meshIndexing, "");
 
    vertex vertexptr = nullptr;
    org(*TP_PLOOP_PTR((*this)), vertexptr);
@@ -1745,7 +3699,7 @@ void FaceIterator::Org(Delaunay::Point& point, int& meshIndex) const
 
 void FaceIterator::Dest(Delaunay::Point& point, int& meshIndex) const
 {
-   Assert(m_delaunay->m_extraVertexAttr, "");
+   Assert(m_delaunay->m_meshIndexing, "");
 
    vertex vertexptr = nullptr;
    dest(*TP_PLOOP_PTR((*this)), vertexptr);
@@ -1757,7 +3711,7 @@ void FaceIterator::Dest(Delaunay::Point& point, int& meshIndex) const
 
 void FaceIterator::Apex(Delaunay::Point& point, int& meshIndex) const
 {
-   Assert(m_delaunay->m_extraVertexAttr, "");
+   Assert(m_delaunay->m_meshIndexing, "");
 
    vertex vertexptr = nullptr;
    apex(*TP_PLOOP_PTR((*this)), vertexptr);
@@ -1803,34 +3757,20 @@ int FaceIterator::getVertexIndex(/*Triwrap::vertex*/ double* vertexptr) const
 
 int FaceIterator::getMeshVertexIndex(/*Triwrap::vertex*/ double* vertexptr) const
 {
-   if (!m_delaunay->m_extraVertexAttr)
+   if (!m_delaunay->m_meshIndexing)
    {
       std::cerr << "ERROR: Mesh indexing not enabled!\n";
       throw std::runtime_error("Mesh indexing not enabled");
    }
 
-   Assert(meshPointCount >= 0, "");
-
-   if (getVertexIndex(vertexptr) >= 0)
-   {
-      // extra attr. initialized to -1!
-      if ((vertexptr)[2] < 0)
-      {
-         (vertexptr)[2] = meshPointCount++;
-      }
-   }
-   else
-   {
-      // extra attr. initialized to -1!
-      if ((vertexptr)[2] < 0)
-      {
-         Assert((vertexptr)[2] == -1.00, "");
+   TP_MESH_ITER();
+   TP_BEHAVIOR_ITER();
 
-         (vertexptr)[2] = meshPointCount++;
-      }
-   }
+   // numbered by numberMeshVertices()
+   int vertexNumber = ((int*)(vertexptr))[tpmesh->vertexmarkindex] - tpbehavior->firstnumber;
+   Assert((unsigned)vertexNumber < m_delaunay->m_meshVertexIndex.size(), "Mesh indexes not numbered!");
 
-   int idx = (vertexptr)[2];  // OPEN TODO:: warning !!!
+   int idx = m_delaunay->m_meshVertexIndex[vertexNumber];
    Assert(idx >= 0, "");
 
    return idx;
@@ -1855,6 +3795,59 @@ bool operator<(FaceIterator const& fit1, FaceIterator const& fit2)
 }
 
 
+FaceRange::FaceRange(Delaunay* triangulator, void* firstItem, int itemCount, int itemBytes)
+   : m_delaunay(triangulator),
+     m_first((char*)firstItem),
+     m_end((char*)firstItem + (size_t)itemCount * itemBytes),
+     m_itemBytes(itemBytes)
+{}
+
+
+FaceRange::iterator FaceRange::begin() const
+{
+   return iterator(m_delaunay, m_first, m_end, m_itemBytes);
+}
+
+
+FaceRange::iterator FaceRange::end() const
+{
+   return iterator(m_delaunay, m_end, m_end, m_itemBytes);
+}
+
+
+FaceRange::iterator::iterator(Delaunay* triangulator, char* item, char* end, int itemBytes)
+   : m_item(item),
+     m_end(end),
+     m_itemBytes(itemBytes)
+{
+   m_face.m_delaunay = triangulator;
+   m_face.floop.orient = 0;
+
+   skipDeadItems();
+}
+
+
+FaceRange::iterator& FaceRange::iterator::operator++()
+{
+   m_item += m_itemBytes;
+   skipDeadItems();
+
+   return *this;
+}
+
+
+void FaceRange::iterator::skipDeadItems()
+{
+   // as in TriLib's triangletraverse()
+   while (m_item != m_end && deadtri((triangle*)m_item))
+   {
+      m_item += m_itemBytes;
+   }
+
+   m_face.floop.tri = (m_item != m_end) ? (double***)m_item : nullptr;
+}
+
+
 ///////////////////////////////
 //
 //  Vertex Iterator impl.
@@ -1947,6 +3940,61 @@ bool operator!=(VertexIterator const& vit1, VertexIterator const& vit2)
 }
 
 
+VertexRange::VertexRange(Delaunay* triangulator, void* firstItem, int itemCount, int itemBytes, int typeIndex)
+   : m_delaunay(triangulator),
+     m_first((char*)firstItem),
+     m_end((char*)firstItem + (size_t)itemCount * itemBytes),
+     m_itemBytes(itemBytes),
+     m_typeIndex(typeIndex)
+{}
+
+
+VertexRange::iterator VertexRange::begin() const
+{
+   return iterator(m_delaunay, m_first, m_end, m_itemBytes, m_typeIndex);
+}
+
+
+VertexRange::iterator VertexRange::end() const
+{
+   return iterator(m_delaunay, m_end, m_end, m_itemBytes, m_typeIndex);
+}
+
+
+VertexRange::iterator::iterator(Delaunay* triangulator, char* item, char* end, int itemBytes, int typeIndex)
+   : m_item(item),
+     m_end(end),
+     m_itemBytes(itemBytes),
+     m_typeIndex(typeIndex)
+{
+   m_vertex.m_delaunay = triangulator;
+
+   skipDeadItems();
+}
+
+
+VertexRange::iterator& VertexRange::iterator::operator++()
+{
+   m_item += m_itemBytes;
+   skipDeadItems();
+
+   return *this;
+}
+
+
+void VertexRange::iterator::skipDeadItems()
+{
+   // dead as in TriLib's vertextraverse(), undead (i.e. duplicate) ones are skipped like in VertexIterator
+   while (m_item != m_end &&
+          (((int*)m_item)[m_typeIndex] == DEADVERTEX || ((int*)m_item)[m_typeIndex] == UNDEADVERTEX))
+   {
+      m_item += m_itemBytes;
+   }
+
+   m_vertex.vloop = (m_item != m_end) ? m_item : nullptr;
+}
+
+
 /////////////////////////////////
 //
 //  Voronoi Point Iterator impl.
@@ -2253,24 +4301,101 @@ FaceIterator TriangulationMesh::Sym(FaceIterator const& fit) const
 }
 
 
+int TriangulationMesh::triangleId(FaceIterator const& fit) const
+{
+   Assert(!m_delaunay->m_triangleTable.empty() || m_delaunay->triangleCount() == 0, "Triangle ids not enabled!");
+
+   if (fit.empty() || m_delaunay->m_triangleTable.empty())
+   {
+      return -1;
+   }
+
+   TP_MESH_PLOOP(fit);
+   Triwrap::__pmesh* m = tpmesh; // needed for Triwrap's macros
+
+   return triangleid(*ploop); // -1 for the ghost triangle
+}
+
+
+FaceIterator TriangulationMesh::triangleAt(int id) const
+{
+   Assert((id >= 0) && ((size_t)id < m_delaunay->m_triangleTable.size()), "Triangle id out of bounds!");
+
+   FaceIterator retval;
+   retval.m_delaunay = m_delaunay;
+   retval.floop.tri = static_cast<double***>(m_delaunay->m_triangleTable[id]);
+   retval.floop.orient = 0;
+
+   return retval;
+}
+
+
+int TriangulationMesh::neighborId(int id, char i) const
+{
+   Assert((id >= 0) && ((size_t)id < m_delaunay->m_triangleTable.size()), "Triangle id out of bounds!");
+
+   TP_MESH_ITER();
+   Triwrap::__pmesh* m = tpmesh; // needed for Triwrap's macros
+
+   trianglelooptype tri;
+   trianglelooptype top;
+   triangle ptr;  // Temporary variable used by sym() macro! 
+
+   tri.tri = static_cast<triangle*>(m_delaunay->m_triangleTable[id]);
+   tri.orient = i;
+   sym(tri, top);
+
+   return triangleid(top); // -1 for the dummy triangle
+}
+
+
 FaceIterator TriangulationMesh::locate(int vertexid)
 {
    FaceIterator retval;
    retval.m_delaunay = this->m_delaunay;
 
+   // O(1), the links are made by mapVertices() on the first call after a triangulation or update, 
+   // once, even if several threads query the mesh
+   if (!m_delaunay->m_vertexMapReady.load(std::memory_order_acquire))
+   {
+      std::lock_guard<std::mutex> lock(m_delaunay->m_vertexMapMutex);
+
+      if (!m_delaunay->m_vertexMapReady.load(std::memory_order_relaxed))
+      {
+         m_delaunay->mapVertices();
+         m_delaunay->m_vertexMapReady.store(true, std::memory_order_release);
+      }
+   }
+
+   Assert((unsigned)vertexid < m_delaunay->m_vertexTable.size(), "Vertex id out of bounds!");
+
    TP_MESH_WRAP_ITER();
    TP_BEHAVIOR_ITER();
 
    trianglelooptype horiz;  // temp. variables for locate() & sym() macros!
    triangle ptr;
 
+   vertex vertexptr = (vertex)m_delaunay->m_vertexTable[vertexid];
+   ptr = (triangle)m_delaunay->m_vertexTriangles[vertexid];
+
+   if (ptr != nullptr)
+   {
+      decode(ptr, horiz);
+
+      retval.floop.tri = horiz.tri;
+      retval.floop.orient = horiz.orient;
+
+      return retval;
+   }
+
+   // a vertex in no triangle (i.e. a duplicate point), search for the triangle of its twin
    horiz.tri = tpmesh->dummytri;
    horiz.orient = 0;
    symself(horiz);
 
    double dv[2];
-   dv[0] = m_delaunay->m_pointList[vertexid][0];
-   dv[1] = m_delaunay->m_pointList[vertexid][1];
+   dv[0] = vertexptr[0];
+   dv[1] = vertexptr[1];
 
    // Search for a triangle containing `newvertex'
    int intersect = pTriangleWrap->locate(tpmesh, tpbehavior, dv, &horiz);
@@ -2290,6 +4415,56 @@ FaceIterator TriangulationMesh::locate(int vertexid)
 }
 
 
+void TriangulationMesh::locatePoints(const std::vector<Delaunay::Point>& points, std::vector<LocateResult>& results)
+{
+   results.clear();
+   results.resize(points.size());
+
+   if (points.empty())
+   {
+      return;
+   }
+
+   TP_MESH_WRAP_ITER();
+   TP_BEHAVIOR_ITER();
+
+   std::vector<double> coords(2 * points.size());
+   for (size_t i = 0; i < points.size(); ++i)
+   {
+      coords[2 * i] = points[i][0];
+      coords[2 * i + 1] = points[i][1];
+   }
+
+   std::vector<Triwrap::locateresult> locations(points.size());
+   std::vector<Triwrap::__otriangle> tris(points.size());
+
+   int threads = (m_delaunay->m_threadCount > 0) ? (int)m_delaunay->m_threadCount : (int)WorkStealingPool::defaultThreadCount();
+
+   pTriangleWrap->locatebatch(tpmesh, tpbehavior, coords.data(), (int)points.size(), locations.data(), tris.data(), threads);
+
+   for (size_t i = 0; i < points.size(); ++i)
+   {
+      LocateResult& result = results[i];
+
+      switch (locations[i])
+      {
+      case Triwrap::INTRIANGLE: result.location = LocateResult::InTriangle; break;
+      case Triwrap::ONEDGE: result.location = LocateResult::OnEdge; break;
+      case Triwrap::ONVERTEX: result.location = LocateResult::OnVertex; break;
+      default: result.location = LocateResult::Outside; break;
+      }
+
+      result.face.m_delaunay = m_delaunay;
+
+      if (tris[i].tri != tpmesh->dummytri)
+      {
+         result.face.floop.tri = tris[i].tri;
+         result.face.floop.orient = tris[i].orient;
+      }
+   }
+}
+
+
 FaceIterator TriangulationMesh::Lnext(FaceIterator const& fit)
 {
    FaceIterator retval;
@@ -2342,11 +4517,31 @@ FaceIterator TriangulationMesh::Oprev(FaceIterator const& fit)
 
 void TriangulationMesh::trianglesAroundVertex(int vertexid, std::vector<int>& ivv)
 {
+   TP_MESH_ITER();
+   TP_BEHAVIOR_ITER();
+   Triwrap::__pmesh* m = tpmesh; // needed for Triwrap's macros
+
+   // vertex numbers, unlike FaceIterator::Org() etc. also for the Steiner points
+   auto corners = [m, tpbehavior](FaceIterator const& fit, int& a, int& b, int& c)
+   {
+      vertex vertexptr = nullptr;
+
+      org(*TP_PLOOP_PTR(fit), vertexptr);
+      a = vertexmark(vertexptr) - tpbehavior->firstnumber;
+      dest(*TP_PLOOP_PTR(fit), vertexptr);
+      b = vertexmark(vertexptr) - tpbehavior->firstnumber;
+      apex(*TP_PLOOP_PTR(fit), vertexptr);
+      c = vertexmark(vertexptr) - tpbehavior->firstnumber;
+   };
+
    FaceIterator fit = locate(vertexid);
    ivv.clear();
 
-   int start = fit.Dest();
-   int linkn = fit.Apex();
+   int a, b, c;
+   corners(fit, a, b, c);
+
+   int start = b;
+   int linkn = c;
 
    ivv.push_back(vertexid);
    ivv.push_back(start);
@@ -2367,8 +4562,9 @@ void TriangulationMesh::trianglesAroundVertex(int vertexid, std::vector<int>& iv
          fit = pnfit;
          nfit = fit;
 
-         start = fit.Apex();
-         linkn = fit.Dest();
+         corners(fit, a, b, c);
+         start = c;
+         linkn = b;
 
          ivv.push_back(vertexid);
          ivv.push_back(linkn);
@@ -2379,13 +4575,11 @@ void TriangulationMesh::trianglesAroundVertex(int vertexid, std::vector<int>& iv
             nfit = Oprev(nfit);
             if (nfit.isGhost())
                return;
-            int a = nfit.Org();
-            int b = nfit.Dest();
-            int c = nfit.Apex();
+            corners(nfit, a, b, c);
             ivv.push_back(a);
             ivv.push_back(b);
             ivv.push_back(c);
-            linkn = nfit.Dest();
+            linkn = b;
          }
 
          return;
@@ -2393,9 +4587,7 @@ void TriangulationMesh::trianglesAroundVertex(int vertexid, std::vector<int>& iv
 
       pnfit = nfit;
 
-      int a = nfit.Org();
-      int b = nfit.Dest();
-      int c = nfit.Apex();
+      corners(nfit, a, b, c);
 
       //cout << "Triangle: " << a << "\t"  << b << "\t"  << c << "\n";
 
@@ -2403,8 +4595,132 @@ void TriangulationMesh::trianglesAroundVertex(int vertexid, std::vector<int>& iv
       ivv.push_back(b);
       ivv.push_back(c);
 
-      linkn = nfit.Apex();
+      linkn = c;
+   }
+}
+
+
+// batch triangulation
+
+namespace {
+
+   void runTriangulationJob(Delaunay& triangulator, TriangulationJob& job)
+   {
+      triangulator.setPoints(job.points);
+
+      if (!job.segments.empty() && !triangulator.setSegmentConstraint(job.segments))
+      {
+         job.error = "Invalid segment endpoint index";
+         return;
+      }
+
+      triangulator.setHolesConstraint(job.holes);
+      triangulator.useConvexHullWithSegments(job.convexHullWithSegments);
+      triangulator.setQualityConstraints(job.minAngle, job.maxArea);
+      triangulator.Triangulate(job.quality);
+
+      if (!triangulator.exportMesh(job.mesh))
+      {
+         job.error = "No triangulation created";
+         return;
+      }
+
+      job.succeeded = true;
+   }
+}
+
+
+void triangulateBatch(std::vector<TriangulationJob>& jobs, unsigned threadCount)
+{
+   if (jobs.empty())
+   {
+      return;
+   }
+
+   size_t threads = (threadCount > 0) ? threadCount : WorkStealingPool::defaultThreadCount();
+   threads = std::min(threads, jobs.size());
+
+   std::atomic<size_t> nextJob(0);
+
+   auto worker = [&jobs, &nextJob]()
+   {
+      // one triangulator per thread, reusing its memory pools for all jobs of the thread
+      std::unique_ptr<Delaunay> triangulator;
+
+      for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+      {
+         TriangulationJob& job = jobs[i];
+         job.succeeded = false;
+         job.error.clear();
+
+         if (!triangulator)
+         {
+            triangulator.reset(new Delaunay);
+            triangulator->enableMemoryPoolReuse();
+         }
+
+         try
+         {
+            runTriangulationJob(*triangulator, job);
+         }
+         catch (const std::exception& e)
+         {
+            job.error = e.what();
+            triangulator.reset(); // don't reuse the pools of an aborted triangulation
+         }
+         catch (...)
+         {
+            job.error = "Unknown error";
+            triangulator.reset(); // dito
+         }
+      }
+   };
+
+   if (threads <= 1)
+   {
+      worker();
+      return;
+   }
+
+   // the calling thread works too
+   WorkStealingPool pool((unsigned)threads - 1);
+   TaskGroup group(pool);
+
+   for (size_t t = 1; t < threads; ++t)
+   {
+      group.run(worker);
+   }
+
+   worker();
+   group.wait();
+}
+
+
+void parallelFor(size_t count, const std::function<void(size_t)>& work, unsigned threadCount)
+{
+   size_t threads = (threadCount > 0) ? threadCount : WorkStealingPool::defaultThreadCount();
+   threads = std::min(threads, count);
+
+   if (threads <= 1)
+   {
+      for (size_t i = 0; i < count; ++i)
+      {
+         work(i);
+      }
+      return;
+   }
+
+   // the calling thread works too
+   WorkStealingPool pool((unsigned)threads - 1);
+   TaskGroup group(pool);
+
+   for (size_t i = 1; i < count; ++i)
+   {
+      group.run([&work, i]() { work(i); });
    }
+
+   work(0);
+   group.wait();
 }
 
 
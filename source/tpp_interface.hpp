@@ -39,6 +39,31 @@
        29/09/23: mrkkrj - first support for regions and regional constraints
        24/10/23: mrkkrj - support for DLL builds
        16/03/26: mrkkrj - added foreach() iteration over Voronoi results
+       17/10/26: mrkkrj - multi-threaded divide-and-conquer triangulation (setThreadCount())
+       17/10/26: mrkkrj - batched SSE2 filters for the orientation and incircle predicates
+       17/10/26: mrkkrj - biased randomized, Hilbert-sorted insertion order for the incremental algorithm
+       17/10/26: mrkkrj - radix sort and keyed alternating cuts for big divide-and-conquer inputs
+       17/10/26: mrkkrj - in-place insertPoints()/removePoints() for existing triangulations
+       17/10/26: mrkkrj - reuse of the memory pools across repeated triangulations (enableMemoryPoolReuse())
+       17/10/26: mrkkrj - pluggable std::pmr memory resource and memory limit for TriLib's allocations
+       17/10/26: mrkkrj - reserve() pre-sizes the memory pools from given or estimated mesh sizes
+       17/10/26: mrkkrj - exportMesh() into flat arrays (MeshBuffers)
+       17/10/26: mrkkrj - batched, multi-threaded point location (TriangulationMesh::locatePoints())
+       17/10/26: mrkkrj - thread-safe Delaunay instances (per-thread traces and asserts), setPoints(), triangulateBatch()
+       17/10/26: mrkkrj - setTileSize() for the tiling of multi-threaded triangulations
+       17/10/26: mrkkrj - streaming triangulation of .node files, emitting finished triangles (triangulateStream())
+       17/10/26: mrkkrj - versioned binary file format for points, constraints and meshes, memory-mapped on reading (saveBinary(), readBinary())
+       17/10/26: mrkkrj - block-reading, multi-threaded parser for .node and .poly files (from_chars instead of fgets/strtod)
+       17/10/26: mrkkrj - parallel quality refinement, inserting Steiner points with independent cavities concurrently
+       17/10/26: mrkkrj - progress callbacks, time and Steiner point budgets, cooperative cancellation (setRunControl())
+       17/10/26: mrkkrj - user tests for the quality refinement, e.g. sizing functions (setUserConstraint())
+       17/10/26: mrkkrj - background sizing fields (grid or function) for graded quality meshes (setSizingField())
+       17/10/26: mrkkrj - selectable predicate precision (setPredicateMode()), counters of the exact predicate paths
+       17/10/26: mrkkrj - dense triangle ids, O(1) triangleAt() and integer neighbor queries (enableTriangleIds())
+       17/10/26: mrkkrj - mesh indexes numbered once after the triangulation, no extra vertex attribute, const iteration
+       17/10/26: mrkkrj - block ranges over faces and vertices (FacesList::ranges()), parallelForFaces() and parallelForVertices()
+       17/10/26: mrkkrj - adjacency export in CSR format (exportAdjacency())
+       17/10/26: mrkkrj - O(1) TriangulationMesh::locate() and trianglesAroundVertex() by vertex-to-triangle links, also for Steiner points
  */
 
 #ifndef TRPP_INTERFACE
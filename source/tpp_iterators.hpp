@@ -14,6 +14,9 @@
  // OPEN TODO:: decouple Point class from Delaunay, then use forward declarations only!!!
 #include "tpp_delaunay.hpp" // for Delaunay::Point
 
+#include <vector>
+#include <functional>
+
 
 namespace tpp
 {
@@ -31,7 +34,7 @@ namespace tpp
       FaceIterator& operator++();
       FaceIterator operator++(int);
 
-      FaceIterator() : m_delaunay(nullptr), meshPointCount(0) { floop.tri = nullptr; }
+      FaceIterator() : m_delaunay(nullptr) { floop.tri = nullptr; }
 
       bool empty() const;    // points to no triangle?  
       bool isdummy() const;  // deprecated!!!! --> pointing to a ghost triangle?
@@ -52,7 +55,8 @@ namespace tpp
          @brief: Get the origin point of the triangle (@see Org() above) and its *mesh index*
 
          @param point: the cordinates of the vertex
-         @param meshIndex: Index of the vertex in mesh (in order of iteration!)
+         @param meshIndex: Index of the vertex in mesh (numbered in the order of the face iteration, 
+                           @see Delaunay::enableMeshIndexGeneration())
        */
       void Org(Delaunay::Point& point, int& meshIndex) const;
       void Dest(Delaunay::Point& point, int& meshIndex) const;
@@ -107,14 +111,59 @@ namespace tpp
 
       Delaunay* m_delaunay;         
       poface floop;                // TriLib's internal data
-      mutable int meshPointCount;  // Used for numbering vertices in a complete triangulation   
 
       friend struct Face;
       friend class Delaunay;
       friend class TriangulationMesh;
+      friend class FaceRange;
    };
          
 
+   /**
+      @brief: The faces stored in one memory block of TriLib's triangle pool, @see FacesList::ranges()
+
+        A range doesn't use the traversal state of the pool, so that different ranges can be iterated 
+        in parallel. The faces are passed as FaceIterator objects, which must not be incremented.
+    */
+   class TRPP_LIB_EXPORT FaceRange
+   {
+   public:
+      class TRPP_LIB_EXPORT iterator
+      {
+      public:
+         iterator& operator++();
+         const FaceIterator& operator*() const { return m_face; }
+
+         bool operator==(iterator const& other) const { return m_item == other.m_item; }
+         bool operator!=(iterator const& other) const { return m_item != other.m_item; }
+
+      private:
+         iterator(Delaunay* triangulator, char* item, char* end, int itemBytes);
+         void skipDeadItems();
+
+         FaceIterator m_face;
+         char* m_item;
+         char* m_end;
+         int m_itemBytes;
+
+         friend class FaceRange;
+      };
+
+      iterator begin() const;
+      iterator end() const;
+
+   private:
+      FaceRange(Delaunay* triangulator, void* firstItem, int itemCount, int itemBytes);
+
+      Delaunay* m_delaunay;
+      char* m_first;
+      char* m_end;
+      int m_itemBytes;
+
+      friend struct FacesList;
+   };
+
+
    /**
       @brief: This class supports iteration over faces in a foreach() loop
     */
@@ -125,6 +174,13 @@ namespace tpp
       FaceIterator begin();
       FaceIterator end();
 
+      /**
+        @brief: Split the faces into ranges, one for each memory block (i.e. about 4000 faces)
+
+        @return: the ranges, empty if there's no triangulation
+       */
+      std::vector<FaceRange> ranges() const;
+
    private:
       Delaunay* m_delaunay;
    };
@@ -148,6 +204,7 @@ namespace tpp
       double y() const;
 
       friend class Delaunay;
+      friend class VertexRange;
       friend bool TRPP_LIB_EXPORT operator==(VertexIterator const&, VertexIterator const&);
       friend bool TRPP_LIB_EXPORT operator!=(VertexIterator const&, VertexIterator const&);
 
@@ -159,6 +216,53 @@ namespace tpp
    };
 
 
+   /**
+      @brief: The vertices stored in one memory block of TriLib's vertex pool, @see VertexList::ranges()
+
+        As FaceRange, for the vertices. The vertices are passed as VertexIterator objects, which must not 
+        be incremented.
+    */
+   class TRPP_LIB_EXPORT VertexRange
+   {
+   public:
+      class TRPP_LIB_EXPORT iterator
+      {
+      public:
+         iterator& operator++();
+         const VertexIterator& operator*() const { return m_vertex; }
+
+         bool operator==(iterator const& other) const { return m_item == other.m_item; }
+         bool operator!=(iterator const& other) const { return m_item != other.m_item; }
+
+      private:
+         iterator(Delaunay* triangulator, char* item, char* end, int itemBytes, int typeIndex);
+         void skipDeadItems();
+
+         VertexIterator m_vertex;
+         char* m_item;
+         char* m_end;
+         int m_itemBytes;
+         int m_typeIndex;
+
+         friend class VertexRange;
+      };
+
+      iterator begin() const;
+      iterator end() const;
+
+   private:
+      VertexRange(Delaunay* triangulator, void* firstItem, int itemCount, int itemBytes, int typeIndex);
+
+      Delaunay* m_delaunay;
+      char* m_first;
+      char* m_end;
+      int m_itemBytes;
+      int m_typeIndex;  // of TriLib's vertex type
+
+      friend struct VertexList;
+   };
+
+
    /**
       @brief: This class supports iteration over vertices in a foreach() loop
     */
@@ -182,6 +286,11 @@ namespace tpp
       VertexListIterator begin();
       VertexListIterator end();
 
+      /**
+        @brief: Split the vertices into ranges, one for each memory block, @see FacesList::ranges()
+       */
+      std::vector<VertexRange> ranges() const;
+
    private:
       Delaunay* m_delaunay;
    };
@@ -319,6 +428,59 @@ namespace tpp
       Delaunay* m_delaunay;
    };
 
+
+   /**
+      @brief: Run work(i) for all i in [0, count), distributed over a thread pool
+
+      @param threadCount: number of threads, 0 (default) for the number of hardware threads
+      @note: the first exception thrown by work() is rethrown after all calls are finished
+    */
+   void TRPP_LIB_EXPORT parallelFor(size_t count, const std::function<void(size_t)>& work, unsigned threadCount = 0);
+
+   /**
+      @brief: Call func(const FaceIterator&) for all faces, in parallel over the ranges of FacesList::ranges()
+
+        The faces are visited in no defined order and func must be thread-safe. Use it for the per face 
+        post-processing of big meshes, e.g.:
+
+          std::vector<double> areas(trGenerator.triangleCount());
+          TriangulationMesh mesh = trGenerator.mesh(); // with enableTriangleIds()
+
+          parallelForFaces(trGenerator, [&](const FaceIterator& f) { areas[mesh.triangleId(f)] = f.area(); });
+
+      @param threadCount: number of threads, 0 (default) for the number of hardware threads
+    */
+   template <class FaceFunc>
+   void parallelForFaces(Delaunay& delaunay, FaceFunc func, unsigned threadCount = 0)
+   {
+      std::vector<FaceRange> ranges = delaunay.faces().ranges();
+
+      parallelFor(ranges.size(), [&ranges, &func](size_t i)
+         {
+            for (const FaceIterator& face : ranges[i])
+            {
+               func(face);
+            }
+         }, threadCount);
+   }
+
+   /**
+      @brief: Call func(const VertexIterator&) for all vertices, in parallel, @see parallelForFaces()
+    */
+   template <class VertexFunc>
+   void parallelForVertices(Delaunay& delaunay, VertexFunc func, unsigned threadCount = 0)
+   {
+      std::vector<VertexRange> ranges = delaunay.vertices().ranges();
+
+      parallelFor(ranges.size(), [&ranges, &func](size_t i)
+         {
+            for (const VertexIterator& vertex : ranges[i])
+            {
+               func(vertex);
+            }
+         }, threadCount);
+   }
+
 } 
 
 #endif
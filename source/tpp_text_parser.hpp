@@ -0,0 +1,367 @@
+ /**
+    @file  tpp_text_parser.hpp
+
+    @brief  A fast reader for TriLib's text file formats (.node, .poly) used internally by the Triangle++ wrapper
+
+      The whole file is read in large blocks and split into chunks on line boundaries. The chunks are scanned
+      in parallel for the records, i.e. the lines TriLib's readline() would return, and the fields of the
+      records are then parsed in parallel with std::from_chars(). The fields are found as by TriLib's findfield()
+      and the numbers are converted as by strtol(.., 0) and strtod(), so that comments, firstnumber, attributes
+      and markers are handled exactly like in TriLib.
+
+    @author  Marek Krajewski (mrkkrj), www.ib-krajewski.de
+ */
+
+#ifndef TRPP_TEXT_PARSER
+#define TRPP_TEXT_PARSER
+
+#include "tpp_thread_pool.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <mutex>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace tpp
+{
+   /**
+      @brief: Records and fields of a text file in TriLib's formats
+    */
+   class TextFileParser
+   {
+   public:
+      /**
+        @brief: constructor
+
+        @param threadCount: number of threads, 0 for the number of hardware threads
+       */
+      explicit TextFileParser(unsigned threadCount = 1)
+         : m_threadCount(threadCount > 0 ? threadCount : WorkStealingPool::defaultThreadCount()),
+           m_next(0)
+      {}
+
+      TextFileParser(const TextFileParser&) = delete;
+      TextFileParser& operator=(const TextFileParser&) = delete;
+
+      /**
+        @brief: Read a file and find its records
+
+        @return: false if the file cannot be read
+       */
+      bool read(const std::string& filePath)
+      {
+         FILE* file = fopen(filePath.c_str(), "rb");
+         if (!file)
+         {
+            return false;
+         }
+
+         m_fileName = filePath;
+         m_text.clear();
+         m_records.clear();
+         m_next = 0;
+
+         if (fseek(file, 0, SEEK_END) == 0)
+         {
+            long size = ftell(file);
+            if (size > 0)
+            {
+               m_text.reserve((size_t)size + c_readBlockSize);
+            }
+            fseek(file, 0, SEEK_SET);
+         }
+
+         size_t used = 0;
+
+         for (;;)
+         {
+            m_text.resize(used + c_readBlockSize);
+
+            size_t read = fread(m_text.data() + used, 1, c_readBlockSize, file);
+            used += read;
+
+            if (read < c_readBlockSize)
+            {
+               break;
+            }
+         }
+
+         bool readError = ferror(file) != 0;
+         fclose(file);
+
+         if (readError)
+         {
+            return false;
+         }
+
+         // the last line is always terminated, the terminating zero stops all scans
+         m_text.resize(used);
+         m_text.push_back('\n');
+         m_text.push_back('\0');
+
+         findRecords();
+         return true;
+      }
+
+      const std::string& fileName() const { return m_fileName; }
+
+      /**
+        @brief: Number of records not yet consumed
+       */
+      size_t remaining() const { return m_records.size() - m_next; }
+
+      /**
+        @brief: Consume the next record, as TriLib's readline()
+
+        @return: the start of its first field, nullptr at the end of file
+       */
+      const char* nextRecord()
+      {
+         if (m_next >= m_records.size())
+         {
+            return nullptr;
+         }
+         return m_text.data() + m_records[m_next++];
+      }
+
+      struct ParseResult
+      {
+         size_t failed;  // index of the first invalid record, count if there's none
+         int error;      // its error code
+      };
+
+      /**
+        @brief: Consume the next records, calling work(index, record) for each of them in parallel
+
+        @param work: returns 0 for a valid record, otherwise an error code
+        @return: the first invalid record, if any
+        @note: count must not exceed remaining()
+       */
+      template <class RecordWork>
+      ParseResult parseRecords(size_t count, RecordWork work)
+      {
+         const size_t* records = m_records.data() + m_next;
+         const char* text = m_text.data();
+         ParseResult result = { count, 0 };
+         std::mutex resultMutex;
+
+         m_next += count;
+
+         runChunks(chunkCount(count, c_minRecordsPerChunk), count, [&](size_t, size_t begin, size_t end)
+            {
+               for (size_t i = begin; i < end; ++i)
+               {
+                  int error = work(i, text + records[i]);
+
+                  if (error != 0)
+                  {
+                     std::lock_guard<std::mutex> lock(resultMutex);
+                     if (i < result.failed)
+                     {
+                        result = { i, error };
+                     }
+                     return;
+                  }
+               }
+            });
+
+         return result;
+      }
+
+      /**
+        @brief: Is the field the end of a record? (a comment ends it too)
+       */
+      static bool endOfRecord(const char* field)
+      {
+         return *field == '\0' || *field == '\n' || *field == '#';
+      }
+
+      /**
+        @brief: Jump past the current field and the following whitespace, as TriLib's findfield()
+       */
+      static const char* findField(const char* field)
+      {
+         while (!endOfRecord(field) && *field != ' ' && *field != '\t')
+         {
+            ++field;
+         }
+         while (!endOfRecord(field) && !numberStart(*field))
+         {
+            ++field;
+         }
+         return field;
+      }
+
+      /**
+        @brief: Convert an integer and move past it, as strtol(field, &field, 0)
+       */
+      long readInt(const char*& field) const
+      {
+         const char* digits = (*field == '-') ? field + 1 : field;
+
+         // decimal numbers need no prefix handling
+         bool decimal = (*digits >= '1' && *digits <= '9') ||
+                        (*digits == '0' && !(digits[1] >= '0' && digits[1] <= '9') && digits[1] != 'x' && digits[1] != 'X');
+         if (decimal)
+         {
+            long value = 0;
+            auto result = std::from_chars(field, textEnd(), value);
+
+            if (result.ec == std::errc())
+            {
+               field = result.ptr;
+               return value;
+            }
+         }
+
+         char* end = nullptr;
+         long value = strtol(field, &end, 0);
+         field = end;
+         return value;
+      }
+
+      /**
+        @brief: Convert a floating point number and move past it, as strtod(field, &field)
+       */
+      double readReal(const char*& field) const
+      {
+         if (*field != '+')
+         {
+            double value = 0;
+            auto result = std::from_chars(field, textEnd(), value);
+
+            // hexadecimal numbers are left to strtod()
+            if (result.ec == std::errc() && *result.ptr != 'x' && *result.ptr != 'X')
+            {
+               field = result.ptr;
+               return value;
+            }
+         }
+
+         char* end = nullptr;
+         double value = strtod(field, &end);
+         field = end;
+         return value;
+      }
+
+   private:
+      static const size_t c_readBlockSize = 4 * 1024 * 1024;
+      static const size_t c_minBytesPerChunk = 256 * 1024;
+      static const size_t c_minRecordsPerChunk = 16 * 1024;
+
+      static bool numberStart(char c)
+      {
+         return (c >= '0' && c <= '9') || c == '.' || c == '+' || c == '-';
+      }
+
+      const char* textEnd() const { return m_text.data() + m_text.size(); }
+
+      size_t chunkCount(size_t count, size_t minChunkSize) const
+      {
+         return std::max<size_t>(1, std::min<size_t>(4 * (size_t)m_threadCount, count / minChunkSize));
+      }
+
+      // work(chunk, begin, end) for consecutive chunks of [0, count), in parallel if there's more than one
+      template <class ChunkWork>
+      void runChunks(size_t chunks, size_t count, ChunkWork work)
+      {
+         if (m_threadCount <= 1 || chunks <= 1)
+         {
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+               work(chunk, chunk * count / chunks, (chunk + 1) * count / chunks);
+            }
+            return;
+         }
+
+         if (!m_pool)
+         {
+            // the calling thread works too
+            m_pool.reset(new WorkStealingPool(m_threadCount - 1));
+         }
+
+         TaskGroup group(*m_pool);
+
+         for (size_t chunk = 1; chunk < chunks; ++chunk)
+         {
+            group.run([=, &work]() { work(chunk, chunk * count / chunks, (chunk + 1) * count / chunks); });
+         }
+
+         work(0, 0, count / chunks);
+         group.wait();
+      }
+
+      // the lines in which readline() would find a number
+      void findRecords()
+      {
+         const char* text = m_text.data();
+         size_t size = m_text.size() - 1; // without the terminating zero
+
+         // a line belongs to the chunk it starts in
+         auto lineStart = [text, size](size_t pos)
+         {
+            if (pos == 0)
+            {
+               return (size_t)0;
+            }
+            const char* newline = (const char*)memchr(text + pos - 1, '\n', size - (pos - 1));
+            return (size_t)(newline - text) + 1;
+         };
+
+         size_t chunks = chunkCount(size, c_minBytesPerChunk);
+         std::vector<std::vector<size_t>> chunkRecords(chunks);
+
+         runChunks(chunks, size, [&](size_t chunk, size_t begin, size_t end)
+            {
+               std::vector<size_t>& records = chunkRecords[chunk];
+
+               for (size_t pos = lineStart(begin), chunkEnd = lineStart(end); pos < chunkEnd; )
+               {
+                  const char* c = text + pos;
+
+                  // skip anything that doesn't look like a number, a comment, or the end of a line
+                  while (!endOfRecord(c) && !numberStart(*c))
+                  {
+                     ++c;
+                  }
+                  if (numberStart(*c))
+                  {
+                     records.push_back((size_t)(c - text));
+                  }
+
+                  const char* newline = (const char*)memchr(c, '\n', size - (size_t)(c - text));
+                  pos = (size_t)(newline - text) + 1;
+               }
+            });
+
+         size_t total = 0;
+         for (const auto& records : chunkRecords)
+         {
+            total += records.size();
+         }
+
+         m_records.reserve(total);
+         for (const auto& records : chunkRecords)
+         {
+            m_records.insert(m_records.end(), records.begin(), records.end());
+         }
+      }
+
+   private:
+      unsigned m_threadCount;
+      std::unique_ptr<WorkStealingPool> m_pool;
+      std::string m_fileName;
+      std::vector<char> m_text;
+      std::vector<size_t> m_records;  // offsets of the first fields
+      size_t m_next;
+   };
+
+}
+
+#endif
@@ -0,0 +1,309 @@
+ /**
+    @file  tpp_thread_pool.hpp
+
+    @brief  A small work-stealing thread pool used internally by the Triangle++ wrapper
+
+      Each worker owns a task deque: it pushes and pops its own tasks at the back and steals from the
+      front of the other workers' deques when its own deque runs dry. Fork-join style code uses the
+      TaskGroup class, whose wait() method helps executing pending tasks instead of blocking, so nested
+      task groups cannot deadlock the pool.
+
+    @author  Marek Krajewski (mrkkrj), www.ib-krajewski.de
+ */
+
+#ifndef TRPP_THREAD_POOL
+#define TRPP_THREAD_POOL
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+
+namespace tpp
+{
+   /**
+      @brief: Work-stealing pool of worker threads
+    */
+   class WorkStealingPool
+   {
+   public:
+      typedef std::function<void()> Task;
+
+      /**
+        @brief: constructor
+
+        @param threadCount: number of worker threads, if 0 - use the number of hardware threads
+       */
+      explicit WorkStealingPool(unsigned threadCount = 0)
+         : m_stop(false),
+           m_pending(0),
+           m_nextQueue(0)
+      {
+         if (threadCount == 0)
+         {
+            threadCount = defaultThreadCount();
+         }
+
+         for (unsigned i = 0; i < threadCount; ++i)
+         {
+            m_queues.emplace_back(new TaskQueue);
+         }
+
+         for (unsigned i = 0; i < threadCount; ++i)
+         {
+            m_workers.emplace_back([this, i]() { workerLoop(i); });
+         }
+      }
+
+      ~WorkStealingPool()
+      {
+         {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+         }
+         m_wakeUp.notify_all();
+
+         for (auto& worker : m_workers)
+         {
+            worker.join();
+         }
+      }
+
+      WorkStealingPool(const WorkStealingPool&) = delete;
+      WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+      /**
+        @brief: Number of worker threads
+       */
+      unsigned size() const { return (unsigned)m_workers.size(); }
+
+      /**
+        @brief: Hardware concurrency, at least 1
+       */
+      static unsigned defaultThreadCount()
+      {
+         unsigned hwThreads = std::thread::hardware_concurrency();
+         return hwThreads > 0 ? hwThreads : 1;
+      }
+
+      /**
+        @brief: Schedule a task; tasks submitted from a worker go to its own deque
+       */
+      void submit(Task task)
+      {
+         TaskQueue& queue = *m_queues[ownQueueIndex()];
+         {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+         }
+         m_pending.fetch_add(1);
+
+         {
+            // pairs with the predicate check in workerLoop(), avoids lost wake-ups
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+         }
+         m_wakeUp.notify_one();
+      }
+
+      /**
+        @brief: Run a single pending task in the calling thread
+
+        @return: false if there was no task to run
+       */
+      bool runPendingTask()
+      {
+         Task task;
+
+         if (!popTask(ownQueueIndex(), task))
+         {
+            return false;
+         }
+
+         task();
+         return true;
+      }
+
+   private:
+      struct TaskQueue
+      {
+         std::mutex mutex;
+         std::deque<Task> tasks;
+      };
+
+      // index of the calling worker's deque, or a round-robin choice for external threads
+      unsigned ownQueueIndex()
+      {
+         if (tl_ownerPool() == this)
+         {
+            return tl_workerIndex();
+         }
+         return m_nextQueue.fetch_add(1) % (unsigned)m_queues.size();
+      }
+
+      bool popTask(unsigned ownIdx, Task& task)
+      {
+         // own tasks LIFO, good for locality of the recursive splits...
+         {
+            TaskQueue& queue = *m_queues[ownIdx];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.tasks.empty())
+            {
+               task = std::move(queue.tasks.back());
+               queue.tasks.pop_back();
+               m_pending.fetch_sub(1);
+               return true;
+            }
+         }
+
+         // ... stolen ones FIFO, i.e. the biggest chunks of work first
+         for (size_t i = 1; i < m_queues.size(); ++i)
+         {
+            TaskQueue& queue = *m_queues[(ownIdx + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.tasks.empty())
+            {
+               task = std::move(queue.tasks.front());
+               queue.tasks.pop_front();
+               m_pending.fetch_sub(1);
+               return true;
+            }
+         }
+
+         return false;
+      }
+
+      void workerLoop(unsigned idx)
+      {
+         tl_ownerPool() = this;
+         tl_workerIndex() = idx;
+
+         for (;;)
+         {
+            Task task;
+
+            if (popTask(idx, task))
+            {
+               task();
+               continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeUp.wait(lock, [this]() { return m_stop || m_pending.load() > 0; });
+
+            if (m_stop && m_pending.load() == 0)
+            {
+               break;
+            }
+         }
+      }
+
+      static WorkStealingPool*& tl_ownerPool()
+      {
+         static thread_local WorkStealingPool* pool = nullptr;
+         return pool;
+      }
+
+      static unsigned& tl_workerIndex()
+      {
+         static thread_local unsigned index = 0;
+         return index;
+      }
+
+   private:
+      std::vector<std::unique_ptr<TaskQueue>> m_queues;
+      std::vector<std::thread> m_workers;
+      std::mutex m_sleepMutex;
+      std::condition_variable m_wakeUp;
+      bool m_stop;
+      std::atomic<int> m_pending;
+      std::atomic<unsigned> m_nextQueue;
+   };
+
+
+   /**
+      @brief: Fork-join helper: runs tasks on a pool and waits for all of them
+
+      The first exception thrown by a task is stored and rethrown by wait().
+    */
+   class TaskGroup
+   {
+   public:
+      explicit TaskGroup(WorkStealingPool& pool)
+         : m_pool(pool),
+           m_running(0)
+      {}
+
+      ~TaskGroup()
+      {
+         // never leave tasks referencing this object behind
+         waitNoThrow();
+      }
+
+      TaskGroup(const TaskGroup&) = delete;
+      TaskGroup& operator=(const TaskGroup&) = delete;
+
+      void run(std::function<void()> task)
+      {
+         m_running.fetch_add(1);
+
+         m_pool.submit([this, task]()
+            {
+               try
+               {
+                  task();
+               }
+               catch (...)
+               {
+                  std::lock_guard<std::mutex> lock(m_errorMutex);
+                  if (!m_error)
+                  {
+                     m_error = std::current_exception();
+                  }
+               }
+               m_running.fetch_sub(1);
+            });
+      }
+
+      void wait()
+      {
+         waitNoThrow();
+
+         if (m_error)
+         {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+         }
+      }
+
+   private:
+      void waitNoThrow()
+      {
+         while (m_running.load() > 0)
+         {
+            // help instead of blocking
+            if (!m_pool.runPendingTask())
+            {
+               std::this_thread::yield();
+            }
+         }
+      }
+
+   private:
+      WorkStealingPool& m_pool;
+      std::atomic<int> m_running;
+      std::mutex m_errorMutex;
+      std::exception_ptr m_error;
+   };
+
+}
+
+#endif
@@ -2,6 +2,8 @@
     @file  tpp_trace.hpp    
     @brief Macros for writing traces to a file. 
            Useful when debugging a GUI app. on Windows without console!
+           The trace file is per thread, so concurrent triangulations don't share it: the first tracing
+           thread writes to the given file, the other ones to numbered files, e.g. "triangle.out.1.txt".
  */
 
 #ifndef TRPP_TRACE_TO_FILE
@@ -14,8 +16,11 @@
 
 namespace tpp 
 {
-   extern FILE* g_debugFile;
-   extern std::string g_debugFileName;
+   extern thread_local FILE* g_debugFile;
+   extern thread_local std::string g_debugFileName;
+
+   // name of the calling thread's trace file
+   std::string traceFileName(const char* name);
 }
 
     // TR string
@@ -28,8 +33,9 @@ namespace tpp
 #   define TRACE2b(a,b) { if(tpp::g_debugFile) { fprintf(tpp::g_debugFile, "%s%s\n", a, b ? "true " : "false"); fflush(tpp::g_debugFile); } }
 
 #   define INIT_TRACE(a) { if (!tpp::g_debugFile) {\
-                             tpp::g_debugFile = fopen(a, "w");\
-                             if(!tpp::g_debugFile) std::cerr << "ERROR: Cannot open trace file: " << a << std::endl;\
+                             std::string traceFile = tpp::traceFileName(a);\
+                             tpp::g_debugFile = fopen(traceFile.c_str(), "w");\
+                             if(!tpp::g_debugFile) std::cerr << "ERROR: Cannot open trace file: " << traceFile << std::endl;\
                              else tpp::g_debugFileName = a; } }
 
 #   define END_TRACE(a) { if(tpp::g_debugFile && g_debugFileName == a) {\
@@ -8,12 +8,12 @@
 #ifndef TRPP_TRIANGULATION_MESH
 #define TRPP_TRIANGULATION_MESH
 
+#include "tpp_iterators.hpp"
+
 #include <vector>
 
 namespace tpp
 {
-   class Delaunay;
-   class FaceIterator;
 
    /**
       @brief: Class for operations on oriented triangles (faces) of a triangulation mesh
@@ -37,6 +37,19 @@ namespace tpp
    class TRPP_LIB_EXPORT TriangulationMesh
    {
    public:
+      /**
+         @brief: Result of a point location query, @see locatePoints()
+       */
+      struct LocateResult
+      {
+         enum Location { InTriangle, OnEdge, OnVertex, Outside };
+
+         Location location;
+         FaceIterator face; // InTriangle: the containing face, OnEdge: the edge is face's primary edge (Org-Dest),
+                            // OnVertex: Org() is the vertex, Outside: a hull face, the point is right of its 
+                            // primary edge (empty if there are no faces)
+      };
+
       /**
          @brief: Access the triangle adjoining edge N
 
@@ -62,6 +75,31 @@ namespace tpp
        */
       FaceIterator Sym(FaceIterator const& fit) const;
 
+      /**
+         @brief: Get the dense id of a face's triangle, @see Delaunay::enableTriangleIds()
+
+         @param fit: face iterator
+         @return: the id, or -1 for an empty iterator or a ghost triangle
+       */
+      int triangleId(FaceIterator const& fit) const;
+
+      /**
+         @brief: Access a triangle by its id in O(1)
+
+         @param id: the id, 0 to Delaunay::triangleCount() - 1 (@see Delaunay::enableTriangleIds())
+         @return: iterator of the triangle, its primary edge (Org-Dest) is edge 0
+       */
+      FaceIterator triangleAt(int id) const;
+
+      /**
+         @brief: Get the id of the triangle adjoining edge N of a triangle (@see Sym() above)
+
+         @param id: the triangle's id
+         @param i: edge number (N)
+         @return: the neighbor's id, or -1 if the edge is part of the convex hull
+       */
+      int neighborId(int id, char i) const;
+
       /**
          @brief: Find the next edge (counterclockwise) of a triangle
 
@@ -103,20 +141,42 @@ namespace tpp
 
          Note that behaviour is undefined if vertexId is greater than number of vertices - 1.
          All triangles returned have Org(triangle) = vertexId and are in counterclockwise order.
+         The vertices are numbered as in MeshBuffers, i.e. the Steiner points follow the input points.
 
          @param vertexId: the vertex for which you want incident triangles
-         @param ivv: triangles around a vertex in counterclockwise order
+         @param ivv: triangles around a vertex in counterclockwise order, as 3 vertex numbers each
        */
       void trianglesAroundVertex(int vertexId, std::vector<int>& ivv);
 
       /**
-         @brief:  Point-locate a vertex V
+         @brief:  Point-locate a vertex V in O(1), using vertex-to-triangle links
+
+         The links are made in a single pass over the mesh on the first call after a triangulation or an 
+         update (also by trianglesAroundVertex()), so triangulations which aren't queried don't pay for them.
 
-         @param vertexId: the vertex
+         @param vertexId: the vertex, numbered as in MeshBuffers, i.e. Steiner points can be located too
          @return: a face iterator whose origin is V
+         @note: Can be called from several threads at once, the first calls wait until the links are made.
+                Not concurrently with a triangulation or an update of the mesh though.
        */
       FaceIterator locate(int vertexId);
 
+      /**
+         @brief:  Point-locate a batch of arbitrary points
+
+         The queries are sorted along a space-filling curve, so that each search walks from the face 
+         found for a nearby point, and are distributed over the threads set with Delaunay::setThreadCount().
+         The mesh isn't changed by this method.
+
+         @param points: the points to locate
+         @param results: the result for each point, in the order of the input
+         @note: In meshes with holes or concavities, a walk can end outside the mesh. Such points are then 
+                searched for exhaustively if they are within the bounding box of the vertices, which costs
+                O(n) per point for a mesh of n triangles! That's the case for all points in the holes or 
+                concavities, so prefer a convex hull (or filter the points) for big batches of such queries.
+       */
+      void locatePoints(const std::vector<Delaunay::Point>& points, std::vector<LocateResult>& results);
+
       /**
          @brief:  Constructor, only made public for the sake of Python bindings!
 
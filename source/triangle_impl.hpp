@@ -298,6 +298,30 @@
 #define TRIPERBLOCK 4092           /* Number of triangles allocated at once. */
 #define SUBSEGPERBLOCK 508       /* Number of subsegments allocated at once. */
 #define VERTEXPERBLOCK 4092         /* Number of vertices allocated at once. */
+
+/* The parallel divide-and-conquer algorithm hands subproblems of at least   */
+/*   DIVCONQTASKSIZE vertices to worker threads, and splits the problem into */
+/*   at most DIVCONQTASKSPERTHREAD subproblems per thread, so that idle      */
+/*   threads have something to steal.  An explicit tile size (b->tilesize)   */
+/*   replaces both limits, but is at least DIVCONQMINTILESIZE, because each  */
+/*   tile starts a new block of triangles.                                   */
+
+#define DIVCONQTASKSIZE 16384
+#define DIVCONQTASKSPERTHREAD 4
+#define DIVCONQMINTILESIZE 2048
+
+/* Arrays of at least RADIXSORTSIZE vertices are sorted by a radix sort on   */
+/*   integer keys made from the coordinates, RADIXBITS bits per pass, and    */
+/*   cut by nth_element() on the same keys for the alternating cuts.         */
+
+#define RADIXSORTSIZE 8192
+#define RADIXBITS 11
+
+/* trimalloc() stores the size of each allocation in a header of             */
+/*   TRIMALLOCHEADER bytes, which also is the alignment of the allocations.  */
+
+#define TRIMALLOCHEADER 16
+
 #define VIRUSPERBLOCK 1020   /* Number of virus triangles allocated at once. */
 /* Number of encroached subsegments allocated at once. */
 #define BADSUBSEGPERBLOCK 252
@@ -338,6 +362,61 @@
 
 #define SAMPLERATE 10
 
+/* Used for the biased randomized insertion order (BRIO) of the incremental  */
+/*   Delaunay algorithm.  The vertices are quantized to a grid of            */
+/*   2^HILBERTBITS x 2^HILBERTBITS cells and sorted along a Hilbert curve    */
+/*   within each of at most BRIOMAXROUNDS rounds.                            */
+
+#define HILBERTBITS 24
+#define BRIOMAXROUNDS 32
+
+/* Batched point location sorts the query points along the same Hilbert      */
+/*   curve and hands runs of at least LOCATECHUNKSIZE queries to each thread.*/
+
+#define LOCATECHUNKSIZE 4096
+
+/* The parallel refinement inserts the Steiner points of up to               */
+/*   REFINEBATCHPERTHREAD bad triangles per thread in one round, as long as  */
+/*   there are at least REFINEMINBATCH bad triangles, and hands them to the  */
+/*   threads in REFINECHUNKSPERTHREAD chunks per thread.  Steiner points     */
+/*   with cavities of more than REFINEMAXCAVITY triangles are inserted by    */
+/*   the sequential code.                                                    */
+
+#define REFINEBATCHPERTHREAD 256
+#define REFINEMINBATCH 64
+#define REFINECHUNKSPERTHREAD 4
+#define REFINEMAXCAVITY 64
+
+/* The main loops call the progress hook every PROGRESSSTEPS steps, i.e.     */
+/*   inserted vertices, segments, holes or Steiner points.  The phases       */
+/*   reported to the hook (mrkkrj):                                          */
+
+#define PROGRESSSTEPS 1024
+
+#define PROGRESSDELAUNAY 0
+#define PROGRESSSEGMENTS 1
+#define PROGRESSHOLES 2
+#define PROGRESSQUALITY 3
+
+/* The area of an equilateral triangle with edges of unit length, used to    */
+/*   turn the target edge lengths of a sizing field into max. areas.         */
+
+#define EQUILATERALAREA 0.43301270189221932
+
+/* The streaming Delaunay triangulation finalizes the vertices in the cells  */
+/*   of a grid of about STREAMCELLPOINTS vertices per cell (by default), but */
+/*   at most STREAMMAXCELLS cells.  The vertices no longer used by any       */
+/*   triangle are freed when their number has doubled since the last sweep,  */
+/*   but not before there are STREAMSWEEPSIZE of them.  The circumcircles   */
+/*   are enlarged by the relative STREAMRADIUSSLACK against roundoff.        */
+
+#define STREAMCELLPOINTS 1024
+#define STREAMMAXCELLS 1048576
+#define STREAMSWEEPSIZE 65536
+#define STREAMRADIUSSLACK 1.0e-6
+/* Number of waiting triangle entries allocated at once. */
+#define STREAMWAITPERBLOCK 4092
+
 /* A number that speaks for itself, every kissable digit.                    */
 
 #define PI 3.141592653589793238462643383279502884197169399375105820974944592308
@@ -352,8 +431,15 @@
 
 //#include <dpoint.hpp>
 #include "dpoint.hpp"
+#include "tpp_thread_pool.hpp"
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -374,6 +460,20 @@
 #include "triangle.h"
 #endif /* TRILIBRARY */
 
+/* Batched predicates (mrkkrj): the floating-point filters of two           */
+/*   counterclockwise() or incircle() tests are evaluated at once with SSE2. */
+/*   Not used if the x87 FPU is in charge (CPU86), as its results could      */
+/*   differ from the scalar code's.  Define NO_SIMD_PREDICATES to switch the */
+/*   vector code off.                                                        */
+
+#if !defined(NO_SIMD_PREDICATES) && !defined(SINGLE) && !defined(CPU86)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SIMD_PREDICATES
+#include <emmintrin.h>
+#endif /* SSE2 */
+#endif /* not NO_SIMD_PREDICATES */
+
 /* A few forward declarations.                                               */
 
 
@@ -695,6 +795,47 @@ REAL o3derrboundA, o3derrboundB, o3derrboundC;
 
 unsigned long randomseed;                     /* Current random number seed. */
 
+/* Memory used by trimalloc() and trifree() (mrkkrj).  If `memresource' is   */
+/*   NULL, malloc() and free() are used.  Allocations which would make more  */
+/*   than `memlimit' bytes in use fail (no limit if zero).  `memmutex'       */
+/*   serializes the allocations of the divide-and-conquer worker threads.    */
+
+std::pmr::memory_resource *memresource = nullptr;
+size_t memlimit = 0;
+size_t memused = 0;
+std::mutex memmutex;
+
+/* Progress reports and cancellation (mrkkrj).  If `progresshook' isn't     */
+/*   NULL, it's called by the calling thread with `progresscontext', the     */
+/*   phase, the steps done and the total number of steps (zero if unknown).  */
+/*   It may throw an exception to abort the triangulation.  In the quality   */
+/*   phase it may return nonzero to stop adding Steiner points, as if the -S */
+/*   limit was reached.  `progresscountdown' counts the steps to the next    */
+/*   call.  The parallel divide-and-conquer counts its triangulated vertices */
+/*   in `progressdivconq', and only `progressthread' calls the hook.         */
+
+int (*progresshook)(void *context, int phase, long done, long total) = nullptr;
+void *progresscontext = nullptr;
+long progresscountdown = PROGRESSSTEPS;
+std::atomic<long> progressdivconq{0};
+std::thread::id progressthread;
+
+/* User-defined triangle test (mrkkrj).  If `usertestfunc' isn't NULL, the   */
+/*   -u switch calls it with `usertestcontext' instead of triunsuitable().   */
+/*   It's called by one thread at a time.                                    */
+
+int (*usertestfunc)(void *context, REAL *triorg, REAL *tridest, REAL *triapex,
+                    REAL area) = nullptr;
+void *usertestcontext = nullptr;
+
+/* Background sizing field (mrkkrj).  If `sizingfunc' isn't NULL, the        */
+/*   quality refinement also splits triangles larger than an equilateral     */
+/*   triangle with the edge length returned for their centroid.  Nonpositive */
+/*   edge lengths don't constrain the triangle.                              */
+
+REAL (*sizingfunc)(void *context, REAL x, REAL y) = nullptr;
+void *sizingcontext = nullptr;
+
 
 /* Mesh data structure.  Triangle operates on only one mesh, but the mesh    */
 /*   structure is used (instead of global variables) to allow reentrancy.    */
@@ -747,6 +888,7 @@ struct mesh {
   int highorderindex;  /* Index to find extra nodes for high-order elements. */
   int elemattribindex;            /* Index to find attributes of a triangle. */
   int areaboundindex;             /* Index to find area bound of a triangle. */
+  int triangleidindex;      /* Index to find the dense number of a triangle. */
   int checksegments;         /* Are there segments in the triangulation yet? */
   int checkquality;                  /* Has quality triangulation begun yet? */
   int readnodefile;                           /* Has a .node file been read? */
@@ -758,6 +900,9 @@ struct mesh {
   long hyperbolacount;      /* Number of right-of-hyperbola tests performed. */
   long circumcentercount;  /* Number of circumcenter calculations performed. */
   long circletopcount;       /* Number of circle top calculations performed. */
+  long incircleexactcount;   /* Incircle tests that needed exact arithmetic. */
+  long counterclockexactcount;         /* Counterclockwise tests that needed */
+                                       /*   exact arithmetic.                */
 
 /* Triangular bounding box vertices.                                         */
 
@@ -775,6 +920,11 @@ struct mesh {
   subseg *dummysub;
   subseg *dummysubbase;      /* Keep base address so we can free() it later. */
 
+/* Sizes of the `dummytri' and `dummysub' allocations, so a reused mesh can  */
+/*   keep them for the next triangulation (mrkkrj).                          */
+
+  int dummytribytes, dummysubbytes;
+
 /* Pointer to a recently visited triangle.  Improves point location if       */
 /*   proximate vertices are inserted sequentially.                           */
 
@@ -819,6 +969,11 @@ struct behavior {
 /*   quiet: -Q switch.  verbose: count of how often -V switch is selected.   */
 /*   usesegments: -p, -r, -q, or -c switch; determines whether segments are  */
 /*     used at all.                                                          */
+/*   threads: number of threads for the divide-and-conquer algorithm and    */
+/*     the quality refinement; no switch, set by the caller after            */
+/*     parsecommandline() (mrkkrj).                                          */
+/*   tilesize: min. number of vertices triangulated by one task of the       */
+/*     parallel divide-and-conquer, 0 for the default; no switch (mrkkrj).   */
 /*                                                                           */
 /* Read the instructions to find out the meaning of these switches.          */
 
@@ -836,6 +991,9 @@ struct behavior {
   int order;
   int nobisect;
   int steiner;
+  int threads, tilesize;
+  int reservevertices, reservetriangles, reservesubsegs;   /* (mrkkrj) */
+  int triangleids;                                         /* (mrkkrj) */
   REAL minangle, goodangle, offconstant;
   REAL maxarea;
 
@@ -1206,6 +1364,10 @@ typedef unsigned long int_ptr_type;
 #define setareabound(otri, value)                                             \
   ((REAL *) (otri).tri)[m->areaboundindex] = value
 
+/* Check a triangle's dense number, see numbertriangles() (mrkkrj).          */
+
+#define triangleid(otri)  ((int *) (otri).tri)[m->triangleidindex]
+
 /* Check or set a triangle's deallocation.  Its second pointer is set to     */
 /*   NULL to indicate that it is not allocated.  (Its first pointer is used  */
 /*   for the stack of dead items.)  Its fourth pointer (its first vertex)    */
@@ -1500,13 +1662,40 @@ int size;
 
 {
   VOID *memptr;
-
-  memptr = (VOID *) malloc((unsigned int) size);
+  size_t bytes;
+
+  /* Each allocation is preceded by its size, as the memory resource needs */
+  /*   it on deallocation (mrkkrj).                                         */
+  bytes = (size_t) size + TRIMALLOCHEADER;
+  memptr = (VOID *) NULL;
+  {
+    std::lock_guard<std::mutex> lock(memmutex);
+
+    if ((memlimit == 0) || (memused + bytes <= memlimit)) {
+      if (memresource == nullptr) {
+        memptr = (VOID *) malloc(bytes);
+      } else {
+        try {
+          memptr = (VOID *) memresource->allocate(bytes, TRIMALLOCHEADER);
+        } catch (const std::bad_alloc&) {
+          memptr = (VOID *) NULL;
+        }
+      }
+      if (memptr != (VOID *) NULL) {
+        memused += bytes;
+      }
+    }
+  }
   if (memptr == (VOID *) NULL) {
+#ifdef TRILIB_EXIT_BY_EXCEPTION
+    throw std::bad_alloc();
+#else
     printf("Error:  Out of memory.\n");
     triexit(1);
+#endif
   }
-  return(memptr);
+  *(size_t *) memptr = bytes;
+  return (VOID *) ((char *) memptr + TRIMALLOCHEADER);
 }
 
 #ifdef ANSI_DECLARATORS
@@ -1517,7 +1706,71 @@ VOID *memptr;
 #endif /* not ANSI_DECLARATORS */
 
 {
-  free(memptr);
+  size_t bytes;
+
+  if (memptr == (VOID *) NULL) {
+    return;
+  }
+  memptr = (VOID *) ((char *) memptr - TRIMALLOCHEADER);
+  bytes = *(size_t *) memptr;
+
+  std::lock_guard<std::mutex> lock(memmutex);
+
+  if (memresource == nullptr) {
+    free(memptr);
+  } else {
+    memresource->deallocate(memptr, bytes, TRIMALLOCHEADER);
+  }
+  memused -= bytes;
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  reportprogress()   Call the progress hook, if there's one (mrkkrj).      */
+/*                                                                           */
+/*  Returns the result of the hook, i.e. nonzero if the caller should stop,  */
+/*  or zero if there's no hook.                                              */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+int reportprogress(int phase, long done, long total)
+#else /* not ANSI_DECLARATORS */
+int reportprogress(phase, done, total)
+int phase;
+long done;
+long total;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  progresscountdown = PROGRESSSTEPS;
+  if (progresshook == nullptr) {
+    return 0;
+  }
+  return progresshook(progresscontext, phase, done, total);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  progressstep()   Count a step of a main loop, and call the progress hook */
+/*                   every PROGRESSSTEPS steps (mrkkrj).                     */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+int progressstep(int phase, long done, long total)
+#else /* not ANSI_DECLARATORS */
+int progressstep(phase, done, total)
+int phase;
+long done;
+long total;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  if ((progresshook == nullptr) || (--progresscountdown > 0)) {
+    return 0;
+  }
+  return reportprogress(phase, done, total);
 }
 
 /**                                                                         **/
@@ -3391,6 +3644,10 @@ struct behavior *b;
   b->nobisect = 0;
   b->conformdel = 0;
   b->steiner = -1;
+  b->threads = 1;
+  b->tilesize = 0;
+  b->triangleids = 0;
+  b->reservevertices = b->reservetriangles = b->reservesubsegs = 0;
   b->order = 1;
   b->minangle = 0.0;
   b->maxarea = -1.0;
@@ -4069,6 +4326,57 @@ struct memorypool *pool;
   }
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  poolreinit()   Initialize a pool, reusing the memory of its last use.    */
+/*                                                                           */
+/*  Works like poolinit(), but if the pool still owns the blocks of an       */
+/*  earlier triangulation with the same item size, alignment and block size, */
+/*  these blocks are restarted with poolrestart() instead of being freed and */
+/*  allocated again.  A first block bigger than requested is kept as it is,  */
+/*  a smaller one (e.g. after the caller reserved more memory) causes the    */
+/*  pool to be freed and initialized anew.  A pool which owns no memory is   */
+/*  simply initialized.                                                      */
+/*                                                                           */
+/*  Used to avoid heap allocations when a mesh is triangulated repeatedly    */
+/*  (mrkkrj).                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void poolreinit(struct memorypool *pool, int bytecount, int itemcount,
+                int firstitemcount, int alignment)
+#else /* not ANSI_DECLARATORS */
+void poolreinit(pool, bytecount, itemcount, firstitemcount, alignment)
+struct memorypool *pool;
+int bytecount;
+int itemcount;
+int firstitemcount;
+int alignment;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  int alignbytes;
+
+  if (pool->firstblock != (VOID **) NULL) {
+    /* Same alignment and item size computation as in poolinit(). */
+    if ((unsigned int)alignment > (unsigned int)sizeof(VOID *)) {
+      alignbytes = alignment;
+    } else {
+      alignbytes = sizeof(VOID *);
+    }
+    if ((pool->alignbytes == alignbytes) &&
+        (pool->itembytes == ((bytecount - 1) / alignbytes + 1) * alignbytes) &&
+        (pool->itemsperblock == itemcount) &&
+        (pool->itemsfirstblock >= firstitemcount)) {
+      poolrestart(pool);
+      return;
+    }
+    pooldeinit(pool);
+  }
+  poolinit(pool, bytecount, itemcount, firstitemcount, alignment);
+}
+
 /*****************************************************************************/
 /*                                                                           */
 /*  poolalloc()   Allocate space for an item.                                */
@@ -4153,6 +4461,69 @@ VOID *dyingitem;
   pool->items--;
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  poolsplice()   Move all items of a second pool to the end of a pool.     */
+/*                                                                           */
+/*  The blocks of `donor' are linked in behind the current block of `pool',  */
+/*  and allocation continues where it stopped in `donor'.  Both pools must   */
+/*  have been initialized with the same item size, alignment and block size, */
+/*  and all blocks of `donor' must be of the same size (i.e. `donor' has no  */
+/*  special first block).  The caller must make sure that `pool' has no      */
+/*  unallocated items left in its current block, as these would be visited  */
+/*  by a traversal.  On return `donor' is empty and owns no memory.          */
+/*                                                                           */
+/*  Used to collect the triangles created by the worker threads of the       */
+/*  parallel divide-and-conquer algorithm (mrkkrj).                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void poolsplice(struct memorypool *pool, struct memorypool *donor)
+#else /* not ANSI_DECLARATORS */
+void poolsplice(pool, donor)
+struct memorypool *pool;
+struct memorypool *donor;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  VOID **spareblocks;
+  VOID **lastblock;
+  VOID **deaditem;
+
+  if (donor->firstblock == (VOID **) NULL) {
+    return;
+  }
+
+  /* Unused blocks following the current block go behind the donor's ones. */
+  spareblocks = (VOID **) *(pool->nowblock);
+  *(pool->nowblock) = (VOID *) donor->firstblock;
+  lastblock = donor->nowblock;
+  while (*lastblock != (VOID *) NULL) {
+    lastblock = (VOID **) *lastblock;
+  }
+  *lastblock = (VOID *) spareblocks;
+
+  /* Continue allocation in the donor's current block. */
+  pool->nowblock = donor->nowblock;
+  pool->nextitem = donor->nextitem;
+  pool->unallocateditems = donor->unallocateditems;
+  pool->items += donor->items;
+  pool->maxitems += donor->maxitems;
+
+  /* Put the donor's dead items on top of the stack. */
+  if (donor->deaditemstack != (VOID *) NULL) {
+    deaditem = (VOID **) donor->deaditemstack;
+    while (*deaditem != (VOID *) NULL) {
+      deaditem = (VOID **) *deaditem;
+    }
+    *deaditem = pool->deaditemstack;
+    pool->deaditemstack = donor->deaditemstack;
+  }
+
+  poolzero(donor);
+}
+
 /*****************************************************************************/
 /*                                                                           */
 /*  traversalinit()   Prepare to traverse the entire list of items.          */
@@ -4234,6 +4605,51 @@ struct memorypool *pool;
   return newitem;
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  poolblockitems()   Find the items of one block of a pool.                */
+/*                                                                           */
+/*  Returns the first item of `block' and sets `count' to the number of      */
+/*  items traverse() visits in it, dead ones included.  The blocks in use    */
+/*  are `firstblock' up to `nowblock', each one pointing to the next.        */
+/*                                                                           */
+/*  Used to split the items of a pool by blocks, so that they can be         */
+/*  traversed in parallel without touching the traversal state of the pool   */
+/*  (mrkkrj).                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+VOID *poolblockitems(struct memorypool *pool, VOID **block, int *count)
+#else /* not ANSI_DECLARATORS */
+VOID *poolblockitems(pool, block, count)
+struct memorypool *pool;
+VOID **block;
+int *count;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  VOID *firstitem;
+  int_ptr_type alignptr;
+
+  /* Find the first item in the block, as in traversalinit(). */
+  alignptr = (int_ptr_type) (block + 1);
+  firstitem = (VOID *)
+    (alignptr + (int_ptr_type) pool->alignbytes -
+     (alignptr % (int_ptr_type) pool->alignbytes));
+
+  /* The current block is only used up to the next free item. */
+  if (block == pool->nowblock) {
+    *count = (int) (((char *) pool->nextitem - (char *) firstitem) /
+                    pool->itembytes);
+  } else if (block == pool->firstblock) {
+    *count = pool->itemsfirstblock;
+  } else {
+    *count = pool->itemsperblock;
+  }
+  return firstitem;
+}
+
 /*****************************************************************************/
 /*                                                                           */
 /*  dummyinit()   Initialize the triangle that fills "outer space" and the   */
@@ -4276,9 +4692,15 @@ int subsegbytes;
 {
   int_ptr_type alignptr;
 
-  /* Set up `dummytri', the `triangle' that occupies "outer space." */
-  m->dummytribase = (triangle *) trimalloc(trianglebytes +
-                                           m->triangles.alignbytes);
+  /* Set up `dummytri', the `triangle' that occupies "outer space."  Keep */
+  /*   the one of an earlier triangulation if it's big enough (mrkkrj).   */
+  if ((m->dummytribase == (triangle *) NULL) ||
+      (m->dummytribytes < trianglebytes)) {
+    trifree((VOID *) m->dummytribase);
+    m->dummytribase = (triangle *) trimalloc(trianglebytes +
+                                             m->triangles.alignbytes);
+    m->dummytribytes = trianglebytes;
+  }
   /* Align `dummytri' on a `triangles.alignbytes'-byte boundary. */
   alignptr = (int_ptr_type) m->dummytribase;
   m->dummytri = (triangle *)
@@ -4300,8 +4722,13 @@ int subsegbytes;
     /* Set up `dummysub', the omnipresent subsegment pointed to by any */
     /*   triangle side or subsegment end that isn't attached to a real */
     /*   subsegment.                                                   */
-    m->dummysubbase = (subseg *) trimalloc(subsegbytes +
-                                           m->subsegs.alignbytes);
+    if ((m->dummysubbase == (subseg *) NULL) ||
+        (m->dummysubbytes < subsegbytes)) {
+      trifree((VOID *) m->dummysubbase);
+      m->dummysubbase = (subseg *) trimalloc(subsegbytes +
+                                             m->subsegs.alignbytes);
+      m->dummysubbytes = subsegbytes;
+    }
     /* Align `dummysub' on a `subsegs.alignbytes'-byte boundary. */
     alignptr = (int_ptr_type) m->dummysubbase;
     m->dummysub = (subseg *)
@@ -4352,6 +4779,7 @@ struct behavior *b;
 
 {
   int vertexsize;
+  int firstblock;
 
   /* The index within each vertex at which the boundary marker is found,    */
   /*   followed by the vertex type.  Ensure the vertex marker is aligned to */
@@ -4368,10 +4796,14 @@ struct behavior *b;
     vertexsize = (m->vertex2triindex + 1) * sizeof(triangle);
   }
 
-  /* Initialize the pool of vertices. */
-  poolinit(&m->vertices, vertexsize, VERTEXPERBLOCK,
-           m->invertices > VERTEXPERBLOCK ? m->invertices : VERTEXPERBLOCK,
-           sizeof(REAL));
+  /* Initialize the pool of vertices.  The first block also takes the   */
+  /*   vertices reserved for Steiner points, if any (mrkkrj).            */
+  firstblock = m->invertices > VERTEXPERBLOCK ? m->invertices : VERTEXPERBLOCK;
+  if (b->reservevertices > firstblock) {
+    firstblock = b->reservevertices;
+  }
+  poolreinit(&m->vertices, vertexsize, VERTEXPERBLOCK, firstblock,
+             sizeof(REAL));
 }
 
 /*****************************************************************************/
@@ -4395,6 +4827,7 @@ struct behavior *b;
 
 {
   int trisize;
+  int firstblock;
 
   /* The index within each triangle at which the extra nodes (above three)  */
   /*   associated with high order elements are found.  There are three      */
@@ -4428,17 +4861,34 @@ struct behavior *b;
 	  )) {
     trisize = (unsigned int)(6 * sizeof(triangle) + sizeof(int));
   }
+  /* Dense triangle numbers get an integer of their own at the end of each */
+  /*   triangle, as all of the above can be in use (mrkkrj).               */
+  if (b->triangleids) {
+    m->triangleidindex = (trisize + sizeof(int) - 1) / sizeof(int);
+    trisize = (m->triangleidindex + 1) * sizeof(int);
+  }
 
   /* Having determined the memory size of a triangle, initialize the pool. */
-  poolinit(&m->triangles, trisize, TRIPERBLOCK,
-           (2 * m->invertices - 2) > TRIPERBLOCK ? (2 * m->invertices - 2) :
-           TRIPERBLOCK, 4);
+  /*   The parallel divide-and-conquer algorithm creates most triangles in  */
+  /*   the worker threads' pools, so a big first block would stay unused,  */
+  /*   except for the triangles reserved beyond the Delaunay triangulation */
+  /*   (mrkkrj).                                                            */
+  firstblock = 2 * m->invertices - 2;
+  if (!b->incremental && !b->sweepline &&
+      (divconqsplitdepth(b, m->invertices) > 0)) {
+    firstblock = b->reservetriangles - firstblock;
+  } else if (b->reservetriangles > firstblock) {
+    firstblock = b->reservetriangles;
+  }
+  poolreinit(&m->triangles, trisize, TRIPERBLOCK,
+             firstblock > TRIPERBLOCK ? firstblock : TRIPERBLOCK, 4);
 
   if (b->usesegments) {
     /* Initialize the pool of subsegments.  Take into account all eight */
     /*   pointers and one boundary marker.                              */
-    poolinit(&m->subsegs, 8 * sizeof(triangle) + sizeof(int),
-             SUBSEGPERBLOCK, SUBSEGPERBLOCK, 4);
+    poolreinit(&m->subsegs, 8 * sizeof(triangle) + sizeof(int),
+               SUBSEGPERBLOCK, b->reservesubsegs > SUBSEGPERBLOCK ?
+               b->reservesubsegs : SUBSEGPERBLOCK, 4);
 
     /* Initialize the "outer space" triangle and omnipresent subsegment. */
     dummyinit(m, b, m->triangles.itembytes, m->subsegs.itembytes);
@@ -4695,30 +5145,30 @@ int number;
 /*****************************************************************************/
 
 #ifdef ANSI_DECLARATORS
-void triangledeinit(struct mesh *m, struct behavior *b)
+void triangledeinit(struct mesh *m)
 #else /* not ANSI_DECLARATORS */
-void triangledeinit(m, b)
+void triangledeinit(m)
 struct mesh *m;
-struct behavior *b;
 #endif /* not ANSI_DECLARATORS */
 
 {
+  /* A reused mesh may still own pools from triangulations with other      */
+  /*   switches, so free all of them.  Unused pools own no memory (mrkkrj). */
   pooldeinit(&m->triangles);
   trifree((VOID *) m->dummytribase);
-  if (b->usesegments) {
-    pooldeinit(&m->subsegs);
-    trifree((VOID *) m->dummysubbase);
-  }
+  pooldeinit(&m->subsegs);
+  trifree((VOID *) m->dummysubbase);
   pooldeinit(&m->vertices);
+  /* Left over by an aborted triangulation (mrkkrj). */
+  pooldeinit(&m->viri);
+  pooldeinit(&m->splaynodes);
 #ifndef CDT_ONLY
-  if (b->quality) {
-    pooldeinit(&m->badsubsegs);
-    if ((b->minangle > 0.0) || b->vararea || b->fixedarea || b->usertest) {
-      pooldeinit(&m->badtriangles);
-      pooldeinit(&m->flipstackers);
-    }
-  }
+  pooldeinit(&m->badsubsegs);
+  pooldeinit(&m->badtriangles);
+  pooldeinit(&m->flipstackers);
 #endif /* not CDT_ONLY */
+  m->dummytribase = (triangle *) NULL;
+  m->dummysubbase = (subseg *) NULL;
 }
 
 /**                                                                         **/
@@ -5037,6 +5487,9 @@ void exactinit()
 /*  will be also.)  Does NOT maintain the nonoverlapping or nonadjacent      */
 /*  properties.                                                              */
 /*                                                                           */
+/*  The next components are read only while there are any left, instead of  */
+/*  reading (and ignoring) the element past the end of `e' or `f'. (mrkkrj)  */
+/*                                                                           */
 /*****************************************************************************/
 
 #ifdef ANSI_DECLARATORS
@@ -5064,19 +5517,19 @@ REAL *h;
   eindex = findex = 0;
   if ((fnow > enow) == (fnow > -enow)) {
     Q = enow;
-    enow = e[++eindex];
+    enow = (++eindex < elen) ? e[eindex] : 0.0;
   } else {
     Q = fnow;
-    fnow = f[++findex];
+    fnow = (++findex < flen) ? f[findex] : 0.0;
   }
   hindex = 0;
   if ((eindex < elen) && (findex < flen)) {
     if ((fnow > enow) == (fnow > -enow)) {
       Fast_Two_Sum(enow, Q, Qnew, hh);
-      enow = e[++eindex];
+      enow = (++eindex < elen) ? e[eindex] : 0.0;
     } else {
       Fast_Two_Sum(fnow, Q, Qnew, hh);
-      fnow = f[++findex];
+      fnow = (++findex < flen) ? f[findex] : 0.0;
     }
     Q = Qnew;
     if (hh != 0.0) {
@@ -5085,10 +5538,10 @@ REAL *h;
     while ((eindex < elen) && (findex < flen)) {
       if ((fnow > enow) == (fnow > -enow)) {
         Two_Sum(Q, enow, Qnew, hh);
-        enow = e[++eindex];
+        enow = (++eindex < elen) ? e[eindex] : 0.0;
       } else {
         Two_Sum(Q, fnow, Qnew, hh);
-        fnow = f[++findex];
+        fnow = (++findex < flen) ? f[findex] : 0.0;
       }
       Q = Qnew;
       if (hh != 0.0) {
@@ -5098,7 +5551,7 @@ REAL *h;
   }
   while (eindex < elen) {
     Two_Sum(Q, enow, Qnew, hh);
-    enow = e[++eindex];
+    enow = (++eindex < elen) ? e[eindex] : 0.0;
     Q = Qnew;
     if (hh != 0.0) {
       h[hindex++] = hh;
@@ -5106,7 +5559,7 @@ REAL *h;
   }
   while (findex < flen) {
     Two_Sum(Q, fnow, Qnew, hh);
-    fnow = f[++findex];
+    fnow = (++findex < flen) ? f[findex] : 0.0;
     Q = Qnew;
     if (hh != 0.0) {
       h[hindex++] = hh;
@@ -5364,6 +5817,7 @@ vertex pc;
     return det;
   }
 
+  m->counterclockexactcount++;
   return counterclockwiseadapt(pa, pb, pc, detsum);
 }
 
@@ -6023,9 +6477,248 @@ vertex pd;
     return det;
   }
 
+  m->incircleexactcount++;
   return incircleadapt(pa, pb, pc, pd, permanent);
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  Batched predicates (mrkkrj).                                             */
+/*                                                                           */
+/*  counterclockwisebatch() and incirclebatch() evaluate `count' tests, two  */
+/*  at a time.  The floating-point filters of counterclockwise() and         */
+/*  incircle() run in SSE2 registers, with exactly the same operations and   */
+/*  error bounds as the scalar code, so the results are identical.  The      */
+/*  adaptive exact arithmetic is used only for the lanes that fail their     */
+/*  filter.  Use them where several independent tests are known in advance. */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef SIMD_PREDICATES
+
+/*****************************************************************************/
+/*                                                                           */
+/*  counterclockwisefilter2()   The filter of counterclockwise() for two     */
+/*                              triples of vertices, using SSE2.             */
+/*                                                                           */
+/*  Stores the determinants in `det' and the values of `detsum' needed by    */
+/*  counterclockwiseadapt() in `detsum'.  Returns a bit mask of the lanes    */
+/*  whose determinant's sign is not certain.                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+int counterclockwisefilter2(vertex *pa, vertex *pb, vertex *pc,
+                            REAL *det, REAL *detsum)
+{
+  __m128d pax, pay, pbx, pby, pcx, pcy;
+  __m128d detleft, detright, d, sum, errbound;
+  __m128d zero, signmask, samesign, passed;
+
+  pax = _mm_set_pd(pa[1][0], pa[0][0]);
+  pay = _mm_set_pd(pa[1][1], pa[0][1]);
+  pbx = _mm_set_pd(pb[1][0], pb[0][0]);
+  pby = _mm_set_pd(pb[1][1], pb[0][1]);
+  pcx = _mm_set_pd(pc[1][0], pc[0][0]);
+  pcy = _mm_set_pd(pc[1][1], pc[0][1]);
+
+  detleft = _mm_mul_pd(_mm_sub_pd(pax, pcx), _mm_sub_pd(pby, pcy));
+  detright = _mm_mul_pd(_mm_sub_pd(pay, pcy), _mm_sub_pd(pbx, pcx));
+  d = _mm_sub_pd(detleft, detright);
+
+  zero = _mm_setzero_pd();
+  signmask = _mm_set1_pd(-0.0);
+  /* Only if both products have the same sign can the difference be wrong. */
+  samesign = _mm_or_pd(_mm_and_pd(_mm_cmpgt_pd(detleft, zero),
+                                  _mm_cmpgt_pd(detright, zero)),
+                       _mm_and_pd(_mm_cmplt_pd(detleft, zero),
+                                  _mm_cmplt_pd(detright, zero)));
+  sum = _mm_add_pd(_mm_andnot_pd(signmask, detleft),
+                   _mm_andnot_pd(signmask, detright));
+  errbound = _mm_mul_pd(_mm_set1_pd(ccwerrboundA), sum);
+  passed = _mm_or_pd(_mm_cmpge_pd(d, errbound),
+                     _mm_cmpge_pd(_mm_xor_pd(d, signmask), errbound));
+
+  _mm_storeu_pd(det, d);
+  _mm_storeu_pd(detsum, sum);
+  return _mm_movemask_pd(_mm_andnot_pd(passed, samesign));
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  incirclefilter2()   The filter of incircle() for two quadruples of       */
+/*                      vertices, using SSE2.                                */
+/*                                                                           */
+/*  Stores the determinants in `det' and the values of `permanent' needed by */
+/*  incircleadapt() in `permanent'.  Returns a bit mask of the lanes whose   */
+/*  determinant's sign is not certain.                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+int incirclefilter2(vertex *pa, vertex *pb, vertex *pc, vertex *pd,
+                    REAL *det, REAL *permanent)
+{
+  __m128d adx, bdx, cdx, ady, bdy, cdy, pdx, pdy;
+  __m128d bdxcdy, cdxbdy, cdxady, adxcdy, adxbdy, bdxady;
+  __m128d alift, blift, clift;
+  __m128d d, perm, errbound, signmask, passed;
+
+  pdx = _mm_set_pd(pd[1][0], pd[0][0]);
+  pdy = _mm_set_pd(pd[1][1], pd[0][1]);
+  adx = _mm_sub_pd(_mm_set_pd(pa[1][0], pa[0][0]), pdx);
+  bdx = _mm_sub_pd(_mm_set_pd(pb[1][0], pb[0][0]), pdx);
+  cdx = _mm_sub_pd(_mm_set_pd(pc[1][0], pc[0][0]), pdx);
+  ady = _mm_sub_pd(_mm_set_pd(pa[1][1], pa[0][1]), pdy);
+  bdy = _mm_sub_pd(_mm_set_pd(pb[1][1], pb[0][1]), pdy);
+  cdy = _mm_sub_pd(_mm_set_pd(pc[1][1], pc[0][1]), pdy);
+
+  bdxcdy = _mm_mul_pd(bdx, cdy);
+  cdxbdy = _mm_mul_pd(cdx, bdy);
+  alift = _mm_add_pd(_mm_mul_pd(adx, adx), _mm_mul_pd(ady, ady));
+
+  cdxady = _mm_mul_pd(cdx, ady);
+  adxcdy = _mm_mul_pd(adx, cdy);
+  blift = _mm_add_pd(_mm_mul_pd(bdx, bdx), _mm_mul_pd(bdy, bdy));
+
+  adxbdy = _mm_mul_pd(adx, bdy);
+  bdxady = _mm_mul_pd(bdx, ady);
+  clift = _mm_add_pd(_mm_mul_pd(cdx, cdx), _mm_mul_pd(cdy, cdy));
+
+  d = _mm_add_pd(_mm_add_pd(_mm_mul_pd(alift, _mm_sub_pd(bdxcdy, cdxbdy)),
+                            _mm_mul_pd(blift, _mm_sub_pd(cdxady, adxcdy))),
+                 _mm_mul_pd(clift, _mm_sub_pd(adxbdy, bdxady)));
+
+  signmask = _mm_set1_pd(-0.0);
+  perm = _mm_add_pd(
+           _mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_andnot_pd(signmask, bdxcdy),
+                                            _mm_andnot_pd(signmask, cdxbdy)),
+                                 alift),
+                      _mm_mul_pd(_mm_add_pd(_mm_andnot_pd(signmask, cdxady),
+                                            _mm_andnot_pd(signmask, adxcdy)),
+                                 blift)),
+           _mm_mul_pd(_mm_add_pd(_mm_andnot_pd(signmask, adxbdy),
+                                 _mm_andnot_pd(signmask, bdxady)),
+                      clift));
+  errbound = _mm_mul_pd(_mm_set1_pd(iccerrboundA), perm);
+  passed = _mm_or_pd(_mm_cmpgt_pd(d, errbound),
+                     _mm_cmpgt_pd(_mm_xor_pd(d, signmask), errbound));
+
+  _mm_storeu_pd(det, d);
+  _mm_storeu_pd(permanent, perm);
+  return _mm_movemask_pd(passed) ^ 0x3;
+}
+
+#endif /* SIMD_PREDICATES */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  counterclockwisebatch()   Batched counterclockwise() tests.              */
+/*                                                                           */
+/*  results[i] = counterclockwise(m, b, pa[i], pb[i], pc[i]) for all i less  */
+/*  than `count'.                                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void counterclockwisebatch(struct mesh *m, struct behavior *b, int count,
+                           vertex *pa, vertex *pb, vertex *pc, REAL *results)
+#else /* not ANSI_DECLARATORS */
+void counterclockwisebatch(m, b, count, pa, pb, pc, results)
+struct mesh *m;
+struct behavior *b;
+int count;
+vertex *pa;
+vertex *pb;
+vertex *pc;
+REAL *results;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  int i;
+#ifdef SIMD_PREDICATES
+  REAL detsum[2];
+  int uncertain;
+  int j;
+#endif /* SIMD_PREDICATES */
+
+  i = 0;
+#ifdef SIMD_PREDICATES
+  for (; count - i >= 2; i += 2) {
+    uncertain = counterclockwisefilter2(&pa[i], &pb[i], &pc[i], &results[i],
+                                        detsum);
+    m->counterclockcount += 2;
+    if (!b->noexact) {
+      /* Exact arithmetic only for the lanes that need it. */
+      for (j = 0; j < 2; j++) {
+        if (uncertain & (1 << j)) {
+          m->counterclockexactcount++;
+          results[i + j] = counterclockwiseadapt(pa[i + j], pb[i + j],
+                                                 pc[i + j], detsum[j]);
+        }
+      }
+    }
+  }
+#endif /* SIMD_PREDICATES */
+  for (; i < count; i++) {
+    results[i] = counterclockwise(m, b, pa[i], pb[i], pc[i]);
+  }
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  incirclebatch()   Batched incircle() tests.                              */
+/*                                                                           */
+/*  results[i] = incircle(m, b, pa[i], pb[i], pc[i], pd[i]) for all i less   */
+/*  than `count'.                                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void incirclebatch(struct mesh *m, struct behavior *b, int count,
+                   vertex *pa, vertex *pb, vertex *pc, vertex *pd,
+                   REAL *results)
+#else /* not ANSI_DECLARATORS */
+void incirclebatch(m, b, count, pa, pb, pc, pd, results)
+struct mesh *m;
+struct behavior *b;
+int count;
+vertex *pa;
+vertex *pb;
+vertex *pc;
+vertex *pd;
+REAL *results;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  int i;
+#ifdef SIMD_PREDICATES
+  REAL permanent[2];
+  int uncertain;
+  int j;
+#endif /* SIMD_PREDICATES */
+
+  i = 0;
+#ifdef SIMD_PREDICATES
+  for (; count - i >= 2; i += 2) {
+    uncertain = incirclefilter2(&pa[i], &pb[i], &pc[i], &pd[i], &results[i],
+                                permanent);
+    m->incirclecount += 2;
+    if (!b->noexact) {
+      /* Exact arithmetic only for the lanes that need it. */
+      for (j = 0; j < 2; j++) {
+        if (uncertain & (1 << j)) {
+          m->incircleexactcount++;
+          results[i + j] = incircleadapt(pa[i + j], pb[i + j], pc[i + j],
+                                         pd[i + j], permanent[j]);
+        }
+      }
+    }
+  }
+#endif /* SIMD_PREDICATES */
+  for (; i < count; i++) {
+    results[i] = incircle(m, b, pa[i], pb[i], pc[i], pd[i]);
+  }
+}
+
 /*****************************************************************************/
 /*                                                                           */
 /*  orient3d()   Return a positive value if the point pd lies below the      */
@@ -6727,13 +7420,38 @@ struct mesh *m;
   poolzero(&m->badtriangles);
   poolzero(&m->flipstackers);
   poolzero(&m->splaynodes);
+  m->dummytribase = (triangle *) NULL;
+  m->dummysubbase = (subseg *) NULL;
+  m->dummytribytes = m->dummysubbytes = 0;
+
+  trianglerestart(m);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  trianglerestart()   Initialize the variables of an already used mesh.    */
+/*                                                                           */
+/*  Unlike triangleinit(), the memory pools of the mesh aren't reset, so     */
+/*  that they can be reused by the next triangulation (see poolreinit()).    */
+/*  (mrkkrj)                                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void trianglerestart(struct mesh *m)
+#else /* not ANSI_DECLARATORS */
+void trianglerestart(m)
+struct mesh *m;
+#endif /* not ANSI_DECLARATORS */
 
+{
   m->recenttri.tri = (triangle *) NULL; /* No triangle has been visited yet. */
   m->undeads = 0;                       /* No eliminated input vertices yet. */
   m->samples = 1;         /* Point location should take at least one sample. */
   m->checksegments = 0;   /* There are no segments in the triangulation yet. */
   m->checkquality = 0;     /* The quality triangulation stage has not begun. */
   m->incirclecount = m->counterclockcount = m->orient3dcount = 0;
+  m->incircleexactcount = m->counterclockexactcount = 0;
   m->hyperbolacount = m->circletopcount = m->circumcentercount = 0;
   randomseed = 1;
 
@@ -7159,10 +7877,55 @@ struct mesh *m;
 
 /*****************************************************************************/
 /*                                                                           */
-/*  checkseg4encroach()   Check a subsegment to see if it is encroached; add */
-/*                        it to the list if it is.                           */
+/*  inlens()   Check whether a vertex lies in the diametral lens of a        */
+/*             subsegment (the diametral circle if `conformdel' is set).     */
 /*                                                                           */
-/*  A subsegment is encroached if there is a vertex in its diametral lens.   */
+/*  A dot product of two sides of the triangle formed by the subsegment and  */
+/*  the vertex is used to check whether the angle at the vertex is greater   */
+/*  than (180 - 2 `minangle') degrees (for lenses; 90 degrees for diametral  */
+/*  circles).  (mrkkrj)                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef CDT_ONLY
+
+#ifdef ANSI_DECLARATORS
+int inlens(struct behavior *b, vertex eorg, vertex edest, vertex eapex)
+#else /* not ANSI_DECLARATORS */
+int inlens(b, eorg, edest, eapex)
+struct behavior *b;
+vertex eorg;
+vertex edest;
+vertex eapex;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  REAL dotproduct;
+
+  dotproduct = (eorg[0] - eapex[0]) * (edest[0] - eapex[0]) +
+               (eorg[1] - eapex[1]) * (edest[1] - eapex[1]);
+  if (dotproduct < 0.0) {
+    if (b->conformdel ||
+        (dotproduct * dotproduct >=
+         (2.0 * b->goodangle - 1.0) * (2.0 * b->goodangle - 1.0) *
+         ((eorg[0] - eapex[0]) * (eorg[0] - eapex[0]) +
+          (eorg[1] - eapex[1]) * (eorg[1] - eapex[1])) *
+         ((edest[0] - eapex[0]) * (edest[0] - eapex[0]) +
+          (edest[1] - eapex[1]) * (edest[1] - eapex[1])))) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+#endif /* not CDT_ONLY */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  checkseg4encroach()   Check a subsegment to see if it is encroached; add */
+/*                        it to the list if it is.                           */
+/*                                                                           */
+/*  A subsegment is encroached if there is a vertex in its diametral lens.   */
 /*  For Ruppert's algorithm (-D switch), the "diametral lens" is the         */
 /*  diametral circle.  For Chew's algorithm (default), the diametral lens is */
 /*  just big enough to enclose two isosceles triangles whose bases are the   */
@@ -7196,7 +7959,6 @@ struct osub *testsubseg;
   struct otri neighbortri;
   struct osub testsym;
   struct badsubseg *encroachedseg;
-  REAL dotproduct;
   int encroached;
   int sides;
   vertex eorg, edest, eapex;
@@ -7215,22 +7977,9 @@ struct osub *testsubseg;
     /* Find a vertex opposite this subsegment. */
     apex(neighbortri, eapex);
     /* Check whether the apex is in the diametral lens of the subsegment */
-    /*   (the diametral circle if `conformdel' is set).  A dot product   */
-    /*   of two sides of the triangle is used to check whether the angle */
-    /*   at the apex is greater than (180 - 2 `minangle') degrees (for   */
-    /*   lenses; 90 degrees for diametral circles).                      */
-    dotproduct = (eorg[0] - eapex[0]) * (edest[0] - eapex[0]) +
-                 (eorg[1] - eapex[1]) * (edest[1] - eapex[1]);
-    if (dotproduct < 0.0) {
-      if (b->conformdel ||
-          (dotproduct * dotproduct >=
-           (2.0 * b->goodangle - 1.0) * (2.0 * b->goodangle - 1.0) *
-           ((eorg[0] - eapex[0]) * (eorg[0] - eapex[0]) +
-            (eorg[1] - eapex[1]) * (eorg[1] - eapex[1])) *
-           ((edest[0] - eapex[0]) * (edest[0] - eapex[0]) +
-            (edest[1] - eapex[1]) * (edest[1] - eapex[1])))) {
-        encroached = 1;
-      }
+    /*   (the diametral circle if `conformdel' is set).                  */
+    if (inlens(b, eorg, edest, eapex)) {
+      encroached = 1;
     }
   }
   /* Check the other neighbor of the subsegment. */
@@ -7243,18 +7992,8 @@ struct osub *testsubseg;
     apex(neighbortri, eapex);
     /* Check whether the apex is in the diametral lens of the subsegment */
     /*   (or the diametral circle, if `conformdel' is set).              */
-    dotproduct = (eorg[0] - eapex[0]) * (edest[0] - eapex[0]) +
-                 (eorg[1] - eapex[1]) * (edest[1] - eapex[1]);
-    if (dotproduct < 0.0) {
-      if (b->conformdel ||
-          (dotproduct * dotproduct >=
-           (2.0 * b->goodangle - 1.0) * (2.0 * b->goodangle - 1.0) *
-           ((eorg[0] - eapex[0]) * (eorg[0] - eapex[0]) +
-            (eorg[1] - eapex[1]) * (eorg[1] - eapex[1])) *
-           ((edest[0] - eapex[0]) * (edest[0] - eapex[0]) +
-            (edest[1] - eapex[1]) * (edest[1] - eapex[1])))) {
-        encroached += 2;
-      }
+    if (inlens(b, eorg, edest, eapex)) {
+      encroached += 2;
     }
   }
 
@@ -7317,6 +8056,7 @@ struct otri *testtri;
   REAL apexlen, orglen, destlen, minedge;
   REAL angle;
   REAL area;
+  REAL edgelength;
   REAL dist1, dist2;
   subseg sptr;                      /* Temporary variable used by tspivot(). */
   triangle ptr;           /* Temporary variable used by oprev() and dnext(). */
@@ -7370,7 +8110,7 @@ struct otri *testtri;
     lprev(*testtri, tri1);
   }
 
-  if (b->vararea || b->fixedarea || b->usertest) {
+  if (b->vararea || b->fixedarea || b->usertest || (sizingfunc != nullptr)) {
     /* Check whether the area is larger than permitted. */
     area = 0.5 * (dxod * dyda - dyod * dxda);
     if (b->fixedarea && (area > b->maxarea)) {
@@ -7389,7 +8129,21 @@ struct otri *testtri;
 
     if (b->usertest) {
       /* Check whether the user thinks this triangle is too large. */
-      if (triunsuitable(torg, tdest, tapex, area)) {
+      if ((usertestfunc != nullptr) ?
+          usertestfunc(usertestcontext, torg, tdest, tapex, area) :
+          triunsuitable(torg, tdest, tapex, area)) {
+        enqueuebadtri(m, b, testtri, minedge, tapex, torg, tdest);
+        return;
+      }
+    }
+
+    if (sizingfunc != nullptr) {
+      /* Check the sizing field at the centroid (mrkkrj). */
+      edgelength = sizingfunc(sizingcontext,
+                              (torg[0] + tdest[0] + tapex[0]) / 3.0,
+                              (torg[1] + tdest[1] + tapex[1]) / 3.0);
+      if ((edgelength > 0.0) &&
+          (area > EQUILATERALAREA * edgelength * edgelength)) {
         enqueuebadtri(m, b, testtri, minedge, tapex, torg, tdest);
         return;
       }
@@ -7873,6 +8627,283 @@ struct otri *searchtri;
   return preciselocate(m, b, searchpoint, searchtri, 0);
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  walklocate()   Find a triangle or edge containing a given point, walking */
+/*                 from an arbitrary live triangle.  (mrkkrj)                */
+/*                                                                           */
+/*  Unlike locate(), no random samples are drawn and no state of the mesh    */
+/*  besides its statistic counters is changed, so that several threads can  */
+/*  search the same mesh, each with its own copy of the mesh record.         */
+/*                                                                           */
+/*  `searchtri' may be any live triangle; the results are the same as those  */
+/*  of preciselocate().                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+enum locateresult walklocate(struct mesh *m, struct behavior *b,
+                             vertex searchpoint, struct otri *searchtri)
+#else /* not ANSI_DECLARATORS */
+enum locateresult walklocate(m, b, searchpoint, searchtri)
+struct mesh *m;
+struct behavior *b;
+vertex searchpoint;
+struct otri *searchtri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  vertex torg, tdest;
+  int i;
+
+  /* Screen out the starting triangle's vertices. */
+  for (i = 0; i < 3; i++) {
+    org(*searchtri, torg);
+    if ((torg[0] == searchpoint[0]) && (torg[1] == searchpoint[1])) {
+      return ONVERTEX;
+    }
+    lnextself(*searchtri);
+  }
+  /* The three orientations sum up to the triangle's area, so at least */
+  /*   one edge has `searchpoint' strictly to its left.                */
+  for (i = 0; i < 3; i++) {
+    org(*searchtri, torg);
+    dest(*searchtri, tdest);
+    if (counterclockwise(m, b, torg, tdest, searchpoint) > 0.0) {
+      break;
+    }
+    lnextself(*searchtri);
+  }
+  return preciselocate(m, b, searchpoint, searchtri, 0);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  scanlocate()   Find a triangle or edge containing a given point by       */
+/*                 testing all triangles of the mesh.  (mrkkrj)              */
+/*                                                                           */
+/*  Used when walking fails because holes or concavities are in the way.     */
+/*  Traverses the triangle pool, so `m' should be a thread's own copy of the */
+/*  mesh record.  Returns OUTSIDE, leaving `searchtri' alone, if no triangle */
+/*  contains the point.                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+enum locateresult scanlocate(struct mesh *m, struct behavior *b,
+                             vertex searchpoint, struct otri *searchtri)
+#else /* not ANSI_DECLARATORS */
+enum locateresult scanlocate(m, b, searchpoint, searchtri)
+struct mesh *m;
+struct behavior *b;
+vertex searchpoint;
+struct otri *searchtri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri candidate;
+  vertex torg, tdest, tapex;
+
+  candidate.orient = 0;
+  traversalinit(&m->triangles);
+  candidate.tri = triangletraverse(m);
+  while (candidate.tri != (triangle *) NULL) {
+    org(candidate, torg);
+    dest(candidate, tdest);
+    apex(candidate, tapex);
+    /* Cheap bounding box test first. */
+    if (!(((searchpoint[0] < torg[0]) && (searchpoint[0] < tdest[0]) &&
+           (searchpoint[0] < tapex[0])) ||
+          ((searchpoint[0] > torg[0]) && (searchpoint[0] > tdest[0]) &&
+           (searchpoint[0] > tapex[0])) ||
+          ((searchpoint[1] < torg[1]) && (searchpoint[1] < tdest[1]) &&
+           (searchpoint[1] < tapex[1])) ||
+          ((searchpoint[1] > torg[1]) && (searchpoint[1] > tdest[1]) &&
+           (searchpoint[1] > tapex[1])))) {
+      if ((counterclockwise(m, b, torg, tdest, searchpoint) >= 0.0) &&
+          (counterclockwise(m, b, tdest, tapex, searchpoint) >= 0.0) &&
+          (counterclockwise(m, b, tapex, torg, searchpoint) >= 0.0)) {
+        otricopy(candidate, *searchtri);
+        return walklocate(m, b, searchpoint, searchtri);
+      }
+    }
+    candidate.tri = triangletraverse(m);
+  }
+  return OUTSIDE;
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  locatebatch()   Locate a batch of points in a finished mesh.  (mrkkrj)   */
+/*                                                                           */
+/*  `searchpoints' holds `count' points as x, y pairs.  For each point the   */
+/*  result of the search is stored in `results' and the triangle found, with */
+/*  the same meaning as for preciselocate(), in `searchtris'.                */
+/*                                                                           */
+/*  The points are sorted along a Hilbert curve, so that each search walks   */
+/*  from the triangle found for the previous, nearby point.  Runs of sorted  */
+/*  points are searched by up to `threads' threads, each with its own copy   */
+/*  of the mesh record; the mesh itself isn't changed.                       */
+/*                                                                           */
+/*  If holes or concavities were carved, a point for which the walk ends in  */
+/*  the outer space, but lies within the bounding box of the vertices, is    */
+/*  looked for by scanlocate(), which tests all triangles of the mesh.       */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+struct locatequery {
+  unsigned long long key;                      /* Position on Hilbert curve. */
+  int index;                                  /* Position in `searchpoints'. */
+};
+
+#ifdef ANSI_DECLARATORS
+void locatebatch(struct mesh *m, struct behavior *b, REAL *searchpoints,
+                 int count, enum locateresult *results,
+                 struct otri *searchtris, int threads)
+#else /* not ANSI_DECLARATORS */
+void locatebatch(m, b, searchpoints, count, results, searchtris, threads)
+struct mesh *m;
+struct behavior *b;
+REAL *searchpoints;
+int count;
+enum locateresult *results;
+struct otri *searchtris;
+int threads;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct locatequery *queries;
+  std::unique_ptr<tpp::WorkStealingPool> pool;
+  struct mesh *bboxmesh;
+  struct otri starttri;
+  vertex vertexloop;
+  REAL cellpoint[2];
+  REAL xmin, xmax, ymin, ymax;
+  REAL width;
+  REAL scale;
+  long counterclockcount, counterclockexactcount;
+  int nonconvex;
+  int chunks;
+  int i;
+
+  if (count <= 0) {
+    return;
+  }
+  if (m->triangles.items == 0) {
+    for (i = 0; i < count; i++) {
+      results[i] = OUTSIDE;
+      searchtris[i].tri = m->dummytri;
+      searchtris[i].orient = 0;
+    }
+    return;
+  }
+
+  /* Find a live triangle to start from and the actual bounding box of the */
+  /*   vertices, which may have changed since the mesh was created.  The   */
+  /*   mesh records are too big for the stack.                             */
+  bboxmesh = (struct mesh *) trimalloc((int) sizeof(struct mesh));
+  memcpy(bboxmesh, m, sizeof(struct mesh));
+  traversalinit(&bboxmesh->triangles);
+  starttri.tri = triangletraverse(bboxmesh);
+  starttri.orient = 0;
+  traversalinit(&bboxmesh->vertices);
+  vertexloop = vertextraverse(bboxmesh);
+  xmin = xmax = vertexloop[0];
+  ymin = ymax = vertexloop[1];
+  while (vertexloop != (vertex) NULL) {
+    xmin = (vertexloop[0] < xmin) ? vertexloop[0] : xmin;
+    xmax = (vertexloop[0] > xmax) ? vertexloop[0] : xmax;
+    ymin = (vertexloop[1] < ymin) ? vertexloop[1] : ymin;
+    ymax = (vertexloop[1] > ymax) ? vertexloop[1] : ymax;
+    vertexloop = vertextraverse(bboxmesh);
+  }
+  trifree((VOID *) bboxmesh);
+  nonconvex = b->poly && (!b->convex || (m->holes > 0));
+
+  /* Sort the queries along a Hilbert curve over the bounding box; points */
+  /*   outside of it are moved onto its border.                           */
+  queries = (struct locatequery *)
+            trimalloc(count * (int) sizeof(struct locatequery));
+  width = m->xmax - m->xmin;
+  if (m->ymax - m->ymin > width) {
+    width = m->ymax - m->ymin;
+  }
+  scale = (width > 0.0) ? (REAL) ((1ul << HILBERTBITS) - 1ul) / width : 0.0;
+  for (i = 0; i < count; i++) {
+    cellpoint[0] = searchpoints[2 * i];
+    cellpoint[1] = searchpoints[2 * i + 1];
+    cellpoint[0] = (cellpoint[0] < m->xmin) ? m->xmin :
+                   (cellpoint[0] > m->xmin + width) ? m->xmin + width :
+                   cellpoint[0];
+    cellpoint[1] = (cellpoint[1] < m->ymin) ? m->ymin :
+                   (cellpoint[1] > m->ymin + width) ? m->ymin + width :
+                   cellpoint[1];
+    if (!(cellpoint[0] == cellpoint[0]) || !(cellpoint[1] == cellpoint[1])) {
+      /* NaN coordinates. */
+      cellpoint[0] = m->xmin;
+      cellpoint[1] = m->ymin;
+    }
+    queries[i].key = hilbertindex(m, scale, cellpoint);
+    queries[i].index = i;
+  }
+  std::sort(queries, queries + count,
+            [](const struct locatequery &q1, const struct locatequery &q2)
+            { return q1.key < q2.key; });
+
+  chunks = (count + LOCATECHUNKSIZE - 1) / LOCATECHUNKSIZE;
+  if (chunks > threads) {
+    chunks = threads;
+  }
+  if (chunks < 1) {
+    chunks = 1;
+  }
+  if (chunks > 1) {
+    pool.reset(new tpp::WorkStealingPool(chunks - 1));
+  }
+
+  counterclockcount = counterclockexactcount = 0;
+  std::mutex countmutex;
+  vertexchunks(pool.get(), chunks, [&](int chunk) {
+    struct mesh *workmesh;
+    struct otri searchtri;
+    vertex searchpoint;
+    int first, last;
+    int q, index;
+
+    workmesh = (struct mesh *) trimalloc((int) sizeof(struct mesh));
+    memcpy(workmesh, m, sizeof(struct mesh));
+    workmesh->counterclockcount = 0;
+    workmesh->counterclockexactcount = 0;
+    first = (int) ((long long) count * chunk / chunks);
+    last = (int) ((long long) count * (chunk + 1) / chunks);
+    otricopy(starttri, searchtri);
+    for (q = first; q < last; q++) {
+      index = queries[q].index;
+      searchpoint = &searchpoints[2 * index];
+      results[index] = walklocate(workmesh, b, searchpoint, &searchtri);
+      if ((results[index] == OUTSIDE) && nonconvex &&
+          (searchpoint[0] >= xmin) && (searchpoint[0] <= xmax) &&
+          (searchpoint[1] >= ymin) && (searchpoint[1] <= ymax)) {
+        results[index] = scanlocate(workmesh, b, searchpoint, &searchtri);
+      }
+      otricopy(searchtri, searchtris[index]);
+    }
+
+    std::lock_guard<std::mutex> lock(countmutex);
+    counterclockcount += workmesh->counterclockcount;
+    counterclockexactcount += workmesh->counterclockexactcount;
+    trifree((VOID *) workmesh);
+  });
+  m->counterclockcount += counterclockcount;
+  m->counterclockexactcount += counterclockexactcount;
+
+  trifree((VOID *) queries);
+}
+
+#endif /* not REDUCED */
+
 /**                                                                         **/
 /**                                                                         **/
 /********* Point location routines end here                          *********/
@@ -9115,13 +10146,16 @@ struct otri *deltri;
   sym(righttri, rightcasing);
   bond(*deltri, leftcasing);
   bond(deltriright, rightcasing);
-  tspivot(lefttri, leftsubseg);
-  if (leftsubseg.ss != m->dummysub) {
-    tsbond(*deltri, leftsubseg);
-  }
-  tspivot(righttri, rightsubseg);
-  if (rightsubseg.ss != m->dummysub) {
-    tsbond(deltriright, rightsubseg);
+  /* Triangles have no subsegment pointers if segments aren't used. (mrkkrj) */
+  if (b->usesegments) {
+    tspivot(lefttri, leftsubseg);
+    if (leftsubseg.ss != m->dummysub) {
+      tsbond(*deltri, leftsubseg);
+    }
+    tspivot(righttri, rightsubseg);
+    if (rightsubseg.ss != m->dummysub) {
+      tsbond(deltriright, rightsubseg);
+    }
   }
 
   /* Set the new origin of `deltri' and check its quality. */
@@ -9515,112 +10549,462 @@ int axis;
 
 /*****************************************************************************/
 /*                                                                           */
-/*  mergehulls()   Merge two adjacent Delaunay triangulations into a         */
-/*                 single Delaunay triangulation.                            */
+/*  radixkey()   Map a coordinate to an unsigned integer of the same order.  */
+/*               (mrkkrj)                                                    */
 /*                                                                           */
-/*  This is similar to the algorithm given by Guibas and Stolfi, but uses    */
-/*  a triangle-based, rather than edge-based, data structure.                */
+/*  Flips the sign bit of positive numbers and all bits of negative ones, so */
+/*  that the IEEE bit patterns compare like the numbers.  Negative zero is   */
+/*  mapped to positive zero, as the two compare equal.                       */
 /*                                                                           */
-/*  The algorithm walks up the gap between the two triangulations, knitting  */
-/*  them together.  As they are merged, some of their bounding triangles     */
-/*  are converted into real triangles of the triangulation.  The procedure   */
-/*  pulls each hull's bounding triangles apart, then knits them together     */
-/*  like the teeth of two gears.  The Delaunay property determines, at each  */
-/*  step, whether the next "tooth" is a bounding triangle of the left hull   */
-/*  or the right.  When a bounding triangle becomes real, its apex is        */
-/*  changed from NULL to a real vertex.                                      */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+unsigned long long radixkey(REAL coordinate)
+#else /* not ANSI_DECLARATORS */
+unsigned long long radixkey(coordinate)
+REAL coordinate;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  unsigned long long bits;
+  double value;
+
+  value = (coordinate == 0.0) ? 0.0 : (double) coordinate;
+  memcpy(&bits, &value, sizeof(bits));
+  if (bits & 0x8000000000000000ull) {
+    return ~bits;
+  }
+  return bits | 0x8000000000000000ull;
+}
+
+/*****************************************************************************/
 /*                                                                           */
-/*  Only two new triangles need to be allocated.  These become new bounding  */
-/*  triangles at the top and bottom of the seam.  They are used to connect   */
-/*  the remaining bounding triangles (those that have not been converted     */
-/*  into real triangles) into a single fan.                                  */
+/*  vertexchunks()   Run `work' for `chunks' consecutive chunks of an array, */
+/*                   using the thread pool if there is one.  (mrkkrj)        */
 /*                                                                           */
-/*  On entry, `farleft' and `innerleft' are bounding triangles of the left   */
-/*  triangulation.  The origin of `farleft' is the leftmost vertex, and      */
-/*  the destination of `innerleft' is the rightmost vertex of the            */
-/*  triangulation.  Similarly, `innerright' and `farright' are bounding      */
-/*  triangles of the right triangulation.  The origin of `innerright' and    */
-/*  destination of `farright' are the leftmost and rightmost vertices.       */
+/*****************************************************************************/
+
+template <typename ChunkWork>
+void vertexchunks(tpp::WorkStealingPool *pool, int chunks, ChunkWork work)
+{
+  int chunk;
+
+  if (pool == (tpp::WorkStealingPool *) NULL) {
+    for (chunk = 0; chunk < chunks; chunk++) {
+      work(chunk);
+    }
+    return;
+  }
+
+  tpp::TaskGroup group(*pool);
+  for (chunk = 1; chunk < chunks; chunk++) {
+    group.run([=]() { work(chunk); });
+  }
+  work(0);
+  group.wait();
+}
+
+/*****************************************************************************/
 /*                                                                           */
-/*  On completion, the origin of `farleft' is the leftmost vertex of the     */
-/*  merged triangulation, and the destination of `farright' is the rightmost */
-/*  vertex.                                                                  */
+/*  vertexkeys()   Create an array of the vertices paired with the integer   */
+/*                 keys of their coordinates.  (mrkkrj)                      */
 /*                                                                           */
 /*****************************************************************************/
 
+struct vertexkey {
+  unsigned long long key[2];                    /* radixkey() of x and y. */
+  vertex point;
+};
+
 #ifdef ANSI_DECLARATORS
-void mergehulls(struct mesh *m, struct behavior *b, struct otri *farleft,
-                struct otri *innerleft, struct otri *innerright,
-                struct otri *farright, int axis)
+struct vertexkey *vertexkeys(tpp::WorkStealingPool *pool, vertex *sortarray,
+                             int arraysize, int chunks)
 #else /* not ANSI_DECLARATORS */
-void mergehulls(m, b, farleft, innerleft, innerright, farright, axis)
-struct mesh *m;
-struct behavior *b;
-struct otri *farleft;
-struct otri *innerleft;
-struct otri *innerright;
-struct otri *farright;
-int axis;
+struct vertexkey *vertexkeys(pool, sortarray, arraysize, chunks)
+tpp::WorkStealingPool *pool;
+vertex *sortarray;
+int arraysize;
+int chunks;
 #endif /* not ANSI_DECLARATORS */
 
 {
-  struct otri leftcand, rightcand;
-  struct otri baseedge;
-  struct otri nextedge;
-  struct otri sidecasing, topcasing, outercasing;
-  struct otri checkedge;
-  vertex innerleftdest;
-  vertex innerrightorg;
-  vertex innerleftapex, innerrightapex;
-  vertex farleftpt, farrightpt;
-  vertex farleftapex, farrightapex;
-  vertex lowerleft, lowerright;
-  vertex upperleft, upperright;
-  vertex nextapex;
-  vertex checkvertex;
-  int changemade;
-  int badedge;
-  int leftfinished, rightfinished;
-  triangle ptr;                         /* Temporary variable used by sym(). */
+  struct vertexkey *keyarray;
+
+  keyarray = (struct vertexkey *)
+             trimalloc(arraysize * (int) sizeof(struct vertexkey));
+  vertexchunks(pool, chunks, [=](int chunk) {
+    int first = (int) ((long long) arraysize * chunk / chunks);
+    int last = (int) ((long long) arraysize * (chunk + 1) / chunks);
+    for (int i = first; i < last; i++) {
+      keyarray[i].key[0] = radixkey(sortarray[i][0]);
+      keyarray[i].key[1] = radixkey(sortarray[i][1]);
+      keyarray[i].point = sortarray[i];
+    }
+  });
+  return keyarray;
+}
 
-  dest(*innerleft, innerleftdest);
-  apex(*innerleft, innerleftapex);
-  org(*innerright, innerrightorg);
-  apex(*innerright, innerrightapex);
-  /* Special treatment for horizontal cuts. */
-  if (b->dwyer && (axis == 1)) {
-    org(*farleft, farleftpt);
-    apex(*farleft, farleftapex);
-    dest(*farright, farrightpt);
-    apex(*farright, farrightapex);
-    /* The pointers to the extremal vertices are shifted to point to the */
-    /*   topmost and bottommost vertex of each hull, rather than the     */
-    /*   leftmost and rightmost vertices.                                */
-    while (farleftapex[1] < farleftpt[1]) {
-      lnextself(*farleft);
-      symself(*farleft);
-      farleftpt = farleftapex;
-      apex(*farleft, farleftapex);
-    }
-    sym(*innerleft, checkedge);
-    apex(checkedge, checkvertex);
-    while (checkvertex[1] > innerleftdest[1]) {
-      lnext(checkedge, *innerleft);
-      innerleftapex = innerleftdest;
-      innerleftdest = checkvertex;
-      sym(*innerleft, checkedge);
-      apex(checkedge, checkvertex);
-    }
-    while (innerrightapex[1] < innerrightorg[1]) {
-      lnextself(*innerright);
-      symself(*innerright);
-      innerrightorg = innerrightapex;
-      apex(*innerright, innerrightapex);
-    }
-    sym(*farright, checkedge);
-    apex(checkedge, checkvertex);
-    while (checkvertex[1] > farrightpt[1]) {
-      lnext(checkedge, *farright);
+/*****************************************************************************/
+/*                                                                           */
+/*  vertexunkeys()   Copy the vertices of an array made by vertexkeys() back */
+/*                   to `sortarray' and free the array.  (mrkkrj)            */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void vertexunkeys(tpp::WorkStealingPool *pool, struct vertexkey *keyarray,
+                  vertex *sortarray, int arraysize, int chunks)
+#else /* not ANSI_DECLARATORS */
+void vertexunkeys(pool, keyarray, sortarray, arraysize, chunks)
+tpp::WorkStealingPool *pool;
+struct vertexkey *keyarray;
+vertex *sortarray;
+int arraysize;
+int chunks;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  vertexchunks(pool, chunks, [=](int chunk) {
+    int first = (int) ((long long) arraysize * chunk / chunks);
+    int last = (int) ((long long) arraysize * (chunk + 1) / chunks);
+    for (int i = first; i < last; i++) {
+      sortarray[i] = keyarray[i].point;
+    }
+  });
+  trifree((VOID *) keyarray);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  vertexchunkcount()   Number of chunks an array of vertices is split into */
+/*                       for the thread pool.  (mrkkrj)                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+int vertexchunkcount(tpp::WorkStealingPool *pool, int arraysize)
+#else /* not ANSI_DECLARATORS */
+int vertexchunkcount(pool, arraysize)
+tpp::WorkStealingPool *pool;
+int arraysize;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  int chunks;
+
+  if (pool == (tpp::WorkStealingPool *) NULL) {
+    return 1;
+  }
+  chunks = (int) pool->size() + 1;
+  if (chunks > arraysize / RADIXSORTSIZE) {
+    chunks = arraysize / RADIXSORTSIZE;
+  }
+  return (chunks > 1) ? chunks : 1;
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  vertexradixsort()   Sort an array of vertices by x-coordinate, using the */
+/*                      y-coordinate as a secondary key.  (mrkkrj)           */
+/*                                                                           */
+/*  A least significant digit radix sort of the x-keys of the vertices,      */
+/*  which doesn't touch the vertices in the passes, followed by sorting the  */
+/*  (rare) runs of equal x-coordinates by y.  Digits shared by all of the    */
+/*  keys are skipped.  Each pass counts and scatters the keys in chunks,     */
+/*  one per thread of `pool', which may be NULL.  O(n) time.                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void vertexradixsort(tpp::WorkStealingPool *pool, vertex *sortarray,
+                     int arraysize)
+#else /* not ANSI_DECLARATORS */
+void vertexradixsort(pool, sortarray, arraysize)
+tpp::WorkStealingPool *pool;
+vertex *sortarray;
+int arraysize;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct vertexkey *keyarray, *bufferarray, *swap;
+  int *bucketcount;
+  int chunks, chunk;
+  int bucket, shift;
+  int total, count;
+  int i, j;
+
+  chunks = vertexchunkcount(pool, arraysize);
+  keyarray = vertexkeys(pool, sortarray, arraysize, chunks);
+  bufferarray = (struct vertexkey *)
+                trimalloc(arraysize * (int) sizeof(struct vertexkey));
+  bucketcount = (int *) trimalloc(chunks * (1 << RADIXBITS) *
+                                  (int) sizeof(int));
+
+  for (shift = 0; shift < 64; shift += RADIXBITS) {
+    /* Count the digits of each chunk. */
+    vertexchunks(pool, chunks, [=](int chunk) {
+      int first = (int) ((long long) arraysize * chunk / chunks);
+      int last = (int) ((long long) arraysize * (chunk + 1) / chunks);
+      int *counts = &bucketcount[chunk << RADIXBITS];
+      memset(counts, 0, (1 << RADIXBITS) * sizeof(int));
+      for (int i = first; i < last; i++) {
+        counts[(keyarray[i].key[0] >> shift) & ((1 << RADIXBITS) - 1)]++;
+      }
+    });
+    /* Skip the digit if all the keys share it. */
+    bucket = (int) ((keyarray[0].key[0] >> shift) & ((1 << RADIXBITS) - 1));
+    total = 0;
+    for (chunk = 0; chunk < chunks; chunk++) {
+      total += bucketcount[(chunk << RADIXBITS) + bucket];
+    }
+    if (total == arraysize) {
+      continue;
+    }
+    /* Turn the counts into the chunks' first positions in each bucket. */
+    total = 0;
+    for (bucket = 0; bucket < (1 << RADIXBITS); bucket++) {
+      for (chunk = 0; chunk < chunks; chunk++) {
+        count = bucketcount[(chunk << RADIXBITS) + bucket];
+        bucketcount[(chunk << RADIXBITS) + bucket] = total;
+        total += count;
+      }
+    }
+    /* Move the keys to their buckets. */
+    vertexchunks(pool, chunks, [=](int chunk) {
+      int first = (int) ((long long) arraysize * chunk / chunks);
+      int last = (int) ((long long) arraysize * (chunk + 1) / chunks);
+      int *positions = &bucketcount[chunk << RADIXBITS];
+      for (int i = first; i < last; i++) {
+        bufferarray[positions[(keyarray[i].key[0] >> shift) &
+                              ((1 << RADIXBITS) - 1)]++] = keyarray[i];
+      }
+    });
+    swap = keyarray;
+    keyarray = bufferarray;
+    bufferarray = swap;
+  }
+
+  trifree((VOID *) bucketcount);
+  trifree((VOID *) bufferarray);
+
+  /* Sort the runs of equal x-coordinates by y. */
+  i = 0;
+  while (i < arraysize) {
+    j = i + 1;
+    while ((j < arraysize) && (keyarray[j].key[0] == keyarray[i].key[0])) {
+      j++;
+    }
+    if (j - i > 1) {
+      std::sort(keyarray + i, keyarray + j,
+                [](const struct vertexkey &v1, const struct vertexkey &v2)
+                { return v1.key[1] < v2.key[1]; });
+    }
+    i = j;
+  }
+
+  vertexunkeys(pool, keyarray, sortarray, arraysize, chunks);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  alternatekeys()   Sorts the vertices as appropriate for the divide-and-  */
+/*                    conquer algorithm with alternating cuts.  (mrkkrj)     */
+/*                                                                           */
+/*  Does the same as alternateaxes(), but partitions an array made by        */
+/*  vertexkeys() with nth_element(), and hands one of the halves of big      */
+/*  subsets to the thread pool, if there is one.  As the partitions are the  */
+/*  same, so is the final order of the vertices.                             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void alternatekeys(tpp::WorkStealingPool *pool, struct vertexkey *keyarray,
+                   int arraysize, int axis)
+#else /* not ANSI_DECLARATORS */
+void alternatekeys(pool, keyarray, arraysize, axis)
+tpp::WorkStealingPool *pool;
+struct vertexkey *keyarray;
+int arraysize;
+int axis;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  int divider;
+
+  divider = arraysize >> 1;
+  if (arraysize <= 3) {
+    /* Recursive base case:  subsets of two or three vertices will be    */
+    /*   handled specially, and should always be sorted by x-coordinate. */
+    axis = 0;
+  }
+  /* Partition with a horizontal or vertical cut. */
+  std::nth_element(keyarray, keyarray + divider, keyarray + arraysize,
+                   [=](const struct vertexkey &v1, const struct vertexkey &v2)
+                   { return (v1.key[axis] < v2.key[axis]) ||
+                            ((v1.key[axis] == v2.key[axis]) &&
+                             (v1.key[1 - axis] < v2.key[1 - axis])); });
+  /* Recursively partition the subsets with a cross cut. */
+  if (arraysize - divider >= 2) {
+    if ((pool != (tpp::WorkStealingPool *) NULL) &&
+        (divider >= RADIXSORTSIZE)) {
+      tpp::TaskGroup group(*pool);
+      group.run([=]() {
+        alternatekeys(pool, keyarray, divider, 1 - axis);
+      });
+      alternatekeys(pool, &keyarray[divider], arraysize - divider, 1 - axis);
+      group.wait();
+    } else {
+      if (divider >= 2) {
+        alternatekeys(pool, keyarray, divider, 1 - axis);
+      }
+      alternatekeys(pool, &keyarray[divider], arraysize - divider, 1 - axis);
+    }
+  }
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  alternateaxeskeyed()   Sorts the vertices as appropriate for the divide- */
+/*                         and-conquer algorithm with alternating cuts,      */
+/*                         using integer keys.  (mrkkrj)                     */
+/*                                                                           */
+/*  Meant for big arrays, for which alternateaxes() spends most of its time  */
+/*  in fetching the coordinates of the vertices from the vertex pool.        */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void alternateaxeskeyed(tpp::WorkStealingPool *pool, vertex *sortarray,
+                        int arraysize, int axis)
+#else /* not ANSI_DECLARATORS */
+void alternateaxeskeyed(pool, sortarray, arraysize, axis)
+tpp::WorkStealingPool *pool;
+vertex *sortarray;
+int arraysize;
+int axis;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct vertexkey *keyarray;
+  int chunks;
+
+  chunks = vertexchunkcount(pool, arraysize);
+  keyarray = vertexkeys(pool, sortarray, arraysize, chunks);
+  alternatekeys(pool, keyarray, arraysize, axis);
+  vertexunkeys(pool, keyarray, sortarray, arraysize, chunks);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  mergehulls()   Merge two adjacent Delaunay triangulations into a         */
+/*                 single Delaunay triangulation.                            */
+/*                                                                           */
+/*  This is similar to the algorithm given by Guibas and Stolfi, but uses    */
+/*  a triangle-based, rather than edge-based, data structure.                */
+/*                                                                           */
+/*  The algorithm walks up the gap between the two triangulations, knitting  */
+/*  them together.  As they are merged, some of their bounding triangles     */
+/*  are converted into real triangles of the triangulation.  The procedure   */
+/*  pulls each hull's bounding triangles apart, then knits them together     */
+/*  like the teeth of two gears.  The Delaunay property determines, at each  */
+/*  step, whether the next "tooth" is a bounding triangle of the left hull   */
+/*  or the right.  When a bounding triangle becomes real, its apex is        */
+/*  changed from NULL to a real vertex.                                      */
+/*                                                                           */
+/*  Only two new triangles need to be allocated.  These become new bounding  */
+/*  triangles at the top and bottom of the seam.  They are used to connect   */
+/*  the remaining bounding triangles (those that have not been converted     */
+/*  into real triangles) into a single fan.                                  */
+/*                                                                           */
+/*  On entry, `farleft' and `innerleft' are bounding triangles of the left   */
+/*  triangulation.  The origin of `farleft' is the leftmost vertex, and      */
+/*  the destination of `innerleft' is the rightmost vertex of the            */
+/*  triangulation.  Similarly, `innerright' and `farright' are bounding      */
+/*  triangles of the right triangulation.  The origin of `innerright' and    */
+/*  destination of `farright' are the leftmost and rightmost vertices.       */
+/*                                                                           */
+/*  On completion, the origin of `farleft' is the leftmost vertex of the     */
+/*  merged triangulation, and the destination of `farright' is the rightmost */
+/*  vertex.                                                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void mergehulls(struct mesh *m, struct behavior *b, struct otri *farleft,
+                struct otri *innerleft, struct otri *innerright,
+                struct otri *farright, int axis)
+#else /* not ANSI_DECLARATORS */
+void mergehulls(m, b, farleft, innerleft, innerright, farright, axis)
+struct mesh *m;
+struct behavior *b;
+struct otri *farleft;
+struct otri *innerleft;
+struct otri *innerright;
+struct otri *farright;
+int axis;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri leftcand, rightcand;
+  struct otri baseedge;
+  struct otri nextedge;
+  struct otri sidecasing, topcasing, outercasing;
+  struct otri checkedge;
+  vertex innerleftdest;
+  vertex innerrightorg;
+  vertex innerleftapex, innerrightapex;
+  vertex farleftpt, farrightpt;
+  vertex farleftapex, farrightapex;
+  vertex lowerleft, lowerright;
+  vertex upperleft, upperright;
+  vertex nextapex;
+  vertex leftapex, rightapex;
+  vertex checkvertex;
+  vertex testa[2], testb[2], testc[2], testd[2];
+  REAL testresult[2];
+  int changemade;
+  int badedge;
+  int leftfinished, rightfinished;
+  triangle ptr;                         /* Temporary variable used by sym(). */
+
+  dest(*innerleft, innerleftdest);
+  apex(*innerleft, innerleftapex);
+  org(*innerright, innerrightorg);
+  apex(*innerright, innerrightapex);
+  /* Special treatment for horizontal cuts. */
+  if (b->dwyer && (axis == 1)) {
+    org(*farleft, farleftpt);
+    apex(*farleft, farleftapex);
+    dest(*farright, farrightpt);
+    apex(*farright, farrightapex);
+    /* The pointers to the extremal vertices are shifted to point to the */
+    /*   topmost and bottommost vertex of each hull, rather than the     */
+    /*   leftmost and rightmost vertices.                                */
+    while (farleftapex[1] < farleftpt[1]) {
+      lnextself(*farleft);
+      symself(*farleft);
+      farleftpt = farleftapex;
+      apex(*farleft, farleftapex);
+    }
+    sym(*innerleft, checkedge);
+    apex(checkedge, checkvertex);
+    while (checkvertex[1] > innerleftdest[1]) {
+      lnext(checkedge, *innerleft);
+      innerleftapex = innerleftdest;
+      innerleftdest = checkvertex;
+      sym(*innerleft, checkedge);
+      apex(checkedge, checkvertex);
+    }
+    while (innerrightapex[1] < innerrightorg[1]) {
+      lnextself(*innerright);
+      symself(*innerright);
+      innerrightorg = innerrightapex;
+      apex(*innerright, innerrightapex);
+    }
+    sym(*farright, checkedge);
+    apex(checkedge, checkvertex);
+    while (checkvertex[1] > farrightpt[1]) {
+      lnext(checkedge, *farright);
       farrightapex = farrightpt;
       farrightpt = checkvertex;
       sym(*farright, checkedge);
@@ -9687,10 +11071,14 @@ int axis;
     /*   because even though the left triangulation might seem finished now, */
     /*   moving up on the right triangulation might reveal a new vertex of   */
     /*   the left triangulation.  And vice-versa.)                           */
-    leftfinished = counterclockwise(m, b, upperleft, lowerleft, lowerright) <=
-                   0.0;
-    rightfinished = counterclockwise(m, b, upperright, lowerleft, lowerright)
-                 <= 0.0;
+    /* Both tests at once. */
+    testa[0] = upperleft;
+    testa[1] = upperright;
+    testb[0] = testb[1] = lowerleft;
+    testc[0] = testc[1] = lowerright;
+    counterclockwisebatch(m, b, 2, testa, testb, testc, testresult);
+    leftfinished = testresult[0] <= 0.0;
+    rightfinished = testresult[1] <= 0.0;
     if (leftfinished && rightfinished) {
       /* Create the top new bounding triangle. */
       maketriangle(m, b, &nextedge);
@@ -9734,6 +11122,36 @@ int axis;
       }
       return;
     }
+    /* The first edges to be checked on both sides don't depend on each */
+    /*   other, so both tests can be done at once.  Flips on one side    */
+    /*   leave the other side's edge and its vertices unchanged, so the  */
+    /*   result of the right side's test is still valid below.           */
+    leftapex = rightapex = (vertex) NULL;
+    if (!leftfinished) {
+      lprev(leftcand, nextedge);
+      symself(nextedge);
+      apex(nextedge, leftapex);
+    }
+    if (!rightfinished) {
+      lnext(rightcand, nextedge);
+      symself(nextedge);
+      apex(nextedge, rightapex);
+    }
+    if ((leftapex != (vertex) NULL) && (rightapex != (vertex) NULL)) {
+      testa[0] = testa[1] = lowerleft;
+      testb[0] = testb[1] = lowerright;
+      testc[0] = upperleft;
+      testc[1] = upperright;
+      testd[0] = leftapex;
+      testd[1] = rightapex;
+      incirclebatch(m, b, 2, testa, testb, testc, testd, testresult);
+    } else if (leftapex != (vertex) NULL) {
+      testresult[0] = incircle(m, b, lowerleft, lowerright, upperleft,
+                               leftapex);
+    } else if (rightapex != (vertex) NULL) {
+      testresult[1] = incircle(m, b, lowerleft, lowerright, upperright,
+                               rightapex);
+    }
     /* Consider eliminating edges from the left triangulation. */
     if (!leftfinished) {
       /* What vertex would be exposed if an edge were deleted? */
@@ -9743,9 +11161,8 @@ int axis;
       /* If nextapex is NULL, then no vertex would be exposed; the */
       /*   triangulation would have been eaten right through.      */
       if (nextapex != (vertex) NULL) {
-        /* Check whether the edge is Delaunay. */
-        badedge = incircle(m, b, lowerleft, lowerright, upperleft, nextapex) >
-                  0.0;
+        /* Check whether the edge is Delaunay (tested above). */
+        badedge = testresult[0] > 0.0;
         while (badedge) {
           /* Eliminate the edge with an edge flip.  As a result, the    */
           /*   left triangulation will have one more boundary triangle. */
@@ -9791,9 +11208,8 @@ int axis;
       /* If nextapex is NULL, then no vertex would be exposed; the */
       /*   triangulation would have been eaten right through.      */
       if (nextapex != (vertex) NULL) {
-        /* Check whether the edge is Delaunay. */
-        badedge = incircle(m, b, lowerleft, lowerright, upperright, nextapex) >
-                  0.0;
+        /* Check whether the edge is Delaunay (tested above). */
+        badedge = testresult[1] > 0.0;
         while (badedge) {
           /* Eliminate the edge with an edge flip.  As a result, the     */
           /*   right triangulation will have one more boundary triangle. */
@@ -10036,41 +11452,268 @@ struct otri *farright;
     }
     /* Merge the two triangulations into one. */
     mergehulls(m, b, farleft, &innerleft, &innerright, farright, axis);
+    /* Report the smallest subproblems of at least PROGRESSSTEPS vertices, */
+    /*   they don't overlap (mrkkrj).                                      */
+    if ((progresshook != nullptr) && (vertices >= PROGRESSSTEPS) &&
+        (vertices - divider < PROGRESSSTEPS)) {
+      divconqprogress(m, vertices);
+    }
   }
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  divconqprogress()   Count the vertices of a finished subproblem of the   */
+/*                      divide-and-conquer, and report the progress if       */
+/*                      called by the thread which started the               */
+/*                      triangulation (mrkkrj).                              */
+/*                                                                           */
+/*****************************************************************************/
+
 #ifdef ANSI_DECLARATORS
-long removeghosts(struct mesh *m, struct behavior *b, struct otri *startghost)
+void divconqprogress(struct mesh *m, int vertices)
 #else /* not ANSI_DECLARATORS */
-long removeghosts(m, b, startghost)
+void divconqprogress(m, vertices)
 struct mesh *m;
-struct behavior *b;
-struct otri *startghost;
+int vertices;
 #endif /* not ANSI_DECLARATORS */
 
 {
-  struct otri searchedge;
-  struct otri dissolveedge;
-  struct otri deadtriangle;
-  vertex markorg;
-  long hullsize;
-  triangle ptr;                         /* Temporary variable used by sym(). */
+  long done;
 
-  if (b->verbose) {
-    printf("  Removing ghost triangles.\n");
+  done = progressdivconq.fetch_add(vertices) + vertices;
+  if (std::this_thread::get_id() == progressthread) {
+    reportprogress(PROGRESSDELAUNAY, done, (long) m->invertices);
   }
-  /* Find an edge on the convex hull to start point location from. */
-  lprev(*startghost, searchedge);
-  symself(searchedge);
-  m->dummytri[0] = encode(searchedge);
-  /* Remove the bounding box and count the convex hull edges. */
-  otricopy(*startghost, dissolveedge);
-  hullsize = 0;
-  do {
-    hullsize++;
-    lnext(dissolveedge, deadtriangle);
-    lprevself(dissolveedge);
-    symself(dissolveedge);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  divconqsplitdepth()   Decide how many levels of the divide-and-conquer   */
+/*                        recursion are run in parallel.                     */
+/*                                                                           */
+/*  Returns zero if the triangulation should be done by a single thread.     */
+/*  Otherwise the recursion is split into at most 2^depth subproblems of at  */
+/*  least DIVCONQTASKSIZE vertices (mrkkrj).                                 */
+/*                                                                           */
+/*  If a tile size is given, the problem is split into as many subproblems   */
+/*  ("tiles") of at least `b->tilesize' vertices as possible, whatever the   */
+/*  number of threads, so that each tile's vertices and triangles stay in    */
+/*  the cache.  The tiles are the cells of the alternating cuts, i.e. they   */
+/*  partition the bounding box, and mergehulls() stitches them together.     */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+int divconqsplitdepth(struct behavior *b, int vertices)
+#else /* not ANSI_DECLARATORS */
+int divconqsplitdepth(b, vertices)
+struct behavior *b;
+int vertices;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  int tilesize;
+  int depth;
+
+  if (b->threads < 2) {
+    return 0;
+  }
+  depth = 0;
+  if (b->tilesize > 0) {
+    tilesize = (b->tilesize > DIVCONQMINTILESIZE) ? b->tilesize :
+                                                    DIVCONQMINTILESIZE;
+    while ((depth < 30) && ((vertices >> (depth + 1)) >= tilesize)) {
+      depth++;
+    }
+    return depth;
+  }
+  while (((1 << depth) < b->threads * DIVCONQTASKSPERTHREAD) &&
+         ((vertices >> (depth + 1)) >= DIVCONQTASKSIZE)) {
+    depth++;
+  }
+  return depth;
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  divconqworkmesh()   Create a mesh whose triangle pool is used by one     */
+/*                      worker thread of the parallel divide-and-conquer.    */
+/*                                                                           */
+/*  The mesh is a copy of `m' sharing its vertices, "outer space" triangle   */
+/*  and omnipresent subsegment, but with an own, empty triangle pool and own */
+/*  statistic counters.  Only the triangle pool may be used!                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+struct mesh *divconqworkmesh(struct mesh *m)
+#else /* not ANSI_DECLARATORS */
+struct mesh *divconqworkmesh(m)
+struct mesh *m;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct mesh *workmesh;
+
+  workmesh = (struct mesh *) trimalloc((int) sizeof(struct mesh));
+  memcpy(workmesh, m, sizeof(struct mesh));
+  /* All blocks of the same size, so that poolsplice() can be used later. */
+  poolinit(&workmesh->triangles, m->triangles.itembytes,
+           m->triangles.itemsperblock, m->triangles.itemsperblock,
+           m->triangles.alignbytes);
+  workmesh->incirclecount = 0;
+  workmesh->counterclockcount = 0;
+  workmesh->incircleexactcount = 0;
+  workmesh->counterclockexactcount = 0;
+  return workmesh;
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  divconqjoinmesh()   Move the triangles of a worker thread's mesh into    */
+/*                      another mesh and free the worker's mesh.             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void divconqjoinmesh(struct mesh *m, struct mesh *workmesh)
+#else /* not ANSI_DECLARATORS */
+void divconqjoinmesh(m, workmesh)
+struct mesh *m;
+struct mesh *workmesh;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  triangle *dyingtriangle;
+
+  /* The rest of the current block would be traversed, so allocate it */
+  /*   and mark all of it as dead triangles, ready for later reuse.   */
+  while (m->triangles.unallocateditems > 0) {
+    dyingtriangle = (triangle *) m->triangles.nextitem;
+    m->triangles.nextitem = (VOID *) ((char *) m->triangles.nextitem +
+                                      m->triangles.itembytes);
+    m->triangles.unallocateditems--;
+    m->triangles.maxitems++;
+    m->triangles.items++;
+    triangledealloc(m, dyingtriangle);
+  }
+  poolsplice(&m->triangles, &workmesh->triangles);
+
+  m->incirclecount += workmesh->incirclecount;
+  m->counterclockcount += workmesh->counterclockcount;
+  m->incircleexactcount += workmesh->incircleexactcount;
+  m->counterclockexactcount += workmesh->counterclockexactcount;
+  trifree((VOID *) workmesh);
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  divconqparallel()   Recursively form a Delaunay triangulation by the     */
+/*                      divide-and-conquer method, using several threads.    */
+/*                                                                           */
+/*  Splits the problem exactly as divconqrecurse() does, so the result is    */
+/*  the same.  For `depth' levels the left half is handed to the thread pool */
+/*  and the right half is triangulated by the calling thread, using a new    */
+/*  mesh for its triangles, so no two threads allocate from the same pool.   */
+/*  After both halves are done, the right half's triangles are moved into    */
+/*  the mesh of the left half and the halves are merged by mergehulls().     */
+/*  Below `depth' levels divconqrecurse() takes over (mrkkrj).               */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void divconqparallel(struct mesh *m, struct behavior *b,
+                     tpp::WorkStealingPool *pool, vertex *sortarray,
+                     int vertices, int axis, int depth,
+                     struct otri *farleft, struct otri *farright)
+#else /* not ANSI_DECLARATORS */
+void divconqparallel(m, b, pool, sortarray, vertices, axis, depth,
+                     farleft, farright)
+struct mesh *m;
+struct behavior *b;
+tpp::WorkStealingPool *pool;
+vertex *sortarray;
+int vertices;
+int axis;
+int depth;
+struct otri *farleft;
+struct otri *farright;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri innerleft, innerright;
+  struct mesh *rightmesh;
+  int divider;
+
+  if ((depth == 0) || (vertices < 2 * DIVCONQMINTILESIZE)) {
+    divconqrecurse(m, b, sortarray, vertices, axis, farleft, farright);
+    return;
+  }
+
+  /* Split the vertices in half. */
+  divider = vertices >> 1;
+  rightmesh = divconqworkmesh(m);
+
+  try {
+    tpp::TaskGroup group(*pool);
+
+    /* Recursively triangulate each half, the left one in another thread. */
+    group.run([=, &innerleft]() {
+      divconqparallel(m, b, pool, sortarray, divider, 1 - axis, depth - 1,
+                      farleft, &innerleft);
+    });
+    divconqparallel(rightmesh, b, pool, &sortarray[divider],
+                    vertices - divider, 1 - axis, depth - 1,
+                    &innerright, farright);
+    group.wait();
+  } catch (...) {
+    /* Don't leak the triangles of the right half. */
+    divconqjoinmesh(m, rightmesh);
+    throw;
+  }
+
+  divconqjoinmesh(m, rightmesh);
+  if (b->verbose > 1) {
+    printf("  Joining triangulations with %d and %d vertices.\n", divider,
+           vertices - divider);
+  }
+  /* Merge the two triangulations into one. */
+  mergehulls(m, b, farleft, &innerleft, &innerright, farright, axis);
+}
+
+#ifdef ANSI_DECLARATORS
+long removeghosts(struct mesh *m, struct behavior *b, struct otri *startghost)
+#else /* not ANSI_DECLARATORS */
+long removeghosts(m, b, startghost)
+struct mesh *m;
+struct behavior *b;
+struct otri *startghost;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri searchedge;
+  struct otri dissolveedge;
+  struct otri deadtriangle;
+  vertex markorg;
+  long hullsize;
+  triangle ptr;                         /* Temporary variable used by sym(). */
+
+  if (b->verbose) {
+    printf("  Removing ghost triangles.\n");
+  }
+  /* Find an edge on the convex hull to start point location from. */
+  lprev(*startghost, searchedge);
+  symself(searchedge);
+  m->dummytri[0] = encode(searchedge);
+  /* Remove the bounding box and count the convex hull edges. */
+  otricopy(*startghost, dissolveedge);
+  hullsize = 0;
+  do {
+    hullsize++;
+    lnext(dissolveedge, deadtriangle);
+    lprevself(dissolveedge);
+    symself(dissolveedge);
     /* If no PSLG is involved, set the boundary markers of all the vertices */
     /*   on the convex hull.  If a PSLG is used, this step is done later.   */
     if (!b->poly) {
@@ -10112,8 +11755,10 @@ struct behavior *b;
 
 {
   vertex *sortarray;
+  std::unique_ptr<tpp::WorkStealingPool> pool;
   struct otri hullleft, hullright;
   int divider;
+  int depth;
   int i, j;
 
   if (b->verbose) {
@@ -10127,8 +11772,18 @@ struct behavior *b;
     sortarray[i] = vertextraverse(m);
   }
 
+  /* The calling thread works too, while waiting for the pool's threads. */
+  if ((b->threads > 1) && ((m->invertices >= 2 * RADIXSORTSIZE) ||
+                           (divconqsplitdepth(b, m->invertices) > 0))) {
+    pool.reset(new tpp::WorkStealingPool(b->threads - 1));
+  }
+
   /* Sort the vertices. */
-  vertexsort1(sortarray, m->invertices);
+  if (m->invertices >= RADIXSORTSIZE) {
+    vertexradixsort(pool.get(), sortarray, m->invertices);
+  } else {
+    vertexsort1(sortarray, m->invertices);
+  }
   /* printarray(sortarray, m->invertices); */
 
   /* Discard duplicate vertices, which can really mess up the algorithm. */
@@ -10153,10 +11808,15 @@ struct behavior *b;
     /* Re-sort the array of vertices to accommodate alternating cuts. */
     divider = i >> 1;
     if (i - divider >= 2) {
-      if (divider >= 2) {
-        alternateaxes(sortarray, divider, 1);
+      if (divider >= RADIXSORTSIZE) {
+        alternateaxeskeyed(pool.get(), sortarray, divider, 1);
+        alternateaxeskeyed(pool.get(), &sortarray[divider], i - divider, 1);
+      } else {
+        if (divider >= 2) {
+          alternateaxes(sortarray, divider, 1);
+        }
+        alternateaxes(&sortarray[divider], i - divider, 1);
       }
-      alternateaxes(&sortarray[divider], i - divider, 1);
     }
   }
 
@@ -10173,7 +11833,23 @@ struct behavior *b;
   }
 
   /* Form the Delaunay triangulation. */
-  divconqrecurse(m, b, sortarray, i, 0, &hullleft, &hullright);
+  depth = divconqsplitdepth(b, i);
+  progressdivconq = 0;
+  try {
+    if (depth > 0) {
+      if (b->verbose) {
+        printf("  Using %d threads.\n", b->threads);
+      }
+      divconqparallel(m, b, pool.get(), sortarray, i, 0, depth, &hullleft,
+                      &hullright);
+    } else {
+      divconqrecurse(m, b, sortarray, i, 0, &hullleft, &hullright);
+    }
+  } catch (...) {
+    /* Aborted by the progress hook or out of memory (mrkkrj). */
+    trifree((VOID *) sortarray);
+    throw;
+  }
   trifree((VOID *) sortarray);
 
   return removeghosts(m, b, &hullleft);
@@ -10345,68 +12021,1181 @@ struct behavior *b;
   }
   triangledealloc(m, finaledge.tri);
 
-  trifree((VOID *) m->infvertex1);  /* Deallocate the bounding box vertices. */
+  trifree((VOID *) m->infvertex1);  /* Deallocate the bounding box vertices. */
+  trifree((VOID *) m->infvertex2);
+  trifree((VOID *) m->infvertex3);
+
+  return hullsize;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  hilbertindex()   Compute the position of a vertex along a Hilbert curve  */
+/*                   covering the bounding box of the input vertices.        */
+/*                   (mrkkrj)                                                */
+/*                                                                           */
+/*  The vertex is first mapped to a cell of a 2^HILBERTBITS x 2^HILBERTBITS  */
+/*  grid; `scale' converts coordinates to cell indices.                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+unsigned long long hilbertindex(struct mesh *m, REAL scale, vertex point)
+#else /* not ANSI_DECLARATORS */
+unsigned long long hilbertindex(m, scale, point)
+struct mesh *m;
+REAL scale;
+vertex point;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  unsigned long x, y, rx, ry, swap;
+  unsigned long cellmask, s;
+  unsigned long long index;
+
+  cellmask = (1ul << HILBERTBITS) - 1ul;
+  x = (unsigned long) ((point[0] - m->xmin) * scale) & cellmask;
+  y = (unsigned long) ((point[1] - m->ymin) * scale) & cellmask;
+  index = 0;
+  for (s = 1ul << (HILBERTBITS - 1); s > 0; s >>= 1) {
+    rx = (x & s) != 0;
+    ry = (y & s) != 0;
+    index += (unsigned long long) s * (unsigned long long) s * ((3 * rx) ^ ry);
+    /* Rotate the quadrant, so that the curve stays continuous. */
+    if (ry == 0) {
+      if (rx == 1) {
+        x = cellmask - x;
+        y = cellmask - y;
+      }
+      swap = x;
+      x = y;
+      y = swap;
+    }
+  }
+  return index;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  briosort()   Sort an array of vertices into a biased randomized          */
+/*               insertion order (Amenta, Choi, and Rote).  (mrkkrj)         */
+/*                                                                           */
+/*  Each vertex is assigned to a round by flipping coins:  the last round    */
+/*  gets about half of the vertices, the round before it half of the rest,   */
+/*  and so on.  The rounds are inserted from the smallest to the largest,    */
+/*  which preserves the expected behavior of a randomized insertion, and     */
+/*  within each round the vertices follow a Hilbert curve, so consecutive    */
+/*  vertices are close to each other.  The direction of the curve            */
+/*  alternates from round to round, so that each round starts near the      */
+/*  place where the previous one ended.                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+struct briovertex {
+  unsigned long long key;
+  vertex point;
+};
+
+#ifdef ANSI_DECLARATORS
+void briosort(struct mesh *m, vertex *sortarray, int arraysize)
+#else /* not ANSI_DECLARATORS */
+void briosort(m, sortarray, arraysize)
+struct mesh *m;
+vertex *sortarray;
+int arraysize;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct briovertex *keyarray;
+  unsigned long long lastindex;
+  unsigned long long index;
+  REAL width;
+  REAL scale;
+  int round;
+  int i;
+
+  keyarray = (struct briovertex *)
+             trimalloc(arraysize * (int) sizeof(struct briovertex));
+
+  width = m->xmax - m->xmin;
+  if (m->ymax - m->ymin > width) {
+    width = m->ymax - m->ymin;
+  }
+  scale = (width > 0.0) ? (REAL) ((1ul << HILBERTBITS) - 1ul) / width : 0.0;
+  lastindex = (1ull << (2 * HILBERTBITS)) - 1ull;
+
+  for (i = 0; i < arraysize; i++) {
+    /* Vertices in the earlier rounds are those that won more coin flips. */
+    round = BRIOMAXROUNDS - 1;
+    while ((round > 0) && (randomnation(2) == 0)) {
+      round--;
+    }
+    index = hilbertindex(m, scale, sortarray[i]);
+    if (round & 1) {
+      index = lastindex - index;
+    }
+    keyarray[i].key = ((unsigned long long) round << (2 * HILBERTBITS)) | index;
+    keyarray[i].point = sortarray[i];
+  }
+
+  std::sort(keyarray, keyarray + arraysize,
+            [](const struct briovertex &v1, const struct briovertex &v2)
+            { return v1.key < v2.key; });
+
+  for (i = 0; i < arraysize; i++) {
+    sortarray[i] = keyarray[i].point;
+  }
+  trifree((VOID *) keyarray);
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  recentstart()   Choose a starting triangle for the insertion of a        */
+/*                  vertex near the previously inserted one.  (mrkkrj)       */
+/*                                                                           */
+/*  Returns in `searchtri' the most recently created triangle, oriented so   */
+/*  that `searchpoint' lies strictly to the left of its primary edge, as     */
+/*  preciselocate() requires.  If that is not possible, `searchtri' is set   */
+/*  to the dummy triangle, so that insertvertex() falls back to locate().    */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+void recentstart(struct mesh *m, struct behavior *b, vertex searchpoint,
+                 struct otri *searchtri)
+#else /* not ANSI_DECLARATORS */
+void recentstart(m, b, searchpoint, searchtri)
+struct mesh *m;
+struct behavior *b;
+vertex searchpoint;
+struct otri *searchtri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  vertex torg, tdest;
+  REAL ahead;
+  triangle ptr;                         /* Temporary variable used by sym(). */
+
+  searchtri->tri = m->dummytri;
+  if ((m->recenttri.tri == (triangle *) NULL) || deadtri(m->recenttri.tri)) {
+    return;
+  }
+  org(m->recenttri, torg);
+  dest(m->recenttri, tdest);
+  if (((torg[0] == searchpoint[0]) && (torg[1] == searchpoint[1])) ||
+      ((tdest[0] == searchpoint[0]) && (tdest[1] == searchpoint[1]))) {
+    /* Leave duplicates to locate(). */
+    return;
+  }
+  ahead = counterclockwise(m, b, torg, tdest, searchpoint);
+  if (ahead > 0.0) {
+    otricopy(m->recenttri, *searchtri);
+  } else if (ahead < 0.0) {
+    /* Use the other side of the edge; if that's the outer space, */
+    /*   `searchtri' ends up being the dummy triangle.            */
+    sym(m->recenttri, *searchtri);
+  }
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  incrementaldelaunay()   Form a Delaunay triangulation by incrementally   */
+/*                          inserting vertices.                              */
+/*                                                                           */
+/*  The vertices are inserted in a biased randomized insertion order, see    */
+/*  briosort(), and each point location walks from the triangle created by   */
+/*  the previous insertion.  (mrkkrj)                                        */
+/*                                                                           */
+/*  Returns the number of edges on the convex hull of the triangulation.     */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+long incrementaldelaunay(struct mesh *m, struct behavior *b)
+#else /* not ANSI_DECLARATORS */
+long incrementaldelaunay(m, b)
+struct mesh *m;
+struct behavior *b;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri starttri;
+  vertex *sortarray;
+  vertex vertexloop;
+  int i;
+
+  /* Create a triangular bounding box. */
+  boundingbox(m, b);
+  if (b->verbose) {
+    printf("  Sorting vertices.\n");
+  }
+  sortarray = (vertex *) trimalloc(m->invertices * (int) sizeof(vertex));
+  traversalinit(&m->vertices);
+  for (i = 0; i < m->invertices; i++) {
+    sortarray[i] = vertextraverse(m);
+  }
+  briosort(m, sortarray, m->invertices);
+
+  if (b->verbose) {
+    printf("  Incrementally inserting vertices.\n");
+  }
+  try {
+    for (i = 0; i < m->invertices; i++) {
+      vertexloop = sortarray[i];
+      recentstart(m, b, vertexloop, &starttri);
+      if (insertvertex(m, b, vertexloop, &starttri, (struct osub *) NULL, 0,
+                       0) == DUPLICATEVERTEX) {
+        if (!b->quiet) {
+          printf(
+"Warning:  A duplicate vertex at (%.12g, %.12g) appeared and was ignored.\n",
+                 vertexloop[0], vertexloop[1]);
+        }
+        setvertextype(vertexloop, UNDEADVERTEX);
+        m->undeads++;
+      }
+      progressstep(PROGRESSDELAUNAY, (long) i + 1, (long) m->invertices);
+    }
+  } catch (...) {
+    /* Aborted by the progress hook or out of memory (mrkkrj). */
+    trifree((VOID *) sortarray);
+    trifree((VOID *) m->infvertex1);
+    trifree((VOID *) m->infvertex2);
+    trifree((VOID *) m->infvertex3);
+    throw;
+  }
+  trifree((VOID *) sortarray);
+
+  /* Remove the bounding box. */
+  return removebox(m, b);
+}
+
+#endif /* not REDUCED */
+
+/**                                                                         **/
+/**                                                                         **/
+/********* Incremental Delaunay triangulation ends here              *********/
+
+/********* Streaming Delaunay triangulation begins here              *********/
+/**                                                                         **/
+/**                                                                         **/
+
+/*****************************************************************************/
+/*                                                                           */
+/*  The streaming Delaunay triangulation (Isenburg, Liu, Shewchuk, and       */
+/*  Snoeyink, "Streaming Computation of Delaunay Triangulations", SIGGRAPH   */
+/*  2006) inserts the vertices in the order of a .node file, and hands each  */
+/*  triangle to a sink as soon as no vertex still to be read can change it.  */
+/*  Then the triangle is freed, so only the triangles along the "front" of   */
+/*  the stream are kept in memory.  (mrkkrj)                                 */
+/*                                                                           */
+/*  The finalization tags are found in two passes over the file:  the first  */
+/*  one finds the bounding box of the vertices, the second one counts the    */
+/*  vertices in each cell of a grid covering it.  In the third pass the      */
+/*  vertices are inserted, and a cell is finalized when its last vertex has  */
+/*  been read.  A triangle is final if all cells its circumcircle reaches    */
+/*  are finalized, because no vertex to come can fall into the circle.       */
+/*  Triangles which aren't final wait in the list of one of the cells they   */
+/*  depend on, and are tested again when that cell is finalized.             */
+/*                                                                           */
+/*  Little memory is needed only if the file is spatially coherent, i.e. if  */
+/*  the vertices of each region follow each other closely in the file, as    */
+/*  for data sorted along a coordinate or written tile by tile.              */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+/* A triangle waiting for a cell to be finalized. */
+
+struct streamwait {
+  triangle *tri;
+  struct streamwait *next;
+};
+
+/* The grid of the finalization cells. */
+
+struct streamgrid {
+  REAL xmin, ymin;
+  REAL xscale, yscale;            /* Convert coordinates to cell indices. */
+  int columns, rows;
+  int *unread;          /* Vertices still to be read per cell, 0 if final. */
+  struct streamwait **waiting;       /* Triangles waiting for each cell. */
+  vertex *recentvertex;        /* Vertex inserted last in each cell, and */
+  triangle *recent;             /*   a triangle with it as origin.         */
+  int lastcell;                   /* Cell of the vertex inserted last.     */
+  struct memorypool waitpool;
+};
+
+/* Receives the vertices of each finished triangle, in counterclockwise */
+/*   order.                                                              */
+
+typedef std::function<void(vertex, vertex, vertex)> streamsink;
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamindex()   Find the row or column of the finalization grid in which */
+/*                  a coordinate lies.  (mrkkrj)                             */
+/*                                                                           */
+/*  Coordinates beyond the grid are clamped to its first or last row or      */
+/*  column.  The mapping is monotone, even with roundoff, so that the cells  */
+/*  between the ones of two coordinates contain all values in between.       */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+int streamindex(REAL coordinate, REAL min, REAL scale, int count)
+#else /* not ANSI_DECLARATORS */
+int streamindex(coordinate, min, scale, count)
+REAL coordinate;
+REAL min;
+REAL scale;
+int count;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  REAL position;
+
+  position = (coordinate - min) * scale;
+  if (!(position > 0.0)) {
+    return 0;
+  }
+  if (position >= (REAL) count) {
+    return count - 1;
+  }
+  return (int) position;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamfinal()   Test whether a triangle is final.  (mrkkrj)              */
+/*                                                                           */
+/*  Returns -1 if all cells of the finalization grid which the triangle's    */
+/*  circumcircle reaches are finalized, and otherwise one of the cells which */
+/*  are not.  The cells are searched backwards, as the later ones are more   */
+/*  likely to be finalized last.                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+int streamfinal(struct mesh *m, struct behavior *b, struct streamgrid *grid,
+                struct otri *testtri)
+#else /* not ANSI_DECLARATORS */
+int streamfinal(m, b, grid, testtri)
+struct mesh *m;
+struct behavior *b;
+struct streamgrid *grid;
+struct otri *testtri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  vertex torg, tdest, tapex;
+  REAL xdo, ydo, xao, yao;
+  REAL dodist, aodist;
+  REAL area;
+  REAL dx, dy, radius;
+  REAL centerx, centery;
+  int left, right, bottom, top;
+  int row, column, cell;
+
+  org(*testtri, torg);
+  dest(*testtri, tdest);
+  apex(*testtri, tapex);
+  /* Find the circumcenter as findcircumcenter() does. */
+  xdo = tdest[0] - torg[0];
+  ydo = tdest[1] - torg[1];
+  xao = tapex[0] - torg[0];
+  yao = tapex[1] - torg[1];
+  dodist = xdo * xdo + ydo * ydo;
+  aodist = xao * xao + yao * yao;
+  area = counterclockwise(m, b, tdest, tapex, torg);
+  radius = -1.0;
+  centerx = centery = 0.0;
+  if (area > 0.0) {
+    dx = (yao * dodist - ydo * aodist) * 0.5 / area;
+    dy = (xdo * aodist - xao * dodist) * 0.5 / area;
+    radius = sqrt(dx * dx + dy * dy);
+    radius += STREAMRADIUSSLACK * radius;
+    centerx = torg[0] + dx;
+    centery = torg[1] + dy;
+  }
+  if ((radius >= 0.0) && (radius < HUGE_VAL)) {
+    left = streamindex(centerx - radius, grid->xmin, grid->xscale,
+                       grid->columns);
+    right = streamindex(centerx + radius, grid->xmin, grid->xscale,
+                        grid->columns);
+    bottom = streamindex(centery - radius, grid->ymin, grid->yscale,
+                         grid->rows);
+    top = streamindex(centery + radius, grid->ymin, grid->yscale, grid->rows);
+  } else {
+    /* No usable circle (e.g. for a sliver); depend on the whole grid. */
+    left = bottom = 0;
+    right = grid->columns - 1;
+    top = grid->rows - 1;
+  }
+
+  for (row = top; row >= bottom; row--) {
+    for (column = right; column >= left; column--) {
+      cell = row * grid->columns + column;
+      if (grid->unread[cell] > 0) {
+        return cell;
+      }
+    }
+  }
+  return -1;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streaminfinite()   Test whether a triangle has a corner of the bounding  */
+/*                     box.  Such triangles are never handed out.  (mrkkrj)  */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+int streaminfinite(struct mesh *m, struct otri *testtri)
+#else /* not ANSI_DECLARATORS */
+int streaminfinite(m, testtri)
+struct mesh *m;
+struct otri *testtri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  vertex torg, tdest, tapex;
+
+  org(*testtri, torg);
+  dest(*testtri, tdest);
+  apex(*testtri, tapex);
+  return (torg == m->infvertex1) || (torg == m->infvertex2) ||
+         (torg == m->infvertex3) || (tdest == m->infvertex1) ||
+         (tdest == m->infvertex2) || (tdest == m->infvertex3) ||
+         (tapex == m->infvertex1) || (tapex == m->infvertex2) ||
+         (tapex == m->infvertex3);
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamemit()   Hand a final triangle to the sink and free it.  (mrkkrj)  */
+/*                                                                           */
+/*  Its neighbors are left facing the outer space, which is harmless, as no  */
+/*  vertex to come can be inserted near them.                                */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+void streamemit(struct mesh *m, struct otri *finaltri, const streamsink &sink)
+#else /* not ANSI_DECLARATORS */
+void streamemit(m, finaltri, sink)
+struct mesh *m;
+struct otri *finaltri;
+const streamsink &sink;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri emittri;
+  struct otri neighbor;
+  vertex torg, tdest, tapex;
+  triangle ptr;                         /* Temporary variable used by sym(). */
+
+  org(*finaltri, torg);
+  dest(*finaltri, tdest);
+  apex(*finaltri, tapex);
+  sink(torg, tdest, tapex);
+
+  emittri.tri = finaltri->tri;
+  for (emittri.orient = 0; emittri.orient < 3; emittri.orient++) {
+    sym(emittri, neighbor);
+    if (neighbor.tri != m->dummytri) {
+      dissolve(neighbor);
+    }
+  }
+  triangledealloc(m, emittri.tri);
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamwaiton()   Let a triangle wait for a cell to be finalized.         */
+/*                   (mrkkrj)                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+void streamwaiton(struct streamgrid *grid, triangle *waitingtri, int cell)
+#else /* not ANSI_DECLARATORS */
+void streamwaiton(grid, waitingtri, cell)
+struct streamgrid *grid;
+triangle *waitingtri;
+int cell;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct streamwait *newwait;
+
+  newwait = (struct streamwait *) poolalloc(&grid->waitpool);
+  newwait->tri = waitingtri;
+  newwait->next = grid->waiting[cell];
+  grid->waiting[cell] = newwait;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamfinalize()   Test the triangles waiting for a cell which has just  */
+/*                     been finalized.  (mrkkrj)                             */
+/*                                                                           */
+/*  The final triangles are handed to the sink and freed, the others wait    */
+/*  for another cell.  The list refers to triangle records, which may have   */
+/*  been freed or reused since, so dead triangles are skipped, and each      */
+/*  record is tested only once.                                              */
+/*                                                                           */
+/*  Returns the number of triangles handed to the sink.                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+long streamfinalize(struct mesh *m, struct behavior *b,
+                    struct streamgrid *grid, int cell, const streamsink &sink)
+#else /* not ANSI_DECLARATORS */
+long streamfinalize(m, b, grid, cell, sink)
+struct mesh *m;
+struct behavior *b;
+struct streamgrid *grid;
+int cell;
+const streamsink &sink;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct streamwait *waitloop, *nextwait;
+  struct otri testtri;
+  triangle **waitarray;
+  long emitted;
+  int waitcount;
+  int nextcell;
+  int i;
+
+  waitcount = 0;
+  for (waitloop = grid->waiting[cell]; waitloop != (struct streamwait *) NULL;
+       waitloop = waitloop->next) {
+    waitcount++;
+  }
+  if (waitcount == 0) {
+    return 0l;
+  }
+  waitarray = (triangle **) trimalloc(waitcount * (int) sizeof(triangle *));
+  waitloop = grid->waiting[cell];
+  for (i = 0; i < waitcount; i++) {
+    waitarray[i] = waitloop->tri;
+    nextwait = waitloop->next;
+    pooldealloc(&grid->waitpool, (VOID *) waitloop);
+    waitloop = nextwait;
+  }
+  grid->waiting[cell] = (struct streamwait *) NULL;
+  std::sort(waitarray, waitarray + waitcount);
+
+  emitted = 0l;
+  testtri.orient = 0;
+  for (i = 0; i < waitcount; i++) {
+    if (((i > 0) && (waitarray[i] == waitarray[i - 1])) ||
+        deadtri(waitarray[i])) {
+      continue;
+    }
+    testtri.tri = waitarray[i];
+    if (streaminfinite(m, &testtri)) {
+      /* A reused record; it's queued again if it becomes finite. */
+      continue;
+    }
+    nextcell = streamfinal(m, b, grid, &testtri);
+    if (nextcell < 0) {
+      streamemit(m, &testtri, sink);
+      emitted++;
+    } else {
+      streamwaiton(grid, testtri.tri, nextcell);
+    }
+  }
+  trifree((VOID *) waitarray);
+  return emitted;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamlocate()   Find the triangle or edge containing a given point by   */
+/*                   walking along a straight line from a vertex.  (mrkkrj)  */
+/*                                                                           */
+/*  `searchtri' has the start vertex as its origin.  If the start vertex and */
+/*  `searchpoint' lie in the same cell of the finalization grid, and that    */
+/*  cell isn't finalized, all triangles crossed by the line are alive, as    */
+/*  each of them reaches into the cell.  Unlike preciselocate(), the walk    */
+/*  therefore can't run into a hole left by the freed triangles.             */
+/*                                                                           */
+/*  Returns OUTSIDE if the walk runs into the outer space nevertheless, and  */
+/*  otherwise the same results as preciselocate().                           */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+enum locateresult streamlocate(struct mesh *m, struct behavior *b,
+                               vertex searchpoint, struct otri *searchtri)
+#else /* not ANSI_DECLARATORS */
+enum locateresult streamlocate(m, b, searchpoint, searchtri)
+struct mesh *m;
+struct behavior *b;
+vertex searchpoint;
+struct otri *searchtri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri crosstri;
+  vertex startvertex;
+  vertex leftvertex, rightvertex, farvertex;
+  long steps;
+  triangle ptr;           /* Temporary variable used by sym() and onext(). */
+
+  org(*searchtri, startvertex);
+  if ((startvertex[0] == searchpoint[0]) &&
+      (startvertex[1] == searchpoint[1])) {
+    return walklocate(m, b, searchpoint, searchtri);
+  }
+  /* Find the triangle the line leaves `startvertex' through.  Vertices on */
+  /*   the line count as lying to its right.                               */
+  if (finddirection(m, b, searchtri, searchpoint) == LEFTCOLLINEAR) {
+    onextself(*searchtri);
+  }
+  /* The edge through which the line leaves the current triangle goes from */
+  /*   a vertex to the right of the line to one to its left.               */
+  lnextself(*searchtri);
+  for (steps = 0l; steps <= m->triangles.items; steps++) {
+    org(*searchtri, rightvertex);
+    dest(*searchtri, leftvertex);
+    if (counterclockwise(m, b, rightvertex, leftvertex, searchpoint) >= 0.0) {
+      /* `searchpoint' lies before the edge, so it's in this triangle. */
+      return walklocate(m, b, searchpoint, searchtri);
+    }
+    sym(*searchtri, crosstri);
+    if (crosstri.tri == m->dummytri) {
+      return OUTSIDE;
+    }
+    apex(crosstri, farvertex);
+    if (counterclockwise(m, b, startvertex, searchpoint, farvertex) > 0.0) {
+      lnext(crosstri, *searchtri);
+    } else {
+      lprev(crosstri, *searchtri);
+    }
+  }
+  return OUTSIDE;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streaminsert()   Insert a vertex into the streamed triangulation.        */
+/*                   (mrkkrj)                                                */
+/*                                                                           */
+/*  The point location walks by streamlocate() from the vertex inserted last */
+/*  in the same cell, or else from the one inserted last at all.  If the     */
+/*  walk runs into a hole left by the freed triangles, all remaining         */
+/*  triangles are searched.  The triangle containing the vertex can't have   */
+/*  been freed, as the vertex lies within its circumcircle.  For the same    */
+/*  reason, the edge flips never reach a freed triangle.                     */
+/*                                                                           */
+/*  All triangles created or changed surround the new vertex, and wait for   */
+/*  the vertex' cell `cell'.  Returns 0 for a duplicate vertex, which is     */
+/*  freed, and 1 otherwise.                                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+int streaminsert(struct mesh *m, struct behavior *b, struct streamgrid *grid,
+                 vertex newvertex, int cell)
+#else /* not ANSI_DECLARATORS */
+int streaminsert(m, b, grid, newvertex, cell)
+struct mesh *m;
+struct behavior *b;
+struct streamgrid *grid;
+vertex newvertex;
+int cell;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri searchtri;
+  struct otri firsttri;
+  vertex torg, tdest;
+  enum locateresult intersect;
+  int i;
+  triangle ptr;                         /* Temporary variable used by sym(). */
+
+  intersect = OUTSIDE;
+  if (grid->recentvertex[cell] != (vertex) NULL) {
+    /* The triangle may have been changed since, but if it still has the */
+    /*   vertex, which lies in this cell, it's alive.                    */
+    decode(grid->recent[cell], searchtri);
+    if (!deadtri(searchtri.tri)) {
+      for (i = 0; i < 3; i++) {
+        org(searchtri, torg);
+        if (torg == grid->recentvertex[cell]) {
+          intersect = streamlocate(m, b, newvertex, &searchtri);
+          break;
+        }
+        lnextself(searchtri);
+      }
+    }
+  }
+  if ((intersect == OUTSIDE) && (grid->lastcell >= 0) &&
+      (grid->unread[grid->lastcell] > 0)) {
+    /* Walk from the vertex inserted last, its cell isn't finalized yet. */
+    otricopy(m->recenttri, searchtri);
+    intersect = streamlocate(m, b, newvertex, &searchtri);
+  }
+  if (intersect == OUTSIDE) {
+    intersect = scanlocate(m, b, newvertex, &searchtri);
+    if (intersect == OUTSIDE) {
+      printf("Internal error in streaminsert():\n");
+      printf("  Vertex (%.12g, %.12g) lies in no triangle.\n",
+             newvertex[0], newvertex[1]);
+      internalerror();
+    }
+  }
+  if (intersect == ONVERTEX) {
+    if (!b->quiet) {
+      printf(
+"Warning:  A duplicate vertex at (%.12g, %.12g) appeared and was ignored.\n",
+             newvertex[0], newvertex[1]);
+    }
+    vertexdealloc(m, newvertex);
+    return 0;
+  }
+
+  /* Turn `searchtri' so that the vertex lies strictly to the left of its */
+  /*   primary edge, then insertvertex() finds it again at once.          */
+  for (i = 0; i < 3; i++) {
+    org(searchtri, torg);
+    dest(searchtri, tdest);
+    if (counterclockwise(m, b, torg, tdest, newvertex) > 0.0) {
+      break;
+    }
+    lnextself(searchtri);
+  }
+  insertvertex(m, b, newvertex, &searchtri, (struct osub *) NULL, 0, 0);
+  grid->recent[cell] = encode(searchtri);
+  grid->recentvertex[cell] = newvertex;
+  grid->lastcell = cell;
+
+  /* Queue the triangles around the new vertex, the origin of `searchtri'. */
+  otricopy(searchtri, firsttri);
+  do {
+    if (!streaminfinite(m, &searchtri)) {
+      streamwaiton(grid, searchtri.tri, cell);
+    }
+    onextself(searchtri);
+  } while ((searchtri.tri != m->dummytri) && !otriequal(searchtri, firsttri));
+  return 1;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamsweep()   Free the vertices no longer used by any triangle.        */
+/*                  (mrkkrj)                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+void streamsweep(struct mesh *m)
+#else /* not ANSI_DECLARATORS */
+void streamsweep(m)
+struct mesh *m;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri triangleloop;
+  vertex vertexloop;
+  vertex torg, tdest, tapex;
+
+  traversalinit(&m->vertices);
+  vertexloop = vertextraverse(m);
+  while (vertexloop != (vertex) NULL) {
+    setvertextype(vertexloop, FREEVERTEX);
+    vertexloop = vertextraverse(m);
+  }
+  /* The corners of the bounding box get marked too, that's harmless. */
+  triangleloop.orient = 0;
+  traversalinit(&m->triangles);
+  triangleloop.tri = triangletraverse(m);
+  while (triangleloop.tri != (triangle *) NULL) {
+    org(triangleloop, torg);
+    dest(triangleloop, tdest);
+    apex(triangleloop, tapex);
+    setvertextype(torg, INPUTVERTEX);
+    setvertextype(tdest, INPUTVERTEX);
+    setvertextype(tapex, INPUTVERTEX);
+    triangleloop.tri = triangletraverse(m);
+  }
+  traversalinit(&m->vertices);
+  vertexloop = vertextraverse(m);
+  while (vertexloop != (vertex) NULL) {
+    if (vertextype(vertexloop) == FREEVERTEX) {
+      vertexdealloc(m, vertexloop);
+    }
+    vertexloop = vertextraverse(m);
+  }
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamreadvertex()   Read the coordinates of the next vertex of a .node  */
+/*                       file.  (mrkkrj)                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+void streamreadvertex(struct behavior *b, FILE *infile, char *infilename,
+                      int index, REAL *x, REAL *y)
+#else /* not ANSI_DECLARATORS */
+void streamreadvertex(b, infile, infilename, index, x, y)
+struct behavior *b;
+FILE *infile;
+char *infilename;
+int index;
+REAL *x;
+REAL *y;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  char inputline[INPUTLINESIZE];
+  char *stringptr;
+
+  stringptr = readline(inputline, infile, infilename);
+  stringptr = findfield(stringptr);
+  if (*stringptr == '\0') {
+    printf("Error:  Vertex %d has no x coordinate.\n", b->firstnumber + index);
+    triexit(1);
+  }
+  *x = (REAL) strtod(stringptr, &stringptr);
+  stringptr = findfield(stringptr);
+  if (*stringptr == '\0') {
+    printf("Error:  Vertex %d has no y coordinate.\n", b->firstnumber + index);
+    triexit(1);
+  }
+  *y = (REAL) strtod(stringptr, &stringptr);
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamgridinit()   Read the .node file twice to lay out the finalization */
+/*                     grid and count the vertices of its cells.  (mrkkrj)   */
+/*                                                                           */
+/*  The grid has about `cellpoints' vertices per cell.  Also sets the        */
+/*  bounding box of the mesh.  Returns the number of vertices.               */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+int streamgridinit(struct mesh *m, struct behavior *b, struct streamgrid *grid,
+                   FILE *infile, char *infilename, int cellpoints)
+#else /* not ANSI_DECLARATORS */
+int streamgridinit(m, b, grid, infile, infilename, cellpoints)
+struct mesh *m;
+struct behavior *b;
+struct streamgrid *grid;
+FILE *infile;
+char *infilename;
+int cellpoints;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  char inputline[INPUTLINESIZE];
+  char *stringptr;
+  REAL x, y;
+  REAL width, height;
+  int vertexcount;
+  int cellcount;
+  int cell;
+  int i;
+
+  /* Read the number of vertices and the number of dimensions. */
+  stringptr = readline(inputline, infile, infilename);
+  vertexcount = (int) strtol(stringptr, &stringptr, 0);
+  stringptr = findfield(stringptr);
+  if ((*stringptr != '\0') && ((int) strtol(stringptr, &stringptr, 0) != 2)) {
+    printf("Error:  Triangle only works with two-dimensional meshes.\n");
+    triexit(1);
+  }
+  if (vertexcount < 3) {
+    printf("Error:  Input must have at least three input vertices.\n");
+    triexit(1);
+  }
+
+  /* First pass:  the bounding box. */
+  for (i = 0; i < vertexcount; i++) {
+    streamreadvertex(b, infile, infilename, i, &x, &y);
+    if (i == 0) {
+      m->xmin = m->xmax = x;
+      m->ymin = m->ymax = y;
+    } else {
+      m->xmin = (x < m->xmin) ? x : m->xmin;
+      m->xmax = (x > m->xmax) ? x : m->xmax;
+      m->ymin = (y < m->ymin) ? y : m->ymin;
+      m->ymax = (y > m->ymax) ? y : m->ymax;
+    }
+  }
+
+  /* Choose about square cells. */
+  cellcount = vertexcount / (cellpoints > 0 ? cellpoints : STREAMCELLPOINTS);
+  if (cellcount > STREAMMAXCELLS) {
+    cellcount = STREAMMAXCELLS;
+  }
+  if (cellcount < 1) {
+    cellcount = 1;
+  }
+  width = m->xmax - m->xmin;
+  height = m->ymax - m->ymin;
+  if (height <= 0.0) {
+    grid->columns = cellcount;
+  } else if (width <= 0.0) {
+    grid->columns = 1;
+  } else {
+    grid->columns = (int) (sqrt((REAL) cellcount * width / height) + 0.5);
+    grid->columns = grid->columns < 1 ? 1 :
+                    (grid->columns > cellcount ? cellcount : grid->columns);
+  }
+  grid->rows = cellcount / grid->columns;
+  grid->xmin = m->xmin;
+  grid->ymin = m->ymin;
+  grid->xscale = (width > 0.0) ? (REAL) grid->columns / width : 0.0;
+  grid->yscale = (height > 0.0) ? (REAL) grid->rows / height : 0.0;
+  cellcount = grid->columns * grid->rows;
+  grid->unread = (int *) trimalloc(cellcount * (int) sizeof(int));
+  grid->waiting = (struct streamwait **)
+                  trimalloc(cellcount * (int) sizeof(struct streamwait *));
+  grid->recentvertex = (vertex *) trimalloc(cellcount * (int) sizeof(vertex));
+  grid->recent = (triangle *) trimalloc(cellcount * (int) sizeof(triangle));
+  for (cell = 0; cell < cellcount; cell++) {
+    grid->unread[cell] = 0;
+    grid->waiting[cell] = (struct streamwait *) NULL;
+    grid->recentvertex[cell] = (vertex) NULL;
+  }
+  grid->lastcell = -1;
+
+  /* Second pass:  the number of vertices per cell. */
+  rewind(infile);
+  readline(inputline, infile, infilename);
+  for (i = 0; i < vertexcount; i++) {
+    streamreadvertex(b, infile, infilename, i, &x, &y);
+    grid->unread[streamindex(y, grid->ymin, grid->yscale, grid->rows) *
+                 grid->columns +
+                 streamindex(x, grid->xmin, grid->xscale, grid->columns)]++;
+  }
+  return vertexcount;
+}
+
+#endif /* not REDUCED */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  streamdeinit()   Free the memory of a streaming triangulation, except    */
+/*                   for the mesh's pools, and close its file.  (mrkkrj)     */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef REDUCED
+
+#ifdef ANSI_DECLARATORS
+void streamdeinit(struct mesh *m, struct streamgrid *grid, FILE *infile)
+#else /* not ANSI_DECLARATORS */
+void streamdeinit(m, grid, infile)
+struct mesh *m;
+struct streamgrid *grid;
+FILE *infile;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  fclose(infile);
+  trifree((VOID *) grid->unread);
+  trifree((VOID *) grid->waiting);
+  trifree((VOID *) grid->recentvertex);
+  trifree((VOID *) grid->recent);
+  pooldeinit(&grid->waitpool);
+  trifree((VOID *) m->infvertex1);
   trifree((VOID *) m->infvertex2);
   trifree((VOID *) m->infvertex3);
-
-  return hullsize;
+  m->infvertex1 = m->infvertex2 = m->infvertex3 = (vertex) NULL;
 }
 
 #endif /* not REDUCED */
 
 /*****************************************************************************/
 /*                                                                           */
-/*  incrementaldelaunay()   Form a Delaunay triangulation by incrementally   */
-/*                          inserting vertices.                              */
+/*  streamdelaunay()   Form the Delaunay triangulation of the vertices of a  */
+/*                     .node file, handing its triangles to `sink' as soon   */
+/*                     as they are final.  (mrkkrj)                          */
 /*                                                                           */
-/*  Returns the number of edges on the convex hull of the triangulation.     */
+/*  The vertex marks are set to the vertices' positions in the file,         */
+/*  starting at zero.  Duplicate vertices are skipped.  The vertices and     */
+/*  triangles are freed after use, so the mesh is empty afterwards.          */
+/*                                                                           */
+/*  Returns the number of triangles handed to the sink, or -1 if the file    */
+/*  can't be opened.                                                         */
 /*                                                                           */
 /*****************************************************************************/
 
 #ifndef REDUCED
 
 #ifdef ANSI_DECLARATORS
-long incrementaldelaunay(struct mesh *m, struct behavior *b)
+long streamdelaunay(struct mesh *m, struct behavior *b, char *nodefilename,
+                    int cellpoints, const streamsink &sink)
 #else /* not ANSI_DECLARATORS */
-long incrementaldelaunay(m, b)
+long streamdelaunay(m, b, nodefilename, cellpoints, sink)
 struct mesh *m;
 struct behavior *b;
+char *nodefilename;
+int cellpoints;
+const streamsink &sink;
 #endif /* not ANSI_DECLARATORS */
 
 {
-  struct otri starttri;
-  vertex vertexloop;
+  struct streamgrid grid;
+  struct otri triangleloop;
+  FILE *infile;
+  char inputline[INPUTLINESIZE];
+  vertex newvertex;
+  REAL x, y;
+  long emitted;
+  long sweepsize;
+  int vertexcount;
+  int cell;
+  int i;
 
-  /* Create a triangular bounding box. */
-  boundingbox(m, b);
-  if (b->verbose) {
-    printf("  Incrementally inserting vertices.\n");
-  }
-  traversalinit(&m->vertices);
-  vertexloop = vertextraverse(m);
-  while (vertexloop != (vertex) NULL) {
-    starttri.tri = m->dummytri;
-    if (insertvertex(m, b, vertexloop, &starttri, (struct osub *) NULL, 0, 0)
-        == DUPLICATEVERTEX) {
-      if (!b->quiet) {
-        printf(
-"Warning:  A duplicate vertex at (%.12g, %.12g) appeared and was ignored.\n",
-               vertexloop[0], vertexloop[1]);
+  infile = fopen(nodefilename, "r");
+  if (infile == (FILE *) NULL) {
+    return -1l;
+  }
+  grid.unread = (int *) NULL;
+  grid.waiting = (struct streamwait **) NULL;
+  grid.recentvertex = (vertex *) NULL;
+  grid.recent = (triangle *) NULL;
+  grid.waitpool.firstblock = (VOID **) NULL;
+  m->infvertex1 = m->infvertex2 = m->infvertex3 = (vertex) NULL;
+
+  try {
+    vertexcount = streamgridinit(m, b, &grid, infile, nodefilename,
+                                 cellpoints);
+    poolinit(&grid.waitpool, sizeof(struct streamwait), STREAMWAITPERBLOCK,
+             0, 0);
+    /* Vertices and triangles are allocated as the stream goes. */
+    m->invertices = 0;
+    m->mesh_dim = 2;
+    m->nextras = 0;
+    initializevertexpool(m, b);
+    initializetrisubpools(m, b);
+    boundingbox(m, b);
+    m->invertices = vertexcount;
+
+    /* Third pass:  insert the vertices. */
+    rewind(infile);
+    readline(inputline, infile, nodefilename);
+    emitted = 0l;
+    sweepsize = STREAMSWEEPSIZE;
+    for (i = 0; i < vertexcount; i++) {
+      streamreadvertex(b, infile, nodefilename, i, &x, &y);
+      cell = streamindex(y, grid.ymin, grid.yscale, grid.rows) * grid.columns +
+             streamindex(x, grid.xmin, grid.xscale, grid.columns);
+      newvertex = (vertex) poolalloc(&m->vertices);
+      newvertex[0] = x;
+      newvertex[1] = y;
+      setvertexmark(newvertex, i);
+      setvertextype(newvertex, INPUTVERTEX);
+      streaminsert(m, b, &grid, newvertex, cell);
+      grid.unread[cell]--;
+      if (grid.unread[cell] == 0) {
+        emitted += streamfinalize(m, b, &grid, cell, sink);
+      }
+      if (m->vertices.items >= sweepsize) {
+        streamsweep(m);
+        sweepsize = 2l * m->vertices.items;
+        sweepsize = sweepsize > STREAMSWEEPSIZE ? sweepsize : STREAMSWEEPSIZE;
       }
-      setvertextype(vertexloop, UNDEADVERTEX);
-      m->undeads++;
     }
-    vertexloop = vertextraverse(m);
+
+    /* All cells are finalized now, so normally only the triangles of the */
+    /*   bounding box are left.                                           */
+    triangleloop.orient = 0;
+    traversalinit(&m->triangles);
+    triangleloop.tri = triangletraverse(m);
+    while (triangleloop.tri != (triangle *) NULL) {
+      if (!streaminfinite(m, &triangleloop)) {
+        streamemit(m, &triangleloop, sink);
+        emitted++;
+      }
+      triangleloop.tri = triangletraverse(m);
+    }
+  } catch (...) {
+    streamdeinit(m, &grid, infile);
+    throw;
   }
-  /* Remove the bounding box. */
-  return removebox(m, b);
+  streamdeinit(m, &grid, infile);
+  return emitted;
 }
 
 #endif /* not REDUCED */
 
 /**                                                                         **/
 /**                                                                         **/
-/********* Incremental Delaunay triangulation ends here              *********/
+/********* Streaming Delaunay triangulation ends here                *********/
 
 /********* Sweepline Delaunay triangulation begins here              *********/
 /**                                                                         **/
@@ -10954,8 +13743,11 @@ struct behavior *b;
   vertex connectvertex;
   vertex leftvertex, midvertex, rightvertex;
   REAL lefttest, righttest;
+  vertex testa[2], testb[2], testc[2];
+  REAL testresult[2];
   int heapsize;
   int check4events, farrightflag;
+  long inserted;
   triangle ptr;   /* Temporary variable used by sym(), onext(), and oprev(). */
 
   // silence warnings
@@ -11017,6 +13809,7 @@ struct behavior *b;
   setdest(righttri, firstvertex);
   lprev(lefttri, bottommost);
   lastvertex = secondvertex;
+  inserted = 2;
   while (heapsize > 0) {
     nextevent = eventheap[0];
     eventheapdelete(eventheap, heapsize, 0);
@@ -11102,35 +13895,46 @@ struct behavior *b;
           splayroot = splayinsert(m, splayroot, &inserttri, nextvertex);
         }
       }
+      inserted++;
+      try {
+        progressstep(PROGRESSDELAUNAY, inserted, (long) m->invertices);
+      } catch (...) {
+        /* Aborted by the progress hook (mrkkrj). */
+        trifree((VOID *) eventheap);
+        trifree((VOID *) events);
+        throw;
+      }
     }
     nextevent->eventptr = (VOID *) freeevents;
     freeevents = nextevent;
 
     if (check4events) {
-      apex(farlefttri, leftvertex);
-      dest(lefttri, midvertex);
-      apex(lefttri, rightvertex);
-      lefttest = counterclockwise(m, b, leftvertex, midvertex, rightvertex);
+      /* Test for both possible circle events at once. */
+      apex(farlefttri, testa[0]);
+      dest(lefttri, testb[0]);
+      apex(lefttri, testc[0]);
+      apex(righttri, testa[1]);
+      org(righttri, testb[1]);
+      apex(farrighttri, testc[1]);
+      counterclockwisebatch(m, b, 2, testa, testb, testc, testresult);
+      lefttest = testresult[0];
       if (lefttest > 0.0) {
         newevent = freeevents;
         freeevents = (struct event *) freeevents->eventptr;
         newevent->xkey = m->xminextreme;
-        newevent->ykey = circletop(m, leftvertex, midvertex, rightvertex,
+        newevent->ykey = circletop(m, testa[0], testb[0], testc[0],
                                    lefttest);
         newevent->eventptr = (VOID *) encode(lefttri);
         eventheapinsert(eventheap, heapsize, newevent);
         heapsize++;
         setorg(lefttri, newevent);
       }
-      apex(righttri, leftvertex);
-      org(righttri, midvertex);
-      apex(farrighttri, rightvertex);
-      righttest = counterclockwise(m, b, leftvertex, midvertex, rightvertex);
+      righttest = testresult[1];
       if (righttest > 0.0) {
         newevent = freeevents;
         freeevents = (struct event *) freeevents->eventptr;
         newevent->xkey = m->xminextreme;
-        newevent->ykey = circletop(m, leftvertex, midvertex, rightvertex,
+        newevent->ykey = circletop(m, testa[1], testb[1], testc[1],
                                    righttest);
         newevent->eventptr = (VOID *) encode(farrighttri);
         eventheapinsert(eventheap, heapsize, newevent);
@@ -11141,6 +13945,8 @@ struct behavior *b;
   }
 
   pooldeinit(&m->splaynodes);
+  trifree((VOID *) eventheap);
+  trifree((VOID *) events);
   lprevself(bottommost);
   return removeghosts(m, b, &bottommost);
 }
@@ -11174,6 +13980,8 @@ struct behavior *b;
 
   m->eextras = 0;
   initializetrisubpools(m, b);
+  progressthread = std::this_thread::get_id();
+  reportprogress(PROGRESSDELAUNAY, 0l, (long) m->invertices);
 
 #ifdef REDUCED
   if (!b->quiet) {
@@ -11200,6 +14008,8 @@ struct behavior *b;
     hulledges = divconqdelaunay(m, b);
   }
 #endif /* not REDUCED */
+  reportprogress(PROGRESSDELAUNAY, (long) m->invertices,
+                 (long) m->invertices);
 
   if (m->triangles.items == 0) {
     /* The input vertices were all collinear, so there are no triangles. */
@@ -12636,6 +15446,7 @@ char *polyfilename;
         printf("  Recovering PSLG segments.\n");
       }
     }
+    reportprogress(PROGRESSSEGMENTS, 0l, (long) m->insegments);
 
     boundmarker = 0;
     /* Read and insert the segments. */
@@ -12698,6 +15509,7 @@ char *polyfilename;
           insertsegment(m, b, endpoint1, endpoint2, boundmarker);
         }
       }
+      progressstep(PROGRESSSEGMENTS, (long) i + 1, (long) m->insegments);
     }
   } else {
     m->insegments = 0;
@@ -12709,6 +15521,8 @@ char *polyfilename;
     }
     markhull(m, b);
   }
+  reportprogress(PROGRESSSEGMENTS, (long) m->insegments,
+                 (long) m->insegments);
 }
 
 
@@ -13341,6 +16155,8 @@ int regions;
     }
   }
 
+  reportprogress(PROGRESSHOLES, 0l, (long) (holes + regions));
+
   if (regions > 0) {
     /* Allocate storage for the triangles in which region points fall. */
     regiontris = (struct otri *) trimalloc(regions *
@@ -13434,6 +16250,13 @@ int regions;
     plague(m, b);
   }
   /* The virus pool should be empty now. */
+  try {
+    reportprogress(PROGRESSHOLES, (long) holes, (long) (holes + regions));
+  } catch (...) {
+    /* Aborted by the progress hook (mrkkrj). */
+    trifree((VOID *) regiontris);
+    throw;
+  }
 
   if (regions > 0) {
     if (!b->quiet) {
@@ -13485,6 +16308,8 @@ int regions;
   if (regions > 0) {
     trifree((VOID *) regiontris);
   }
+  reportprogress(PROGRESSHOLES, (long) (holes + regions),
+                 (long) (holes + regions));
 }
 
 /**                                                                         **/
@@ -13942,6 +16767,567 @@ struct badtriang *badtri;
 
 #endif /* not CDT_ONLY */
 
+/*****************************************************************************/
+/*                                                                           */
+/*  fixbadtriangle()   Split a bad triangle, or put it back in the queue and */
+/*                     split the subsegments its Steiner point encroaches    */
+/*                     upon.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef CDT_ONLY
+
+#ifdef ANSI_DECLARATORS
+void fixbadtriangle(struct mesh *m, struct behavior *b,
+                    struct badtriang *badtri)
+#else /* not ANSI_DECLARATORS */
+void fixbadtriangle(m, b, badtri)
+struct mesh *m;
+struct behavior *b;
+struct badtriang *badtri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  /* Fix one bad triangle by inserting a vertex at its circumcenter. */
+  splittriangle(m, b, badtri);
+  if (m->badsubsegs.items > 0) {
+    /* Put bad triangle back in queue for another try later. */
+    enqueuebadtriang(m, b, badtri);
+    /* Fix any encroached subsegments that resulted. */
+    /*   Record any new bad triangles that result.   */
+    splitencsegs(m, b, 1);
+  } else {
+    /* Return the bad triangle to the pool. */
+    pooldealloc(&m->badtriangles, (VOID *) badtri);
+  }
+}
+
+#endif /* not CDT_ONLY */
+
+/*****************************************************************************/
+/*                                                                           */
+/*  Parallel refinement (mrkkrj).                                            */
+/*                                                                           */
+/*  A round takes a batch of bad triangles from the queues and, in parallel, */
+/*  finds the Steiner point of each of them and its cavity:  the triangles   */
+/*  whose circumcircles contain the point and which can be reached from it   */
+/*  without crossing a subsegment (the Bowyer-Watson cavity, which is what   */
+/*  the edge flips of insertvertex() remove).  The cavities are then         */
+/*  accepted in queue order if they don't overlap the cavities and the       */
+/*  neighbouring triangles of the cavities accepted before; the others are   */
+/*  put back into the queues for the next round.  The accepted cavities are  */
+/*  retriangulated in parallel, each into a fan around its new vertex, and   */
+/*  the new triangles are tested for quality.                                */
+/*                                                                           */
+/*  A Steiner point which encroaches upon a subsegment, falls on a vertex or */
+/*  a subsegment, or leaves the mesh is left to splittriangle(), as are      */
+/*  unusually large cavities.  So every vertex is inserted exactly as the    */
+/*  sequential algorithm would have inserted it in some order of the bad     */
+/*  triangles, and the angle and area guarantees are kept.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef CDT_ONLY
+
+enum refineaction {REFINESTALE, REFINESERIALLY, REFINECAVITY, REFINECONFLICT};
+
+struct cavityedge {
+  vertex edgeorg, edgedest;  /* Counterclockwise around the cavity. */
+  triangle outside;          /* The triangle (or outer space) beyond it. */
+  subseg edgesubseg;         /* Its subsegment, or the omnipresent one. */
+  triangle *owner;           /* The cavity triangle it belongs to. */
+};
+
+struct refinecandidate {
+  struct badtriang *badtri;
+  enum refineaction action;
+  REAL newpoint[2];                                     /* Steiner point. */
+  REAL xi, eta;           /* Its position relative to the bad triangle. */
+  vertex borg, bdest, bapex;               /* Vertices of the bad triangle. */
+  std::vector<triangle *> cavity;
+  std::vector<struct cavityedge> edges;        /* The cavity's boundary. */
+  std::vector<REAL> edgeattribs;  /* Attributes and area bounds of edges. */
+  vertex newvertex;
+  triangle *newtris[2];     /* The cavity gets two more triangles. */
+};
+
+/* A slot of the hash table marking the triangles of the cavities chosen in */
+/*   a round (1) and their neighbours (2).  Slots of other rounds are empty. */
+
+struct cavitymark {
+  triangle *tri;
+  int round;
+  int mark;
+};
+
+struct refinement {
+  std::unique_ptr<tpp::WorkStealingPool> pool;
+  std::vector<struct mesh> workmeshes;   /* Statistic counters per chunk. */
+  std::vector<struct refinecandidate> candidates;
+  std::vector<struct cavitymark> marks;    /* Open addressing, 2^n slots. */
+  int round;
+};
+
+/*****************************************************************************/
+/*                                                                           */
+/*  findmark()   Find the slot of a triangle in the marks of this round, or  */
+/*               the empty slot for it.                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+struct cavitymark *findmark(struct refinement *refine, triangle *tri)
+#else /* not ANSI_DECLARATORS */
+struct cavitymark *findmark(refine, tri)
+struct refinement *refine;
+triangle *tri;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  size_t mask;
+  size_t slot;
+
+  mask = refine->marks.size() - 1;
+  slot = (size_t) ((((unsigned long long) (int_ptr_type) tri >> 3) *
+                    0x9e3779b97f4a7c15ull) >> 32) & mask;
+  while ((refine->marks[slot].round == refine->round) &&
+         (refine->marks[slot].tri != tri)) {
+    slot = (slot + 1) & mask;
+  }
+  return &refine->marks[slot];
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  findcavity()   Find the Steiner point of a bad triangle and its cavity.  */
+/*                                                                           */
+/*  Doesn't change the mesh, so it can be called by several threads, each    */
+/*  with its own copy of the mesh structure for the statistic counters.      */
+/*  Returns REFINECAVITY if the Steiner point can be inserted into the       */
+/*  cavity, REFINESTALE if the triangle isn't in the mesh anymore, and       */
+/*  REFINESERIALLY if splittriangle() must decide.                           */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+enum refineaction findcavity(struct mesh *m, struct behavior *b,
+                             struct refinecandidate *cand)
+#else /* not ANSI_DECLARATORS */
+enum refineaction findcavity(m, b, cand)
+struct mesh *m;
+struct behavior *b;
+struct refinecandidate *cand;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri searchtri;
+  struct otri cavitytri, neighbor;
+  struct osub edgesubseg;
+  struct cavityedge edge;
+  vertex norg, ndest, napex;
+  enum locateresult intersect;
+  size_t edgecount;
+  size_t i, j;
+  triangle ptr;                         /* Temporary variable used by sym(). */
+  subseg sptr;                      /* Temporary variable used by tspivot(). */
+
+  decode(cand->badtri->poortri, searchtri);
+  org(searchtri, cand->borg);
+  dest(searchtri, cand->bdest);
+  apex(searchtri, cand->bapex);
+  /* Is this still the same triangle?  (See splittriangle().) */
+  if (deadtri(searchtri.tri) || (cand->borg != cand->badtri->triangorg) ||
+      (cand->bdest != cand->badtri->triangdest) ||
+      (cand->bapex != cand->badtri->triangapex)) {
+    return REFINESTALE;
+  }
+
+  findcircumcenter(m, b, cand->borg, cand->bdest, cand->bapex,
+                   cand->newpoint, &cand->xi, &cand->eta, 1);
+  if (((cand->newpoint[0] == cand->borg[0]) &&
+       (cand->newpoint[1] == cand->borg[1])) ||
+      ((cand->newpoint[0] == cand->bdest[0]) &&
+       (cand->newpoint[1] == cand->bdest[1])) ||
+      ((cand->newpoint[0] == cand->bapex[0]) &&
+       (cand->newpoint[1] == cand->bapex[1]))) {
+    return REFINESERIALLY;
+  }
+  /* Search from an edge the circumcenter is left of, as splittriangle(). */
+  if (cand->eta < cand->xi) {
+    lprevself(searchtri);
+  }
+  intersect = preciselocate(m, b, cand->newpoint, &searchtri, 1);
+  if ((intersect == ONVERTEX) || (intersect == OUTSIDE)) {
+    return REFINESERIALLY;
+  }
+  if (intersect == ONEDGE) {
+    /* Boundary edges and subsegments are split by insertvertex(). */
+    sym(searchtri, neighbor);
+    if (neighbor.tri == m->dummytri) {
+      return REFINESERIALLY;
+    }
+    if (m->checksegments) {
+      tspivot(searchtri, edgesubseg);
+      if (edgesubseg.ss != m->dummysub) {
+        return REFINESERIALLY;
+      }
+    }
+  }
+
+  /* Grow the cavity from the triangle containing the Steiner point. */
+  cand->cavity.clear();
+  cand->edges.clear();
+  cand->cavity.push_back(searchtri.tri);
+  for (i = 0; i < cand->cavity.size(); i++) {
+    cavitytri.tri = cand->cavity[i];
+    for (cavitytri.orient = 0; cavitytri.orient < 3; cavitytri.orient++) {
+      sym(cavitytri, neighbor);
+      edgesubseg.ss = m->dummysub;
+      edgesubseg.ssorient = 0;
+      if (m->checksegments) {
+        tspivot(cavitytri, edgesubseg);
+      }
+      if ((neighbor.tri != m->dummytri) && (edgesubseg.ss == m->dummysub)) {
+        if (std::find(cand->cavity.begin(), cand->cavity.end(),
+                      neighbor.tri) != cand->cavity.end()) {
+          /* An edge inside of the cavity. */
+          continue;
+        }
+        org(neighbor, norg);
+        dest(neighbor, ndest);
+        apex(neighbor, napex);
+        if (incircle(m, b, norg, ndest, napex, cand->newpoint) > 0.0) {
+          if (cand->cavity.size() >= (size_t) REFINEMAXCAVITY) {
+            return REFINESERIALLY;
+          }
+          cand->cavity.push_back(neighbor.tri);
+          continue;
+        }
+      }
+
+      /* The edge bounds the cavity.  It must face the Steiner point. */
+      org(cavitytri, edge.edgeorg);
+      dest(cavitytri, edge.edgedest);
+      if (counterclockwise(m, b, edge.edgeorg, edge.edgedest,
+                           cand->newpoint) <= 0.0) {
+        return REFINESERIALLY;
+      }
+      if (edgesubseg.ss != m->dummysub) {
+        /* Would checkseg4encroach() reject the Steiner point? */
+        if (inlens(b, edge.edgeorg, edge.edgedest, cand->newpoint)) {
+          return REFINESERIALLY;
+        }
+        if (neighbor.tri != m->dummytri) {
+          apex(neighbor, napex);
+          if (inlens(b, edge.edgeorg, edge.edgedest, napex)) {
+            return REFINESERIALLY;
+          }
+        }
+      }
+      edge.outside = cavitytri.tri[cavitytri.orient];
+      edge.edgesubseg = sencode(edgesubseg);
+      edge.owner = cavitytri.tri;
+      cand->edges.push_back(edge);
+    }
+  }
+
+  /* A cavity of n triangles without inner vertices has n + 2 edges, */
+  /*   forming a cycle in which each vertex occurs once.             */
+  edgecount = cand->edges.size();
+  if (edgecount != cand->cavity.size() + 2) {
+    return REFINESERIALLY;
+  }
+  for (i = 0; i + 1 < edgecount; i++) {
+    for (j = i + 1; j < edgecount; j++) {
+      if (cand->edges[j].edgeorg == cand->edges[i].edgedest) {
+        break;
+      }
+    }
+    if (j == edgecount) {
+      return REFINESERIALLY;
+    }
+    std::swap(cand->edges[i + 1], cand->edges[j]);
+    for (j = 0; j <= i; j++) {
+      if (cand->edges[j].edgeorg == cand->edges[i + 1].edgeorg) {
+        return REFINESERIALLY;
+      }
+    }
+  }
+  if (cand->edges[edgecount - 1].edgedest != cand->edges[0].edgeorg) {
+    return REFINESERIALLY;
+  }
+
+  /* The new triangles inherit the attributes of the old ones. */
+  cand->edgeattribs.clear();
+  for (i = 0; i < edgecount; i++) {
+    cavitytri.tri = cand->edges[i].owner;
+    for (j = 0; j < (size_t) m->eextras; j++) {
+      cand->edgeattribs.push_back(elemattribute(cavitytri, j));
+    }
+    if (b->vararea) {
+      cand->edgeattribs.push_back(areabound(cavitytri));
+    }
+  }
+  return REFINECAVITY;
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  insertcavity()   Insert a Steiner point by retriangulating its cavity.   */
+/*                                                                           */
+/*  The cavity's triangles and the two new triangles of the candidate become */
+/*  a fan around the new vertex.  Only the cavity, its neighbours and its    */
+/*  subsegments are written, so cavities found by findcavity() which don't   */
+/*  overlap each other or the neighbours of each other can be inserted by    */
+/*  several threads.  Outer space is shared by all cavities, so its bonds    */
+/*  to the new triangles are left to the caller.                             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void insertcavity(struct mesh *m, struct behavior *b,
+                  struct refinecandidate *cand)
+#else /* not ANSI_DECLARATORS */
+void insertcavity(m, b, cand)
+struct mesh *m;
+struct behavior *b;
+struct refinecandidate *cand;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri newtri, nexttri, prevtri, outside;
+  struct osub edgesubseg;
+  vertex newvertex;
+  REAL *attribs;
+  int edgecount, cavitysize;
+  int i, j;
+
+  newvertex = cand->newvertex;
+  newvertex[0] = cand->newpoint[0];
+  newvertex[1] = cand->newpoint[1];
+  for (i = 2; i < 2 + m->nextras; i++) {
+    /* Interpolate the vertex attributes at the circumcenter. */
+    newvertex[i] = cand->borg[i] + cand->xi * (cand->bdest[i] - cand->borg[i])
+                   + cand->eta * (cand->bapex[i] - cand->borg[i]);
+  }
+  setvertexmark(newvertex, 0);
+  setvertextype(newvertex, FREEVERTEX);
+
+  edgecount = (int) cand->edges.size();
+  cavitysize = (int) cand->cavity.size();
+  attribs = cand->edgeattribs.data();
+  for (i = 0; i < edgecount; i++) {
+    /* Triangle i joins the i-th edge to the new vertex. */
+    newtri.tri = (i < cavitysize) ? cand->cavity[i] :
+                                    cand->newtris[i - cavitysize];
+    newtri.orient = 0;
+    j = (i + 1) % edgecount;
+    nexttri.tri = (j < cavitysize) ? cand->cavity[j] :
+                                     cand->newtris[j - cavitysize];
+    nexttri.orient = 2;
+    j = (i + edgecount - 1) % edgecount;
+    prevtri.tri = (j < cavitysize) ? cand->cavity[j] :
+                                     cand->newtris[j - cavitysize];
+    prevtri.orient = 1;
+
+    setorg(newtri, cand->edges[i].edgeorg);
+    setdest(newtri, cand->edges[i].edgedest);
+    setapex(newtri, newvertex);
+    newtri.tri[1] = encode(nexttri);
+    newtri.tri[2] = encode(prevtri);
+    newtri.tri[0] = cand->edges[i].outside;
+    decode(cand->edges[i].outside, outside);
+    if (outside.tri != m->dummytri) {
+      outside.tri[outside.orient] = encode(newtri);
+    }
+    newtri.tri[6] = (triangle) cand->edges[i].edgesubseg;
+    newtri.tri[7] = (triangle) m->dummysub;
+    newtri.tri[8] = (triangle) m->dummysub;
+    sdecode(cand->edges[i].edgesubseg, edgesubseg);
+    if (edgesubseg.ss != m->dummysub) {
+      edgesubseg.ss[6 + edgesubseg.ssorient] = (subseg) encode(newtri);
+    }
+    for (j = 0; j < m->eextras; j++) {
+      setelemattribute(newtri, j, *attribs++);
+    }
+    if (b->vararea) {
+      setareabound(newtri, *attribs++);
+    }
+  }
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/*  refineround()   Insert the Steiner points of a batch of bad triangles    */
+/*                  by several threads.                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void refineround(struct mesh *m, struct behavior *b,
+                 struct refinement *refine)
+#else /* not ANSI_DECLARATORS */
+void refineround(m, b, refine)
+struct mesh *m;
+struct behavior *b;
+struct refinement *refine;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct refinecandidate *cand;
+  struct cavitymark *mark;
+  struct otri newtri, outside;
+  size_t marks, slots;
+  int batch, chunks;
+  int accepted, conflict;
+  int i;
+  size_t j;
+
+  batch = REFINEBATCHPERTHREAD * b->threads;
+  if (batch > m->badtriangles.items) {
+    batch = (int) m->badtriangles.items;
+  }
+  if ((int) refine->candidates.size() < batch) {
+    refine->candidates.resize(batch);
+  }
+  for (i = 0; i < batch; i++) {
+    refine->candidates[i].badtri = dequeuebadtriang(m);
+  }
+
+  /* Find the Steiner points and their cavities. */
+  chunks = (int) refine->workmeshes.size();
+  vertexchunks(refine->pool.get(), chunks, [=](int chunk) {
+    int first, last, c;
+
+    first = (int) ((long long) batch * chunk / chunks);
+    last = (int) ((long long) batch * (chunk + 1) / chunks);
+    for (c = first; c < last; c++) {
+      refine->candidates[c].action =
+        findcavity(&refine->workmeshes[chunk], b, &refine->candidates[c]);
+    }
+  });
+
+  /* Choose the cavities which don't touch each other, in queue order. */
+  /*   The hash table gets at least twice as many slots as marks.       */
+  marks = 0;
+  for (i = 0; i < batch; i++) {
+    if (refine->candidates[i].action == REFINECAVITY) {
+      marks += refine->candidates[i].cavity.size() +
+               refine->candidates[i].edges.size();
+    }
+  }
+  refine->round++;
+  if (refine->marks.size() < 2 * marks) {
+    slots = 1024;
+    while (slots < 2 * marks) {
+      slots *= 2;
+    }
+    refine->marks.assign(slots, cavitymark());
+    refine->round = 1;
+  }
+  accepted = 0;
+  for (i = 0; i < batch; i++) {
+    cand = &refine->candidates[i];
+    if (cand->action != REFINECAVITY) {
+      continue;
+    }
+    conflict = (m->steinerleft > 0) && (accepted >= m->steinerleft);
+    for (j = 0; !conflict && (j < cand->cavity.size()); j++) {
+      mark = findmark(refine, cand->cavity[j]);
+      conflict = mark->round == refine->round;
+    }
+    for (j = 0; !conflict && (j < cand->edges.size()); j++) {
+      decode(cand->edges[j].outside, outside);
+      mark = findmark(refine, outside.tri);
+      conflict = (mark->round == refine->round) && (mark->mark == 1);
+    }
+    if (conflict) {
+      cand->action = REFINECONFLICT;
+      continue;
+    }
+    for (j = 0; j < cand->cavity.size(); j++) {
+      mark = findmark(refine, cand->cavity[j]);
+      mark->tri = cand->cavity[j];
+      mark->round = refine->round;
+      mark->mark = 1;
+    }
+    for (j = 0; j < cand->edges.size(); j++) {
+      decode(cand->edges[j].outside, outside);
+      mark = findmark(refine, outside.tri);
+      if ((outside.tri != m->dummytri) && (mark->round != refine->round)) {
+        mark->tri = outside.tri;
+        mark->round = refine->round;
+        mark->mark = 2;
+      }
+    }
+    accepted++;
+    cand->newvertex = (vertex) poolalloc(&m->vertices);
+    maketriangle(m, b, &newtri);
+    cand->newtris[0] = newtri.tri;
+    maketriangle(m, b, &newtri);
+    cand->newtris[1] = newtri.tri;
+  }
+  if (b->verbose > 1) {
+    printf("  Inserting %d of %d Steiner points in parallel.\n", accepted,
+           batch);
+  }
+
+  /* Retriangulate the chosen cavities. */
+  vertexchunks(refine->pool.get(), chunks, [=](int chunk) {
+    int first, last, c;
+
+    first = (int) ((long long) batch * chunk / chunks);
+    last = (int) ((long long) batch * (chunk + 1) / chunks);
+    for (c = first; c < last; c++) {
+      if (refine->candidates[c].action == REFINECAVITY) {
+        insertcavity(m, b, &refine->candidates[c]);
+      }
+    }
+  });
+
+  for (i = 0; i < batch; i++) {
+    cand = &refine->candidates[i];
+    if (cand->action == REFINECAVITY) {
+      for (j = 0; j < cand->edges.size(); j++) {
+        newtri.tri = (j < cand->cavity.size()) ? cand->cavity[j] :
+                     cand->newtris[j - cand->cavity.size()];
+        newtri.orient = 0;
+        decode(cand->edges[j].outside, outside);
+        if (outside.tri == m->dummytri) {
+          /* Bond the new triangle to outer space. */
+          m->dummytri[outside.orient] = encode(newtri);
+        }
+        /* Check the new triangle for quality. */
+        testtriangle(m, b, &newtri);
+      }
+      otricopy(newtri, m->recenttri);
+      if (m->steinerleft > 0) {
+        m->steinerleft--;
+      }
+      pooldealloc(&m->badtriangles, (VOID *) cand->badtri);
+    } else if (cand->action == REFINESTALE) {
+      pooldealloc(&m->badtriangles, (VOID *) cand->badtri);
+    } else if (cand->action == REFINECONFLICT) {
+      /* Try again in the next round. */
+      enqueuebadtriang(m, b, cand->badtri);
+    }
+  }
+
+  /* The mesh has changed, so splittriangle() checks these triangles again. */
+  for (i = 0; i < batch; i++) {
+    cand = &refine->candidates[i];
+    if (cand->action == REFINESERIALLY) {
+      if (m->steinerleft != 0) {
+        fixbadtriangle(m, b, cand->badtri);
+      } else {
+        enqueuebadtriang(m, b, cand->badtri);
+      }
+    }
+  }
+}
+
+#endif /* not CDT_ONLY */
+
 /*****************************************************************************/
 /*                                                                           */
 /*  enforcequality()   Remove all the encroached subsegments and bad         */
@@ -13962,14 +17348,24 @@ struct behavior *b;
 {
   TRACE(" -> enforcequality");
   struct badtriang *badtri;
+  struct refinement refine;
+  long firstvertices, limit;
+  int stop;
   int i;
 
   if (!b->quiet) {
     printf("Adding Steiner points to enforce quality.\n");	
   }
+  /* The progress is the number of Steiner points (mrkkrj). */
+  firstvertices = m->vertices.items;
+  limit = (b->steiner > 0) ? (long) b->steiner : 0l;
+  if (reportprogress(PROGRESSQUALITY, 0l, limit)) {
+    /* Stop as if the Steiner point limit was reached. */
+    m->steinerleft = 0;
+  }
   /* Initialize the pool of encroached subsegments. */
-  poolinit(&m->badsubsegs, sizeof(struct badsubseg), BADSUBSEGPERBLOCK,
-           BADSUBSEGPERBLOCK, 0);
+  poolreinit(&m->badsubsegs, sizeof(struct badsubseg), BADSUBSEGPERBLOCK,
+             BADSUBSEGPERBLOCK, 0);
   if (b->verbose) {
     printf("  Looking for encroached subsegments.\n");
   }
@@ -13984,10 +17380,11 @@ struct behavior *b;
   /*   triangulation should be (conforming) Delaunay.            */
 
   /* Next, we worry about enforcing triangle quality. */
-  if ((b->minangle > 0.0) || b->vararea || b->fixedarea || b->usertest) {
+  if ((b->minangle > 0.0) || b->vararea || b->fixedarea || b->usertest ||
+      (sizingfunc != nullptr)) {
     /* Initialize the pool of bad triangles. */
-    poolinit(&m->badtriangles, sizeof(struct badtriang), BADTRIPERBLOCK,
-             BADTRIPERBLOCK, 0);
+    poolreinit(&m->badtriangles, sizeof(struct badtriang), BADTRIPERBLOCK,
+               BADTRIPERBLOCK, 0);
     /* Initialize the queues of bad triangles. */
     for (i = 0; i < 4096; i++) {
       m->queuefront[i] = (struct badtriang *) NULL;
@@ -13996,27 +17393,53 @@ struct behavior *b;
     /* Test all triangles to see if they're bad. */
     tallyfaces(m, b);
     /* Initialize the pool of recently flipped triangles. */
-    poolinit(&m->flipstackers, sizeof(struct flipstacker), FLIPSTACKERPERBLOCK,
-             FLIPSTACKERPERBLOCK, 0);
+    poolreinit(&m->flipstackers, sizeof(struct flipstacker),
+               FLIPSTACKERPERBLOCK, FLIPSTACKERPERBLOCK, 0);
     m->checkquality = 1;
     if (b->verbose) {
       printf("  Splitting bad triangles.\n");
     }
+    if ((b->threads > 1) && b->usesegments) {
+      /* Insert the Steiner points of many bad triangles in parallel.  The */
+      /*   mesh structure doesn't change while refining, so its copies     */
+      /*   can be made once.                                               */
+      refine.pool.reset(new tpp::WorkStealingPool(b->threads - 1));
+      refine.round = 0;
+      refine.workmeshes.assign(b->threads * REFINECHUNKSPERTHREAD, *m);
+      for (i = 0; i < (int) refine.workmeshes.size(); i++) {
+        refine.workmeshes[i].incirclecount = 0;
+        refine.workmeshes[i].counterclockcount = 0;
+        refine.workmeshes[i].incircleexactcount = 0;
+        refine.workmeshes[i].counterclockexactcount = 0;
+        refine.workmeshes[i].circumcentercount = 0;
+      }
+      if (b->verbose) {
+        printf("  Using %d threads.\n", b->threads);
+      }
+    }
     while ((m->badtriangles.items > 0) && (m->steinerleft != 0)) {
-      /* Fix one bad triangle by inserting a vertex at its circumcenter. */
-      badtri = dequeuebadtriang(m);
-      splittriangle(m, b, badtri);
-      if (m->badsubsegs.items > 0) {
-        /* Put bad triangle back in queue for another try later. */
-        enqueuebadtriang(m, b, badtri);
-        /* Fix any encroached subsegments that resulted. */
-        /*   Record any new bad triangles that result.   */
-        splitencsegs(m, b, 1);
+      if (refine.pool && (m->badtriangles.items >= REFINEMINBATCH)) {
+        refineround(m, b, &refine);
+        stop = reportprogress(PROGRESSQUALITY,
+                              m->vertices.items - firstvertices, limit);
       } else {
-        /* Return the bad triangle to the pool. */
-        pooldealloc(&m->badtriangles, (VOID *) badtri);
+        badtri = dequeuebadtriang(m);
+        fixbadtriangle(m, b, badtri);
+        stop = progressstep(PROGRESSQUALITY,
+                            m->vertices.items - firstvertices, limit);
+      }
+      if (stop) {
+        m->steinerleft = 0;
       }
     }
+    for (i = 0; i < (int) refine.workmeshes.size(); i++) {
+      m->incirclecount += refine.workmeshes[i].incirclecount;
+      m->counterclockcount += refine.workmeshes[i].counterclockcount;
+      m->incircleexactcount += refine.workmeshes[i].incircleexactcount;
+      m->counterclockexactcount +=
+        refine.workmeshes[i].counterclockexactcount;
+      m->circumcentercount += refine.workmeshes[i].circumcentercount;
+    }
   }
   /* At this point, if the "-D" switch was selected and we haven't run out  */
   /*   of Steiner points, the triangulation should be (conforming) Delaunay */
@@ -14038,6 +17461,9 @@ struct behavior *b;
     printf("  the -S switch) slightly and try again.\n\n");
 	TRACE(" I ran out of Steiner points!!!");
   }
+  /* Now the total is known. */
+  reportprogress(PROGRESSQUALITY, m->vertices.items - firstvertices,
+                 m->vertices.items - firstvertices);
 }
 
 #endif /* not CDT_ONLY */
@@ -14976,6 +18402,45 @@ struct behavior *b;
   }
 }
 
+/*****************************************************************************/
+/*                                                                           */
+/*  numbertriangles()   Number the triangles densely.  (mrkkrj)             */
+/*                                                                           */
+/*  Each triangle is assigned its number in the order of triangletraverse(), */
+/*  i.e. the order in which writeelements() writes the triangles, and is     */
+/*  stored at this position of `table'.  The dummy triangle gets -1, so that */
+/*  a neighbor on the convex hull has the number -1.                         */
+/*                                                                           */
+/*  Requires the `triangleids' flag set before the triangle pool is          */
+/*  initialized, and a table big enough for all the triangles.               */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifdef ANSI_DECLARATORS
+void numbertriangles(struct mesh *m, triangle **table)
+#else /* not ANSI_DECLARATORS */
+void numbertriangles(m, table)
+struct mesh *m;
+triangle **table;
+#endif /* not ANSI_DECLARATORS */
+
+{
+  struct otri triangleloop;
+  int trianglenumber;
+
+  triangleloop.tri = m->dummytri;
+  triangleid(triangleloop) = -1;
+
+  traversalinit(&m->triangles);
+  trianglenumber = 0;
+  triangleloop.tri = triangletraverse(m);
+  while (triangleloop.tri != (triangle *) NULL) {
+    triangleid(triangleloop) = trianglenumber;
+    table[trianglenumber++] = triangleloop.tri;
+    triangleloop.tri = triangletraverse(m);
+  }
+}
+
 /*****************************************************************************/
 /*                                                                           */
 /*  writeelements()   Write the triangles to an .ele file.                   */
@@ -16435,6 +19900,14 @@ struct behavior *b;
       printf("  Number of 3D orientation tests: %ld\n", m->orient3dcount);
     }
     printf("  Number of 2D orientation tests: %ld\n", m->counterclockcount);
+    if (!b->noexact) {
+      if (!b->weighted) {
+        printf("  Number of exact incircle tests: %ld\n",
+               m->incircleexactcount);
+      }
+      printf("  Number of exact 2D orientation tests: %ld\n",
+             m->counterclockexactcount);
+    }
     if (m->hyperbolacount > 0) {
       printf("  Number of right-of-hyperbola tests: %ld\n",
              m->hyperbolacount);
@@ -16812,7 +20285,7 @@ char **argv;
   }
 #endif /* not REDUCED */
 
-  triangledeinit(&m, &b);
+  triangledeinit(&m);
 #ifndef TRILIBRARY
   return 0;
 #endif /* not TRILIBRARY */
@@ -0,0 +1,181 @@
+ /**
+    @file  trpp_predicates_tests.cpp
+    @brief test cases for the TriLib's predicates, using the wrapped TriLib code directly
+ */
+
+// the same configuration of the TriLib's code as in tpp_impl.cpp!
+#define NO_TIMER
+#define DREDUCED
+#define ANSI_DECLARATORS
+#define TRILIBRARY
+#define TRILIB_EXIT_BY_EXCEPTION
+#define TRIFILES_OUTPUT_SUPPORT
+#define TRIFILES_READ_SUPPORT
+
+#ifndef TRIANGLE_NO_TRILIB_SELFCHECK
+#  define SELF_CHECK
+#endif
+
+#ifndef _WIN64
+#  define CPU86
+#endif
+
+#ifndef _WIN32
+#define LINUX
+#undef CPU86
+#endif
+
+#include "tpp_trace.hpp"
+
+// only the Triwrap class, the lookup arrays are defined in tpp_impl.cpp
+#define TRIWRAP_ONLY_DEFINITIONS
+#include "triangle_impl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+#include <array>
+#include <random>
+#include <memory>
+#include <cmath>
+#include <limits>
+
+
+namespace
+{
+   int sign(double value)
+   {
+      return (value > 0.0) - (value < 0.0);
+   }
+}
+
+
+TEST_CASE("Batched predicates", "[trpp]")
+{
+   // far away from the origin, so that the filters often can't decide
+   const double x0 = 5.4e6;
+   const double y0 = 4.1e5;
+   const int testCount = 20000;
+
+   std::unique_ptr<Triwrap> triLib(new Triwrap());
+   std::unique_ptr<Triwrap::mesh> m(new Triwrap::mesh());
+   std::unique_ptr<Triwrap::behavior> b(new Triwrap::behavior());
+   triLib->exactinit();
+
+   std::mt19937 randGen(2026);
+   std::uniform_real_distribution<double> coord(0.0, 1000.0);
+   std::uniform_real_distribution<double> unit(0.0, 1.0);
+   std::uniform_int_distribution<int> ulps(-2, 2);
+
+   auto perturb = [&](double v)
+   {
+      int steps = ulps(randGen);
+      for (int k = 0; k < std::abs(steps); ++k)
+      {
+         v = std::nextafter(v, steps > 0 ? std::numeric_limits<double>::max() : 0.0);
+      }
+      return v;
+   };
+
+   // the tests' vertices, 2 tests of 4 vertices each
+   std::vector<std::array<REAL, 2>> coords(2 * 4);
+   Triwrap::vertex pa[2], pb[2], pc[2], pd[2];
+
+   for (int i = 0; i < 2; ++i)
+   {
+      pa[i] = coords[4 * i].data();
+      pb[i] = coords[4 * i + 1].data();
+      pc[i] = coords[4 * i + 2].data();
+      pd[i] = coords[4 * i + 3].data();
+   }
+
+   SECTION("TEST B.1: batched counterclockwise() agrees with the scalar one on nearly collinear vertices")
+   {
+      for (int n = 0; n < testCount; ++n)
+      {
+         for (int i = 0; i < 2; ++i)
+         {
+            if (n % 2 == 0)
+            {
+               // a point of the line y = k * x near the origin, moved by a few ulps, and two exact ones far away
+               double k = 1 + n % 3;
+               double x = unit(randGen);
+
+               pa[i][0] = (int)coord(randGen);  pa[i][1] = k * pa[i][0];
+               pb[i][0] = (int)coord(randGen);  pb[i][1] = k * pb[i][0];
+               pc[i][0] = perturb(x);           pc[i][1] = perturb(k * x);
+            }
+            else
+            {
+               pa[i][0] = x0 + coord(randGen);
+               pa[i][1] = y0 + coord(randGen);
+               pb[i][0] = x0 + coord(randGen);
+               pb[i][1] = y0 + coord(randGen);
+
+               // a rounded point of the line, moved by a few ulps
+               double t = unit(randGen);
+               pc[i][0] = perturb(pa[i][0] + t * (pb[i][0] - pa[i][0]));
+               pc[i][1] = perturb(pa[i][1] + t * (pb[i][1] - pa[i][1]));
+            }
+         }
+
+         REAL results[2];
+         triLib->counterclockwisebatch(m.get(), b.get(), 2, pa, pb, pc, results);
+
+         for (int i = 0; i < 2; ++i)
+         {
+            REQUIRE(sign(results[i]) == sign(triLib->counterclockwise(m.get(), b.get(), pa[i], pb[i], pc[i])));
+         }
+      }
+
+      REQUIRE(m->counterclockexactcount > 0);
+   }
+
+   SECTION("TEST B.2: batched incircle() agrees with the scalar one on nearly cocircular vertices")
+   {
+      const double pi = 3.14159265358979323846;
+
+      for (int n = 0; n < testCount; ++n)
+      {
+         for (int i = 0; i < 2; ++i)
+         {
+            if (n % 4 == 0)
+            {
+               // an exactly cocircular square of the grid, moved by a few ulps
+               double x = x0 + 0.25 * (int)coord(randGen);
+               double y = y0 + 0.25 * (int)coord(randGen);
+
+               pa[i][0] = perturb(x);         pa[i][1] = perturb(y);
+               pb[i][0] = perturb(x + 0.25);  pb[i][1] = perturb(y);
+               pc[i][0] = perturb(x + 0.25);  pc[i][1] = perturb(y + 0.25);
+               pd[i][0] = perturb(x);         pd[i][1] = perturb(y + 0.25);
+            }
+            else
+            {
+               // rounded points of a circle, in counterclockwise order
+               double cx = x0 + coord(randGen);
+               double cy = y0 + coord(randGen);
+               double r = 1.0 + coord(randGen);
+               double angle = 2 * pi * unit(randGen);
+
+               for (Triwrap::vertex p : { pa[i], pb[i], pc[i], pd[i] })
+               {
+                  p[0] = perturb(cx + r * std::cos(angle));
+                  p[1] = perturb(cy + r * std::sin(angle));
+                  angle += 0.5 * pi * unit(randGen);
+               }
+            }
+         }
+
+         REAL results[2];
+         triLib->incirclebatch(m.get(), b.get(), 2, pa, pb, pc, pd, results);
+
+         for (int i = 0; i < 2; ++i)
+         {
+            REQUIRE(sign(results[i]) == sign(triLib->incircle(m.get(), b.get(), pa[i], pb[i], pc[i], pd[i])));
+         }
+      }
+
+      REQUIRE(m->incircleexactcount > 0);
+   }
+}
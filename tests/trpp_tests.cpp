@@ -16,6 +16,15 @@
 #endif
 #include <algorithm>
 #include <set>
+#include <array>
+#include <random>
+#include <fstream>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <atomic>
 
 // debug support
 #define DEBUG_OUTPUT_STDOUT false 
@@ -753,6 +762,72 @@ TEST_CASE("Reading files", "[trpp]")
        trPlsgGenerator.Triangulate(quality, dbgOutput);
        REQUIRE(trPlsgGenerator.triangleCount() == 2787);
     }
+
+    SECTION("TEST 7.5: reading a BIG .poly file with multiple threads")
+    {
+       // points on a grid, with comments, attributes, markers and DOS line ends
+       const int pointCt = 40000;
+       const int gridSize = 200;
+
+       std::ofstream polyFile("./test-big.poly", std::ios::binary);
+       polyFile.precision(17);
+
+       polyFile << "# written by TEST 7.5\r\n" << pointCt << " 2 1 1\r\n";
+       for (int i = 0; i < pointCt; ++i)
+       {
+          polyFile << i << "  " << (i % gridSize) * 0.1 << " " << (i / gridSize) * 0.3 << "  " << i * 0.5 << " " << i % 3 << "\r\n";
+          if (i % 1000 == 0)
+          {
+             polyFile << "  # vertex " << i << "\r\n\r\n";
+          }
+       }
+
+       polyFile << (gridSize - 1) << " 1\r\n";
+       for (int i = 0; i < gridSize - 1; ++i)
+       {
+          polyFile << i << " " << i << " " << i + 1 << " 1\r\n";
+       }
+
+       polyFile << "1\r\n0 1.05 0.15 # hole\r\n";
+       polyFile.close();
+
+       std::vector<Delaunay::Point> points;
+       std::vector<int> segments;
+       std::vector<Delaunay::Point> holes;
+       std::vector<Delaunay::Point4> regions;
+
+       trReader.setThreadCount(4);
+       ioStatus = trReader.readSegments("./test-big.poly", points, segments, holes, regions);
+
+       REQUIRE(ioStatus == true);
+       REQUIRE(points.size() == pointCt);
+       REQUIRE(segments.size() / 2 == gridSize - 1);
+       REQUIRE(holes.size() == 1);
+       REQUIRE(regions.size() == 0);
+
+       bool pointsOK = true;
+       for (int i = 0; i < pointCt; ++i)
+       {
+          pointsOK = pointsOK && points[i][0] == (i % gridSize) * 0.1 && points[i][1] == (i / gridSize) * 0.3;
+       }
+       REQUIRE(pointsOK);
+
+       // numbered from 0 in the file
+       REQUIRE(segments[0] == 0);
+       REQUIRE(segments.back() == gridSize - 1);
+       REQUIRE(holes[0][0] == 1.05);
+
+       // same as with a single thread
+       Delaunay trSingleReader;
+       std::vector<Delaunay::Point> singlePoints;
+       std::vector<int> singleSegments;
+
+       ioStatus = trSingleReader.readSegments("./test-big.poly", singlePoints, singleSegments, holes, regions);
+
+       REQUIRE(ioStatus == true);
+       REQUIRE(singlePoints == points);
+       REQUIRE(singleSegments == segments);
+    }
 }
 
 
@@ -835,6 +910,120 @@ TEST_CASE("Writing files", "[trpp]")
         REQUIRE(segments.size() == pslgDelaunaySegments.size());  
         REQUIRE(holes.size() == pslgHoles.size());
     }
+
+    SECTION("TEST 8.3: streaming triangulation of a .node file")
+    {
+        // spatially coherent input: sorted by x
+        std::vector<Delaunay::Point> randomPoints;
+        std::mt19937 randGen(1234);
+        std::uniform_real_distribution<double> coord(0.0, 100.0);
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            randomPoints.push_back(Delaunay::Point(coord(randGen), coord(randGen)));
+        }
+        std::sort(randomPoints.begin(), randomPoints.end(), 
+                  [](const Delaunay::Point& a, const Delaunay::Point& b) { return a[0] < b[0]; });
+
+        Delaunay trStreamWriter(randomPoints);
+        ioStatus = trStreamWriter.savePoints("./test.node");
+        REQUIRE(ioStatus == true);
+
+        auto sorted = [](std::array<int, 3> tri)
+        {
+            std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+            return tri;
+        };
+
+        std::set<std::array<int, 3>> streamed;
+        int streamedCount = 0;
+        bool pointsOK = true;
+
+        ioStatus = trReader.triangulateStream("./test.node", 
+            [&](const StreamedTriangle& t)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    const auto& p = randomPoints[t.vertexIds[i]];
+                    pointsOK = pointsOK && p[0] == t.points[i][0] && p[1] == t.points[i][1];
+                }
+                streamed.insert(sorted({ t.vertexIds[0], t.vertexIds[1], t.vertexIds[2] }));
+                ++streamedCount;
+            }, 
+            64); // small cells, to free triangles early
+
+        REQUIRE(ioStatus == true);
+        REQUIRE(pointsOK);
+
+        // same as in memory?
+        Delaunay trInMemory(randomPoints);
+        trInMemory.Triangulate();
+
+        std::set<std::array<int, 3>> inMemory;
+        for (const auto& f : trInMemory.faces())
+        {
+            inMemory.insert(sorted({ f.Org(), f.Dest(), f.Apex() }));
+        }
+
+        REQUIRE(streamedCount == trInMemory.triangleCount());
+        REQUIRE(streamed == inMemory);
+
+        // missing file
+        ioStatus = trReader.triangulateStream("./no_such_file.node", [](const StreamedTriangle&) {});
+        REQUIRE(ioStatus == false);
+    }
+
+    SECTION("TEST 8.4: writing a binary mesh file")
+    {
+        std::vector<Delaunay::Point> pslgHoles;
+        pslgHoles.push_back(Delaunay::Point(1, 1));
+
+        REQUIRE(trWriter.setSegmentConstraint(pslgDelaunaySegments));
+        REQUIRE(trWriter.setHolesConstraint(pslgHoles));
+
+        // points and constraints only
+        ioStatus = trWriter.saveBinary("./test.tppb");
+        REQUIRE(ioStatus == true);
+
+        MeshBuffers stored;
+        ioStatus = trReader.readBinary("./test.tppb", &stored);
+
+        REQUIRE(ioStatus == true);
+        REQUIRE(stored.vertexCount == (int)pslgDelaunayInput.size());
+        REQUIRE(stored.triangleCount == 0);
+
+        // triangulate the read data like the original
+        trWriter.Triangulate(true);
+        trReader.Triangulate(true);
+
+        REQUIRE(trReader.verticeCount() == trWriter.verticeCount());
+        REQUIRE(trReader.triangleCount() == trWriter.triangleCount());
+
+        // the whole mesh
+        ioStatus = trWriter.saveBinary("./test.tppb");
+        REQUIRE(ioStatus == true);
+
+        MeshBuffers expected;
+        REQUIRE(trWriter.exportMesh(expected));
+
+        ioStatus = trReader.readBinary("./test.tppb", &stored);
+
+        REQUIRE(ioStatus == true);
+        REQUIRE(stored.vertexCount == expected.vertexCount);
+        REQUIRE(stored.triangleCount == expected.triangleCount);
+        REQUIRE(stored.points == expected.points);
+        REQUIRE(stored.triangles == expected.triangles);
+        REQUIRE(stored.neighbors == expected.neighbors);
+
+        // not a binary file
+        trWriter.savePoints("./test.node");
+        ioStatus = trReader.readBinary("./test.node");
+        REQUIRE(ioStatus == false);
+        REQUIRE(trReader.verticeCount() == expected.vertexCount); // unchanged
+
+        ioStatus = trReader.readBinary("./no_such_file.tppb");
+        REQUIRE(ioStatus == false);
+    }
 }
 
 
@@ -1360,6 +1549,61 @@ TEST_CASE("Usage of iterators", "[trpp]")
       REQUIRE(mesh.vertices.size() == mesh_meVi.vertices.size());
    }
 
+   SECTION("TEST 11.6: Mesh indexes don't depend on the iteration")
+   {
+      std::vector<tpp::FaceIterator> faces;
+      for (tpp::FaceIterator it = gen.fbegin(); it != gen.fend(); ++it)
+      {
+         faces.push_back(it);
+      }
+
+      // the faces split among several threads, each reading them backwards
+      const int threadCount = 3;
+      std::vector<std::vector<int>> threadIndexes(threadCount, std::vector<int>(3 * faces.size(), -1));
+      std::vector<std::thread> threads;
+
+      for (int t = 0; t < threadCount; ++t)
+      {
+         threads.emplace_back([&, t]()
+            {
+               Point pt;
+               for (size_t i = faces.size(); i-- > 0; )
+               {
+                  if (i % threadCount == (size_t)t)
+                  {
+                     faces[i].Apex(pt, threadIndexes[t][3 * i + 2]);
+                     faces[i].Dest(pt, threadIndexes[t][3 * i + 1]);
+                     faces[i].Org(pt, threadIndexes[t][3 * i]);
+                  }
+               }
+            });
+      }
+      for (auto& thread : threads)
+      {
+         thread.join();
+      }
+
+      // the same indexes as for a sequential iteration, numbered as the vertices are met
+      int maxIndex = -1;
+
+      for (size_t i = 0; i < faces.size(); ++i)
+      {
+         int expected[3];
+         faces[i].Org(p0, expected[0]);
+         faces[i].Dest(p1, expected[1]);
+         faces[i].Apex(p2, expected[2]);
+
+         for (int j = 0; j < 3; ++j)
+         {
+            REQUIRE(threadIndexes[i % threadCount][3 * i + j] == expected[j]);
+            REQUIRE(expected[j] <= maxIndex + 1);
+            maxIndex = std::max(maxIndex, expected[j]);
+         }
+      }
+
+      REQUIRE(maxIndex + 1 == gen.verticeCount());
+   }
+
 }
 
 
@@ -1446,6 +1690,131 @@ TEST_CASE("Triangle's area", "[trpp]")
       }
    }
 
+   SECTION("TEST 12.3: user test as a sizing function")
+   {
+      std::vector<Delaunay::Point> in = { { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+
+      // small triangles near (20, 20), bigger ones further away
+      auto maxAreaAt = [](const Delaunay::Point& p)
+      {
+         double dx = p[0] - 20.0, dy = p[1] - 20.0;
+         return 0.5 + 0.01 * (dx * dx + dy * dy);
+      };
+
+      size_t calls = 0;
+      auto sizing = [&](const Delaunay::Point& org, const Delaunay::Point& dest, const Delaunay::Point& apex, double area)
+      {
+         ++calls;
+         Delaunay::Point centroid((org[0] + dest[0] + apex[0]) / 3, (org[1] + dest[1] + apex[1]) / 3);
+         return area > maxAreaAt(centroid);
+      };
+
+      Delaunay trGenerator(in);
+      trGenerator.Triangulate(true, dbgOutput);
+      int plainTriangles = trGenerator.triangleCount();
+
+      for (unsigned threads : { 1u, 4u })
+      {
+         calls = 0;
+         trGenerator.setThreadCount(threads);
+         trGenerator.setUserConstraint(sizing);
+         trGenerator.Triangulate(true, dbgOutput);
+
+         REQUIRE(calls > 0);
+         REQUIRE(trGenerator.triangleCount() > 10 * plainTriangles);
+
+         double totalArea = 0.0;
+         for (const auto& f : trGenerator.faces())
+         {
+            Delaunay::Point corners[3];
+            f.Org(&corners[0]);
+            f.Dest(&corners[1]);
+            f.Apex(&corners[2]);
+
+            REQUIRE(!sizing(corners[0], corners[1], corners[2], f.area()));
+            totalArea += f.area();
+         }
+         REQUIRE(std::abs(totalArea - 100.0 * 100.0) < 1e-6);
+      }
+
+      // as std::function
+      Delaunay::UserTest userTest = sizing;
+      trGenerator.setThreadCount(1);
+      trGenerator.setUserConstraint(userTest);
+      trGenerator.Triangulate(true, dbgOutput);
+      int userTestTriangles = trGenerator.triangleCount();
+
+      REQUIRE(userTestTriangles > 10 * plainTriangles);
+
+      trGenerator.setUserConstraint(nullptr);
+      trGenerator.Triangulate(true, dbgOutput);
+
+      REQUIRE(trGenerator.triangleCount() == plainTriangles);
+   }
+
+   SECTION("TEST 12.4: background sizing field")
+   {
+      std::vector<Delaunay::Point> in = { { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+
+      // edge lengths growing linearly from 0.5 to 10.5, bilinear interpolation is exact for them
+      auto edgeLength = [](double x, double /*y*/) { return 0.5 + 0.1 * x; };
+
+      SizingGrid grid;
+      grid.dx = grid.dy = 10.0;
+      grid.nx = grid.ny = 11;
+
+      for (int j = 0; j < grid.ny; ++j)
+      {
+         for (int i = 0; i < grid.nx; ++i)
+         {
+            grid.edgeLengths.push_back(edgeLength(i * grid.dx, j * grid.dy));
+         }
+      }
+
+      Delaunay trGenerator(in);
+      REQUIRE(!trGenerator.setSizingField(SizingGrid()));
+
+      auto checkSizes = [&]()
+      {
+         double totalArea = 0.0;
+         for (const auto& f : trGenerator.faces())
+         {
+            Delaunay::Point corners[3];
+            f.Org(&corners[0]);
+            f.Dest(&corners[1]);
+            f.Apex(&corners[2]);
+
+            double h = edgeLength((corners[0][0] + corners[1][0] + corners[2][0]) / 3, 0.0);
+            REQUIRE(f.area() <= std::sqrt(3.0) / 4 * h * h * (1 + 1e-9));
+            totalArea += f.area();
+         }
+         REQUIRE(std::abs(totalArea - 100.0 * 100.0) < 1e-6);
+      };
+
+      REQUIRE(trGenerator.setSizingField(grid));
+      trGenerator.Triangulate(true, dbgOutput);
+      checkSizes();
+      int gridTriangles = trGenerator.triangleCount();
+
+      trGenerator.setSizingField(Delaunay::SizingFunction(edgeLength));
+      trGenerator.Triangulate(true, dbgOutput);
+      checkSizes();
+      int functionTriangles = trGenerator.triangleCount();
+
+      REQUIRE(std::abs(gridTriangles - functionTriangles) < gridTriangles / 20);
+
+      // a graded mesh is much smaller than a uniform one with the smallest triangles
+      Delaunay uniform(in);
+      uniform.setMaxArea((float)(std::sqrt(3.0) / 4 * 0.5 * 0.5));
+      uniform.Triangulate(true, dbgOutput);
+
+      REQUIRE(10 * gridTriangles < uniform.triangleCount());
+
+      trGenerator.setSizingField(nullptr);
+      trGenerator.Triangulate(true, dbgOutput);
+      REQUIRE(trGenerator.triangleCount() < 10);
+   }
+
 }
 
 
@@ -1547,41 +1916,1347 @@ TEST_CASE("Usage of Triangulation Mesh", "[trpp]")
 
    }
 
-   // ... more to come...
-}
+   SECTION("TEST 13.4: Export the mesh into flat arrays")
+   {
+      // a quality CDT, so there are Steiner points, subsegments and area bounds in the triangles
+      std::vector<int> segmentsEndpointIdx = { 0, 9, 3, 9 };
 
+      Delaunay trConstrGenerator(pslgExamplePoints);
+      trConstrGenerator.setSegmentConstraint(segmentsEndpointIdx);
+      trConstrGenerator.useConvexHullWithSegments(true);
+      trConstrGenerator.setQualityConstraints(30.0f, 0.1f);
+      trConstrGenerator.Triangulate(true, dbgOutput);
 
-TEST_CASE("Different triangulation algorithms", "[trpp]")
-{
-   std::vector<Delaunay::Point> pslgDelaunayInput;
-   std::vector<Delaunay::Point> pslgDelaunaySegments;
+      for (Delaunay* triGen : { &trGenerator, &trConstrGenerator })
+      {
+         MeshBuffers buffers;
+         buffers.exportEdges = true;
+         REQUIRE(triGen->exportMesh(buffers));
 
-   preparePLSGTestData(pslgDelaunayInput, pslgDelaunaySegments);
+         REQUIRE(buffers.triangleCount == triGen->triangleCount());
+         REQUIRE(buffers.triangles.size() == 3 * (size_t)triGen->triangleCount());
+         REQUIRE(buffers.points.size() == 2 * (size_t)triGen->verticeCount());
+         REQUIRE(buffers.edges.size() == 2 * (size_t)triGen->edgeCount());
 
-   Delaunay triGen(pslgDelaunayInput);
+         int triIdx = 0;
+         for (const auto& f : triGen->faces())
+         {
+            Delaunay::Point pt;
+            f.Org(&pt);
+            int vertexIdx = buffers.triangles[3 * triIdx];
+
+            REQUIRE(buffers.points[2 * vertexIdx] == pt[0]);
+            REQUIRE(buffers.points[2 * vertexIdx + 1] == pt[1]);
+
+            // the i-th neighbor doesn't contain the i-th vertex
+            for (int i = 0; i < 3; ++i)
+            {
+               int neighbor = buffers.neighbors[3 * triIdx + i];
+               if (neighbor >= 0)
+               {
+                  int* nverts = &buffers.triangles[3 * neighbor];
+                  REQUIRE(std::count(nverts, nverts + 3, buffers.triangles[3 * triIdx + i]) == 0);
+               }
+            }
+            ++triIdx;
+         }
+         REQUIRE(triIdx == buffers.triangleCount);
+
+         // into caller's buffers, the mesh isn't changed by exporting
+         std::vector<int32_t> triangles(3 * buffers.triangleCount);
+         std::vector<int32_t> neighbors(3 * buffers.triangleCount);
+         std::vector<double> points(2 * buffers.vertexCount);
+
+         MeshBuffers callerBuffers;
+         callerBuffers.trianglesBuffer = triangles.data();
+         callerBuffers.neighborsBuffer = neighbors.data();
+         callerBuffers.pointsBuffer = points.data();
+         REQUIRE(triGen->exportMesh(callerBuffers));
+
+         REQUIRE(callerBuffers.triangles.empty());
+         REQUIRE(triangles == buffers.triangles);
+         REQUIRE(neighbors == buffers.neighbors);
+         REQUIRE(points == buffers.points);
+
+         // edge markers are read from the subsegments, which are kept intact
+         MeshBuffers edgeBuffers;
+         edgeBuffers.exportNeighbors = false;
+         edgeBuffers.exportEdges = true;
+         REQUIRE(triGen->exportMesh(edgeBuffers));
+
+         REQUIRE(edgeBuffers.edges == buffers.edges);
+         REQUIRE(edgeBuffers.edgeMarkers == buffers.edgeMarkers);
+      }
 
-   triGen.Triangulate();
-   auto triCountDefault = triGen.triangleCount();
+      // an empty mesh: the segments don't enclose any region, so all triangles get carved away
+      Delaunay trEmptyGenerator(pslgExamplePoints);
+      trEmptyGenerator.setSegmentConstraint(segmentsEndpointIdx);
+      trEmptyGenerator.Triangulate(false, dbgOutput);
 
-   REQUIRE(triCountDefault == 13);
+      REQUIRE(trEmptyGenerator.triangleCount() == 0);
 
-   triGen.setAlgorithm(DivideConquer);
-   triGen.Triangulate();
-   auto triCountDivideConquer = triGen.triangleCount();
+      MeshBuffers emptyBuffers;
+      emptyBuffers.exportEdges = true;
+      REQUIRE(trEmptyGenerator.exportMesh(emptyBuffers));
 
-   REQUIRE(triCountDefault == triCountDivideConquer);
+      REQUIRE(emptyBuffers.triangleCount == 0);
+      REQUIRE(emptyBuffers.edgeCount == 0);
+      REQUIRE(emptyBuffers.triangles.empty());
+      REQUIRE(emptyBuffers.neighbors.empty());
+      REQUIRE(emptyBuffers.edges.empty());
+      REQUIRE(emptyBuffers.points.size() == 2 * (size_t)trEmptyGenerator.verticeCount());
+   }
 
-   triGen.setAlgorithm(Incremental);
-   triGen.Triangulate();
-   auto triCountIncremental = triGen.triangleCount();
+   SECTION("TEST 13.5: Locate arbitrary points in a mesh")
+   {
+      auto orient = [](const Delaunay::Point& a, const Delaunay::Point& b, const Delaunay::Point& c)
+      {
+         return (a[0] - c[0]) * (b[1] - c[1]) - (a[1] - c[1]) * (b[0] - c[0]);
+      };
+      auto contains = [&](const auto& f, const Delaunay::Point& p)
+      {
+         Delaunay::Point a, b, c;
+         f.Org(&a); f.Dest(&b); f.Apex(&c);
+         return orient(a, b, p) >= 0 && orient(b, c, p) >= 0 && orient(c, a, p) >= 0;
+      };
 
-   REQUIRE(triCountDefault == triCountIncremental);
+      std::mt19937 gen(13);
+      std::uniform_real_distribution<double> coord(0.0, 100.0);
+      std::uniform_real_distribution<double> queryCoord(-10.0, 110.0);
 
-   triGen.setAlgorithm(Sweepline);
-   triGen.Triangulate();
-   auto triCountSweepline = triGen.triangleCount();
+      std::vector<Delaunay::Point> randomPoints;
+      for (int i = 0; i < 2000; ++i)
+      {
+         randomPoints.push_back(Delaunay::Point(coord(gen), coord(gen)));
+      }
 
-   REQUIRE(triCountDefault == triCountSweepline);
+      Delaunay trRandomGenerator(randomPoints);
+      trRandomGenerator.Triangulate(dbgOutput);
+
+      std::vector<Delaunay::Point> queries;
+      for (int i = 0; i < 10000; ++i)
+      {
+         queries.push_back(Delaunay::Point(queryCoord(gen), queryCoord(gen)));
+      }
+      for (int i = 0; i < 100; ++i)
+      {
+         queries.push_back(randomPoints[i]);
+      }
+
+      std::vector<TriangulationMesh::LocateResult> results;
+      auto randomMesh = trRandomGenerator.mesh();
+      randomMesh.locatePoints(queries, results);
+
+      REQUIRE(results.size() == queries.size());
+
+      for (size_t i = 0; i < queries.size(); ++i)
+      {
+         const auto& result = results[i];
+         REQUIRE(!result.face.empty());
+
+         if (result.location == TriangulationMesh::LocateResult::Outside)
+         {
+            // the mesh is convex, so no face contains it
+            bool contained = false;
+            for (const auto& f : trRandomGenerator.faces())
+            {
+               contained = contained || contains(f, queries[i]);
+            }
+            REQUIRE(!contained);
+         }
+         else if (result.location == TriangulationMesh::LocateResult::OnVertex)
+         {
+            Delaunay::Point pt;
+            result.face.Org(&pt);
+            REQUIRE(pt == queries[i]);
+         }
+         else
+         {
+            REQUIRE(contains(result.face, queries[i]));
+         }
+      }
+
+      for (size_t i = 10000; i < queries.size(); ++i)
+      {
+         REQUIRE(results[i].location == TriangulationMesh::LocateResult::OnVertex);
+         REQUIRE(results[i].face.Org() == (int)(i - 10000));
+      }
+
+      // same results with several threads
+      std::vector<TriangulationMesh::LocateResult> parallelResults;
+      trRandomGenerator.setThreadCount(4);
+      randomMesh.locatePoints(queries, parallelResults);
+
+      for (size_t i = 0; i < queries.size(); ++i)
+      {
+         REQUIRE(parallelResults[i].location == results[i].location);
+         REQUIRE(parallelResults[i].face == results[i].face);
+      }
+
+      // a mesh with a hole, so walks may be blocked
+      std::vector<Delaunay::Point> squarePoints = {
+         Delaunay::Point(0, 0), Delaunay::Point(10, 0), Delaunay::Point(10, 10), Delaunay::Point(0, 10),
+         Delaunay::Point(4, 4), Delaunay::Point(6, 4), Delaunay::Point(6, 6), Delaunay::Point(4, 6) };
+      std::vector<int> squareSegments = { 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4 };
+      std::vector<Delaunay::Point> squareHoles = { Delaunay::Point(5, 5) };
+
+      Delaunay trHoleGenerator(squarePoints);
+      trHoleGenerator.setSegmentConstraint(squareSegments);
+      trHoleGenerator.setHolesConstraint(squareHoles);
+      trHoleGenerator.Triangulate(false, dbgOutput);
+
+      std::vector<Delaunay::Point> holeQueries = {
+         Delaunay::Point(5, 5), Delaunay::Point(5, 9), Delaunay::Point(5, 1), Delaunay::Point(1, 5),
+         Delaunay::Point(9, 5), Delaunay::Point(5.5, 4.5), Delaunay::Point(20, 5), Delaunay::Point(5, 0) };
+
+      trHoleGenerator.mesh().locatePoints(holeQueries, results);
+
+      REQUIRE(results[0].location == TriangulationMesh::LocateResult::Outside);
+      for (int i = 1; i < 5; ++i)
+      {
+         REQUIRE(results[i].location != TriangulationMesh::LocateResult::Outside);
+         REQUIRE(contains(results[i].face, holeQueries[i]));
+      }
+      REQUIRE(results[5].location == TriangulationMesh::LocateResult::Outside);
+      REQUIRE(results[6].location == TriangulationMesh::LocateResult::Outside);
+      REQUIRE(results[7].location == TriangulationMesh::LocateResult::OnEdge);
+   }
+
+   SECTION("TEST 13.6: Dense triangle ids")
+   {
+      // a quality CDT, so all the optional slots of the triangles are in use
+      std::vector<int> segmentsEndpointIdx = { 0, 9, 3, 9 };
+
+      Delaunay trIdGenerator(pslgExamplePoints);
+      trIdGenerator.setSegmentConstraint(segmentsEndpointIdx);
+      trIdGenerator.setQualityConstraints(30.0f, 0.1f);
+      trIdGenerator.enableTriangleIds();
+      trIdGenerator.Triangulate(true, dbgOutput);
+
+      auto idMesh = trIdGenerator.mesh();
+      int triangles = trIdGenerator.triangleCount();
+
+      MeshBuffers buffers;
+      REQUIRE(trIdGenerator.exportMesh(buffers));
+
+      // ids in the order of iteration and of the export
+      int expectedId = 0;
+      for (auto fit = trIdGenerator.fbegin(); fit != trIdGenerator.fend(); ++fit)
+      {
+         int id = idMesh.triangleId(fit);
+         REQUIRE(id == expectedId++);
+         REQUIRE(idMesh.triangleAt(id) == fit);
+
+         for (char i = 0; i < 3; ++i)
+         {
+            // TriLib's neighbor j is opposite of vertex j, i.e. at edge j + 1
+            int neighbor = idMesh.neighborId(id, i);
+            REQUIRE(neighbor == buffers.neighbors[3 * id + (i + 2) % 3]);
+
+            FaceIterator edge = fit;
+            for (char j = 0; j < i; ++j)
+            {
+               edge = idMesh.Lnext(edge);
+            }
+            REQUIRE(idMesh.triangleId(idMesh.Sym(edge)) == neighbor);
+         }
+      }
+      REQUIRE(expectedId == triangles);
+      REQUIRE(idMesh.triangleId(FaceIterator()) == -1);
+
+      // same triangulation as without the ids
+      Delaunay trNoIdGenerator(pslgExamplePoints);
+      trNoIdGenerator.setSegmentConstraint(segmentsEndpointIdx);
+      trNoIdGenerator.setQualityConstraints(30.0f, 0.1f);
+      trNoIdGenerator.Triangulate(true, dbgOutput);
+      REQUIRE(trNoIdGenerator.triangleCount() == triangles);
+
+      // renumbered after in-place updates
+      Delaunay trUpdateGenerator(pslgExamplePoints);
+      trUpdateGenerator.enableTriangleIds();
+      trUpdateGenerator.Triangulate(dbgOutput);
+      trUpdateGenerator.insertPoints({ Delaunay::Point(2, 0.5), Delaunay::Point(2.1, 2.5) }); // inside of the hull
+
+      auto updatedMesh = trUpdateGenerator.mesh();
+      expectedId = 0;
+      for (auto fit = trUpdateGenerator.fbegin(); fit != trUpdateGenerator.fend(); ++fit)
+      {
+         REQUIRE(updatedMesh.triangleId(fit) == expectedId++);
+      }
+      REQUIRE(expectedId == trUpdateGenerator.triangleCount());
+   }
+
+   SECTION("TEST 13.7: Export the adjacency in CSR format")
+   {
+      // a quality CDT, the triangles' slot used for the numbering holds subsegments
+      std::vector<int> segmentsEndpointIdx = { 0, 9, 3, 9 };
+
+      Delaunay trAdjGenerator(pslgExamplePoints);
+      trAdjGenerator.setSegmentConstraint(segmentsEndpointIdx);
+      trAdjGenerator.setQualityConstraints(30.0f, 0.1f);
+      trAdjGenerator.Triangulate(true, dbgOutput);
+
+      MeshBuffers buffers;
+      buffers.exportEdges = true;
+      REQUIRE(trAdjGenerator.exportMesh(buffers));
+
+      MeshAdjacency adjacency;
+      REQUIRE(trAdjGenerator.exportAdjacency(adjacency));
+      REQUIRE(adjacency.vertexCount == buffers.vertexCount);
+      REQUIRE(adjacency.triangleCount == buffers.triangleCount);
+
+      // the same as derived from the flat arrays
+      std::vector<std::set<int>> vertexNeighbors(buffers.vertexCount);
+      std::vector<std::set<int>> vertexTriangles(buffers.vertexCount);
+
+      for (int t = 0; t < buffers.triangleCount; ++t)
+      {
+         std::vector<int> expectedNeighbors;
+
+         for (int i = 0; i < 3; ++i)
+         {
+            int from = buffers.triangles[3 * t + i];
+            int to = buffers.triangles[3 * t + (i + 1) % 3];
+
+            vertexNeighbors[from].insert(to);
+            vertexNeighbors[to].insert(from);
+            vertexTriangles[from].insert(t);
+
+            if (buffers.neighbors[3 * t + i] >= 0)
+            {
+               expectedNeighbors.push_back(buffers.neighbors[3 * t + i]);
+            }
+         }
+
+         std::vector<int> neighbors(adjacency.triangleNeighbors.begin() + adjacency.triangleOffsets[t], 
+                                    adjacency.triangleNeighbors.begin() + adjacency.triangleOffsets[t + 1]);
+         REQUIRE(neighbors == expectedNeighbors);
+      }
+
+      for (int v = 0; v < buffers.vertexCount; ++v)
+      {
+         std::vector<int> neighbors(adjacency.vertexNeighbors.begin() + adjacency.vertexOffsets[v], 
+                                    adjacency.vertexNeighbors.begin() + adjacency.vertexOffsets[v + 1]);
+         std::vector<int> triangles(adjacency.vertexTriangles.begin() + adjacency.vertexTriangleOffsets[v], 
+                                    adjacency.vertexTriangles.begin() + adjacency.vertexTriangleOffsets[v + 1]);
+
+         REQUIRE(neighbors == std::vector<int>(vertexNeighbors[v].begin(), vertexNeighbors[v].end()));
+         REQUIRE(triangles == std::vector<int>(vertexTriangles[v].begin(), vertexTriangles[v].end()));
+      }
+      REQUIRE(adjacency.vertexNeighbors.size() == 2 * (size_t)buffers.edgeCount);
+
+      // the subsegments are restored
+      MeshBuffers buffersAfter;
+      buffersAfter.exportEdges = true;
+      REQUIRE(trAdjGenerator.exportMesh(buffersAfter));
+      REQUIRE(buffersAfter.edgeMarkers == buffers.edgeMarkers);
+
+      // a bigger mesh, exported on several threads and on one thread
+      std::vector<Delaunay::Point> randomPoints;
+      std::mt19937 randGen(7);
+      std::uniform_real_distribution<double> coord(0.0, 100.0);
+
+      for (int i = 0; i < 20000; ++i)
+      {
+         randomPoints.push_back(Delaunay::Point(coord(randGen), coord(randGen)));
+      }
+
+      Delaunay trBigGenerator(randomPoints);
+      trBigGenerator.setThreadCount(4);
+      trBigGenerator.Triangulate(dbgOutput);
+
+      MeshAdjacency multi;
+      REQUIRE(trBigGenerator.exportAdjacency(multi));
+
+      trBigGenerator.setThreadCount(1);
+
+      MeshAdjacency single;
+      single.exportVertexNeighbors = false;
+      REQUIRE(trBigGenerator.exportAdjacency(single));
+
+      REQUIRE(single.vertexOffsets.empty());
+      REQUIRE(single.vertexNeighbors.empty());
+      REQUIRE(multi.vertexTriangleOffsets == single.vertexTriangleOffsets);
+      REQUIRE(multi.vertexTriangles == single.vertexTriangles);
+      REQUIRE(multi.triangleOffsets == single.triangleOffsets);
+      REQUIRE(multi.triangleNeighbors == single.triangleNeighbors);
+      REQUIRE(multi.triangleNeighbors.size() == 3 * (size_t)multi.triangleCount - trBigGenerator.hullSize());
+      REQUIRE(multi.vertexNeighbors.size() == 2 * (size_t)trBigGenerator.edgeCount());
+   }
+
+   SECTION("TEST 13.8: Locate vertices in O(1), also the Steiner points")
+   {
+      std::vector<int> segmentsEndpointIdx = { 0, 9, 3, 9 };
+
+      Delaunay trQualGenerator(pslgExamplePoints);
+      trQualGenerator.setSegmentConstraint(segmentsEndpointIdx);
+      trQualGenerator.useConvexHullWithSegments(true);
+      trQualGenerator.setQualityConstraints(30.0f, 0.1f);
+      trQualGenerator.Triangulate(true, dbgOutput);
+
+      MeshBuffers buffers;
+      REQUIRE(trQualGenerator.exportMesh(buffers));
+      REQUIRE(buffers.vertexCount > (int)pslgExamplePoints.size());
+
+      MeshAdjacency adjacency;
+      REQUIRE(trQualGenerator.exportAdjacency(adjacency));
+
+      std::set<std::array<int, 3>> triangles;
+      for (int t = 0; t < buffers.triangleCount; ++t)
+      {
+         std::array<int, 3> tri = { buffers.triangles[3 * t], buffers.triangles[3 * t + 1], buffers.triangles[3 * t + 2] };
+         std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+         triangles.insert(tri);
+      }
+
+      auto qualMesh = trQualGenerator.mesh();
+      bool allFound = true;
+      bool allStarsComplete = true;
+
+      for (int v = 0; v < buffers.vertexCount; ++v)
+      {
+         Delaunay::Point point;
+         qualMesh.locate(v).Org(&point);
+         allFound = allFound && point[0] == buffers.points[2 * v] && point[1] == buffers.points[2 * v + 1];
+
+         std::vector<int> ivv;
+         qualMesh.trianglesAroundVertex(v, ivv);
+         allStarsComplete = allStarsComplete && 
+            ivv.size() == 3 * (size_t)(adjacency.vertexTriangleOffsets[v + 1] - adjacency.vertexTriangleOffsets[v]);
+
+         for (size_t i = 0; i < ivv.size(); i += 3)
+         {
+            std::array<int, 3> tri = { ivv[i], ivv[i + 1], ivv[i + 2] };
+            allStarsComplete = allStarsComplete && tri[0] == v;
+
+            std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+            allStarsComplete = allStarsComplete && triangles.count(tri) == 1;
+         }
+      }
+
+      REQUIRE(allFound);
+      REQUIRE(allStarsComplete);
+
+      // a duplicate point is in no triangle, its twin is found
+      std::vector<Delaunay::Point> duplicatePoints = pslgExamplePoints;
+      duplicatePoints.push_back(pslgExamplePoints[4]);
+
+      Delaunay trDupGenerator(duplicatePoints);
+      trDupGenerator.Triangulate(dbgOutput);
+
+      auto dupMesh = trDupGenerator.mesh();
+      REQUIRE(dupMesh.locate((int)duplicatePoints.size() - 1).Org() == 4);
+
+      // the links made by the first locate() are renewed after the in-place insertion
+      Delaunay trUpdateGenerator(pslgExamplePoints);
+      trUpdateGenerator.Triangulate(dbgOutput);
+      REQUIRE(trUpdateGenerator.mesh().locate(4).Org() == 4);
+      trUpdateGenerator.insertPoints({ Delaunay::Point(2, 0.5) });
+
+      auto updatedMesh = trUpdateGenerator.mesh();
+      int newVertex = (int)pslgExamplePoints.size();
+
+      REQUIRE(updatedMesh.locate(newVertex).Org() == newVertex);
+      REQUIRE(updatedMesh.locate(4).Org() == 4);
+   }
+
+   SECTION("TEST 13.9: First vertex locations from several threads at once")
+   {
+      std::vector<Delaunay::Point> randomPoints;
+      std::mt19937 randGen(2025);
+      std::uniform_real_distribution<double> coord(0.0, 1000.0);
+
+      for (int i = 0; i < 20000; ++i)
+      {
+         randomPoints.push_back(Delaunay::Point(coord(randGen), coord(randGen)));
+      }
+
+      // the vertex stars of a triangulation which is queried from one thread only
+      auto collectStars = [](Delaunay& triGen, int first, int step)
+      {
+         auto mesh = triGen.mesh();
+         std::vector<std::vector<int>> stars(triGen.verticeCount());
+
+         for (int v = first; v < (int)stars.size(); v += step)
+         {
+            if (mesh.locate(v).Org() != v)
+            {
+               stars[v].push_back(-1);
+               continue;
+            }
+            mesh.trianglesAroundVertex(v, stars[v]);
+         }
+         return stars;
+      };
+
+      auto checkConcurrentStars = [&](Delaunay& triGen, const std::vector<std::vector<int>>& expected)
+      {
+         const int threadCount = 8;
+         std::vector<std::vector<std::vector<int>>> results(threadCount);
+         std::vector<std::thread> threads;
+         std::atomic<int> waiting(threadCount);
+
+         for (int t = 0; t < threadCount; ++t)
+         {
+            threads.emplace_back([&, t]()
+            {
+               // all threads make their first call together
+               --waiting;
+               while (waiting > 0) 
+               {
+                  std::this_thread::yield();
+               }
+               results[t] = collectStars(triGen, t, threadCount);
+            });
+         }
+         for (auto& thread : threads)
+         {
+            thread.join();
+         }
+
+         bool allEqual = true;
+
+         for (int t = 0; t < threadCount; ++t)
+         {
+            for (size_t v = t; v < expected.size(); v += threadCount)
+            {
+               allEqual = allEqual && results[t][v] == expected[v];
+            }
+         }
+         return allEqual;
+      };
+
+      Delaunay trReference(randomPoints);
+      trReference.Triangulate(dbgOutput);
+
+      Delaunay trGenerator(randomPoints);
+      trGenerator.Triangulate(dbgOutput);
+      REQUIRE(checkConcurrentStars(trGenerator, collectStars(trReference, 0, 1)));
+
+      // the links are made again after an in-place update
+      std::vector<Delaunay::Point> newPoints = { Delaunay::Point(500.5, 500.25), Delaunay::Point(10.125, 990.5) };
+      trReference.insertPoints(newPoints);
+      trGenerator.insertPoints(newPoints);
+      REQUIRE(checkConcurrentStars(trGenerator, collectStars(trReference, 0, 1)));
+   }
+
+   // ... more to come...
+}
+
+
+TEST_CASE("Different triangulation algorithms", "[trpp]")
+{
+   std::vector<Delaunay::Point> pslgDelaunayInput;
+   std::vector<Delaunay::Point> pslgDelaunaySegments;
+
+   preparePLSGTestData(pslgDelaunayInput, pslgDelaunaySegments);
+
+   Delaunay triGen(pslgDelaunayInput);
+
+   triGen.Triangulate();
+   auto triCountDefault = triGen.triangleCount();
+
+   REQUIRE(triCountDefault == 13);
+
+   triGen.setAlgorithm(DivideConquer);
+   triGen.Triangulate();
+   auto triCountDivideConquer = triGen.triangleCount();
+
+   REQUIRE(triCountDefault == triCountDivideConquer);
+
+   triGen.setAlgorithm(Incremental);
+   triGen.Triangulate();
+   auto triCountIncremental = triGen.triangleCount();
+
+   REQUIRE(triCountDefault == triCountIncremental);
+
+   triGen.setAlgorithm(Sweepline);
+   triGen.Triangulate();
+   auto triCountSweepline = triGen.triangleCount();
+
+   REQUIRE(triCountDefault == triCountSweepline);
+}
+
+
+TEST_CASE("Precision of the predicates", "[trpp]")
+{
+   // far away from the origin, like geographic coordinates
+   const double x0 = 5.4e6;
+   const double y0 = 4.1e5;
+
+   SECTION("TEST Q.1: exact paths counted, none in the unchecked mode")
+   {
+      // cocircular grid points need exact arithmetic
+      std::vector<Delaunay::Point> gridPoints;
+
+      for (int i = 0; i < 40; ++i)
+      {
+         for (int j = 0; j < 40; ++j)
+         {
+            gridPoints.push_back(Delaunay::Point(x0 + i * 0.25, y0 + j * 0.25));
+         }
+      }
+
+      Delaunay triGen(gridPoints);
+      REQUIRE(triGen.predicateStats().incircleTests == 0);
+
+      triGen.Triangulate(dbgOutput);
+      PredicateStats stats = triGen.predicateStats();
+
+      REQUIRE(stats.incircleExact > 0);
+      REQUIRE(stats.incircleExact <= stats.incircleTests);
+      REQUIRE(stats.orientationExact <= stats.orientationTests);
+      REQUIRE(triGen.triangleCount() == 2 * 39 * 39);
+
+      // the filters depend on the coordinate differences only, the same grid at the origin isn't easier
+      std::vector<Delaunay::Point> originPoints;
+
+      for (const auto& p : gridPoints)
+      {
+         originPoints.push_back(Delaunay::Point(p[0] - x0, p[1] - y0));
+      }
+
+      Delaunay originGen(originPoints);
+      originGen.Triangulate(dbgOutput);
+      PredicateStats originStats = originGen.predicateStats();
+
+      REQUIRE(originStats.incircleTests == stats.incircleTests);
+      REQUIRE(originStats.incircleExact == stats.incircleExact);
+      REQUIRE(originStats.orientationExact == stats.orientationExact);
+
+      triGen.setPredicateMode(Unchecked);
+      triGen.Triangulate(dbgOutput);
+      stats = triGen.predicateStats();
+
+      REQUIRE(stats.incircleTests > 0);
+      REQUIRE(stats.incircleExact == 0);
+      REQUIRE(stats.orientationExact == 0);
+   }
+}
+
+
+TEST_CASE("Multi-threaded triangulation", "[trpp]")
+{
+   // big enough input to be split among the threads
+   std::vector<Delaunay::Point> randomPoints;
+   std::mt19937 randGen(2024);
+   std::uniform_real_distribution<double> coord(0.0, 1000.0);
+
+   for (int i = 0; i < 150000; ++i)
+   {
+      randomPoints.push_back(Delaunay::Point(coord(randGen), coord(randGen)));
+   }
+
+   auto collectTriangles = [](Delaunay& triGen)
+   {
+      std::set<std::array<int, 3>> triangles;
+
+      for (const auto& f : triGen.faces())
+      {
+         std::array<int, 3> tri = { f.Org(), f.Dest(), f.Apex() };
+         std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+         triangles.insert(tri);
+      }
+      return triangles;
+   };
+
+   SECTION("TEST P.1: divide-and-conquer with several threads gives the same triangulation")
+   {
+      Delaunay triGenSingle(randomPoints);
+      triGenSingle.Triangulate(dbgOutput);
+
+      Delaunay triGenMulti(randomPoints);
+      triGenMulti.setThreadCount(4);
+      triGenMulti.Triangulate(dbgOutput);
+
+      REQUIRE(triGenMulti.triangleCount() == triGenSingle.triangleCount());
+      REQUIRE(triGenMulti.hullSize() == triGenSingle.hullSize());
+      REQUIRE(collectTriangles(triGenMulti) == collectTriangles(triGenSingle));
+   }
+
+   SECTION("TEST P.2: quality triangulation after a multi-threaded divide-and-conquer")
+   {
+      Delaunay triGen(randomPoints);
+      triGen.setThreadCount(4);
+      triGen.setMinAngle(25.0f);
+      triGen.Triangulate(true, dbgOutput);
+
+      int count = 0;
+      for (const auto& f : triGen.faces())
+      {
+         (void)f;
+         ++count;
+      }
+
+      REQUIRE(count == triGen.triangleCount());
+      REQUIRE(triGen.triangleCount() > 2 * (int)randomPoints.size() - triGen.hullSize() - 2);
+   }
+
+   SECTION("TEST P.3: incremental algorithm with spatially sorted insertion order")
+   {
+      Delaunay triGenDivConq(randomPoints);
+      triGenDivConq.Triangulate(dbgOutput);
+
+      Delaunay triGenIncremental(randomPoints);
+      triGenIncremental.setAlgorithm(Incremental);
+      triGenIncremental.Triangulate(dbgOutput);
+
+      REQUIRE(triGenIncremental.triangleCount() == triGenDivConq.triangleCount());
+      REQUIRE(collectTriangles(triGenIncremental) == collectTriangles(triGenDivConq));
+   }
+
+   SECTION("TEST P.4: batch of independent triangulations on several threads")
+   {
+      std::vector<TriangulationJob> jobs(40);
+
+      for (size_t i = 0; i < jobs.size(); ++i)
+      {
+         auto& job = jobs[i];
+         job.points.assign(randomPoints.begin() + i * 500, randomPoints.begin() + i * 500 + 200 + i * 20);
+         job.quality = (i % 3 == 0);
+         job.minAngle = (i % 2 == 0) ? 25.0f : 0.0f;
+
+         if (i % 5 == 0)
+         {
+            job.segments = { 0, 1, 2, 3 };
+         }
+      }
+      jobs[7].segments = { 0, 100000 }; // invalid!
+
+      triangulateBatch(jobs, 4);
+
+      for (size_t i = 0; i < jobs.size(); ++i)
+      {
+         const auto& job = jobs[i];
+
+         if (i == 7)
+         {
+            REQUIRE(!job.succeeded);
+            REQUIRE(!job.error.empty());
+            continue;
+         }
+
+         // the same as a triangulation on its own
+         Delaunay triGen(job.points);
+         if (!job.segments.empty())
+         {
+            triGen.setSegmentConstraint(job.segments);
+         }
+         triGen.setMinAngle(job.minAngle);
+         triGen.Triangulate(job.quality, dbgOutput);
+
+         MeshBuffers expected;
+         REQUIRE(triGen.exportMesh(expected));
+
+         REQUIRE(job.succeeded);
+         REQUIRE(job.mesh.triangleCount == expected.triangleCount);
+         REQUIRE(job.mesh.points == expected.points);
+         REQUIRE(job.mesh.triangles == expected.triangles);
+         REQUIRE(job.mesh.neighbors == expected.neighbors);
+      }
+   }
+
+   SECTION("TEST P.5: small tiles give the same triangulation")
+   {
+      Delaunay triGenSingle(randomPoints);
+      triGenSingle.Triangulate(dbgOutput);
+
+      Delaunay triGenTiled(randomPoints);
+      triGenTiled.setThreadCount(2);
+      triGenTiled.setTileSize(2048); // ~64 tiles
+      triGenTiled.Triangulate(dbgOutput);
+
+      REQUIRE(triGenTiled.triangleCount() == triGenSingle.triangleCount());
+      REQUIRE(triGenTiled.hullSize() == triGenSingle.hullSize());
+      REQUIRE(collectTriangles(triGenTiled) == collectTriangles(triGenSingle));
+   }
+
+   SECTION("TEST P.6: parallel refinement keeps the angle and area bounds")
+   {
+      // a square with an inner quadrilateral, all input angles are big enough
+      std::vector<Delaunay::Point> pslgPoints = {
+         { 0, 0 }, { 1000, 0 }, { 1000, 1000 }, { 0, 1000 },
+         { 300, 300 }, { 700, 310 }, { 690, 700 }, { 310, 690 } };
+      std::vector<int> segments = { 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4 };
+
+      pslgPoints.insert(pslgPoints.end(), randomPoints.begin(), randomPoints.begin() + 20000);
+
+      const float minAngle = 30.0f;
+      const float maxArea = 10.0f;
+
+      for (unsigned threads : { 1u, 4u })
+      {
+         Delaunay triGen(pslgPoints);
+         triGen.setThreadCount(threads);
+         triGen.setSegmentConstraint(segments);
+         triGen.setMinAngle(minAngle);
+         triGen.setMaxArea(maxArea);
+         triGen.Triangulate(true, dbgOutput);
+
+         double smallestAngle = 180.0;
+         double largestArea = 0.0;
+         double totalArea = 0.0;
+
+         for (const auto& f : triGen.faces())
+         {
+            Delaunay::Point corners[3];
+            f.Org(&corners[0]);
+            f.Dest(&corners[1]);
+            f.Apex(&corners[2]);
+
+            for (int i = 0; i < 3; ++i)
+            {
+               const auto& p0 = corners[i];
+               const auto& p1 = corners[(i + 1) % 3];
+               const auto& p2 = corners[(i + 2) % 3];
+               double ux = p1[0] - p0[0], uy = p1[1] - p0[1];
+               double vx = p2[0] - p0[0], vy = p2[1] - p0[1];
+               double angle = std::acos((ux * vx + uy * vy) / std::sqrt((ux * ux + uy * uy) * (vx * vx + vy * vy)));
+
+               smallestAngle = std::min(smallestAngle, angle * 180.0 / 3.14159265358979323846);
+            }
+
+            double area = f.area();
+            REQUIRE(area > 0.0);
+
+            largestArea = std::max(largestArea, area);
+            totalArea += area;
+         }
+
+         REQUIRE(smallestAngle >= minAngle - 1e-6);
+         REQUIRE(largestArea <= maxArea);
+         REQUIRE(std::abs(totalArea - 1000.0 * 1000.0) < 1e-3);
+      }
+   }
+
+   SECTION("TEST P.7: parallel loops over the faces and vertices")
+   {
+      Delaunay triGen(randomPoints);
+      triGen.setThreadCount(4);
+      triGen.Triangulate(dbgOutput);
+
+      // leaves dead triangles and vertices in the memory pools
+      std::vector<int> removedIdx;
+      for (int i = 10; i < (int)randomPoints.size(); i += 97)
+      {
+         removedIdx.push_back(i);
+      }
+      REQUIRE(triGen.removePoints(removedIdx));
+
+      std::set<std::array<int, 3>> triangles;
+      std::mutex resultMutex;
+      std::atomic<int> faceCount(0);
+
+      parallelForFaces(triGen, [&](const FaceIterator& f)
+         {
+            std::array<int, 3> tri = { f.Org(), f.Dest(), f.Apex() };
+            std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+            ++faceCount;
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            triangles.insert(tri);
+         }, 4);
+
+      REQUIRE(faceCount == triGen.triangleCount());
+      REQUIRE(triangles == collectTriangles(triGen));
+      REQUIRE(triGen.faces().ranges().size() > 1);
+
+      std::vector<int> vertexIds;
+      for (const auto& v : triGen.vertices())
+      {
+         vertexIds.push_back(v.vertexId());
+      }
+
+      std::vector<int> parallelVertexIds;
+      parallelForVertices(triGen, [&](const VertexIterator& v)
+         {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            parallelVertexIds.push_back(v.vertexId());
+         }, 4);
+
+      std::sort(vertexIds.begin(), vertexIds.end());
+      std::sort(parallelVertexIds.begin(), parallelVertexIds.end());
+      REQUIRE(parallelVertexIds == vertexIds);
+
+      // exceptions are passed to the caller
+      REQUIRE_THROWS_AS(parallelForFaces(triGen, [](const FaceIterator&) { throw std::runtime_error("stop"); }, 4),
+                        std::runtime_error);
+
+      Delaunay emptyGen(randomPoints);
+      REQUIRE(emptyGen.faces().ranges().empty());
+   }
+
+   SECTION("TEST P.8: radix sort and keyed alternating cuts of big inputs with equal coordinates")
+   {
+      // many equal x and y keys (incl. -0.0 and 0.0) and duplicates, but no 4 cocircular points, so the 
+      // Delaunay triangulation is unique
+      std::vector<Delaunay::Point> linePoints;
+      std::uniform_real_distribution<double> lineCoord(-100.0, 100.0);
+
+      for (int i = 0; i < 40000; ++i)
+      {
+         double line = (double)(i % 41 - 20);
+         if (line == 0.0 && i % 2 == 0)
+         {
+            line = -0.0;
+         }
+
+         if (i % 3 == 0)
+         {
+            linePoints.push_back(Delaunay::Point(lineCoord(randGen), line)); // on horizontal lines
+         }
+         else
+         {
+            linePoints.push_back(Delaunay::Point(line, lineCoord(randGen))); // on vertical lines
+         }
+      }
+
+      for (int i = 0; i < 40000; i += 9)
+      {
+         linePoints.push_back(linePoints[i]);
+      }
+
+      // by coordinates, as another algorithm may keep the other one of two duplicates
+      auto collectCorners = [](Delaunay& triGen)
+      {
+         std::set<std::array<double, 6>> triangles;
+
+         for (const auto& f : triGen.faces())
+         {
+            std::array<Delaunay::Point, 3> corners;
+            f.Org(&corners[0]);
+            f.Dest(&corners[1]);
+            f.Apex(&corners[2]);
+
+            auto first = std::min_element(corners.begin(), corners.end(), 
+                                          [](const Delaunay::Point& a, const Delaunay::Point& b) 
+                                             { return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]); });
+            std::rotate(corners.begin(), first, corners.end());
+
+            triangles.insert({ corners[0][0] + 0.0, corners[0][1] + 0.0, corners[1][0] + 0.0, corners[1][1] + 0.0, 
+                               corners[2][0] + 0.0, corners[2][1] + 0.0 });
+         }
+         return triangles;
+      };
+
+      Delaunay triGenIncremental(linePoints);
+      triGenIncremental.setAlgorithm(Incremental);
+      triGenIncremental.Triangulate(dbgOutput);
+
+      auto expected = collectCorners(triGenIncremental);
+
+      for (unsigned threads : { 1u, 4u })
+      {
+         Delaunay triGenDivConq(linePoints);
+         triGenDivConq.setThreadCount(threads);
+         triGenDivConq.Triangulate(dbgOutput);
+
+         REQUIRE(triGenDivConq.triangleCount() == triGenIncremental.triangleCount());
+         REQUIRE(triGenDivConq.hullSize() == triGenIncremental.hullSize());
+         REQUIRE(collectCorners(triGenDivConq) == expected);
+      }
+   }
+}
+
+
+TEST_CASE("Incremental updates of a triangulation", "[trpp]")
+{
+   std::vector<Delaunay::Point> basePoints;
+   std::vector<Delaunay::Point> newPoints;
+   std::mt19937 randGen(4711);
+   std::uniform_real_distribution<double> coord(0.0, 100.0);
+   std::uniform_real_distribution<double> innerCoord(10.0, 90.0);
+
+   // corners span the hull, so all the other points are inner points
+   basePoints.push_back(Delaunay::Point(-1.0, -1.0));
+   basePoints.push_back(Delaunay::Point(101.0, -1.0));
+   basePoints.push_back(Delaunay::Point(101.0, 101.0));
+   basePoints.push_back(Delaunay::Point(-1.0, 101.0));
+
+   for (int i = 0; i < 2000; ++i)
+   {
+      basePoints.push_back(Delaunay::Point(coord(randGen), coord(randGen)));
+   }
+
+   for (int i = 0; i < 300; ++i)
+   {
+      newPoints.push_back(Delaunay::Point(innerCoord(randGen), innerCoord(randGen)));
+   }
+
+   auto collectTriangles = [](Delaunay& triGen)
+   {
+      std::set<std::array<int, 3>> triangles;
+
+      for (const auto& f : triGen.faces())
+      {
+         std::array<int, 3> tri = { f.Org(), f.Dest(), f.Apex() };
+         std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+         triangles.insert(tri);
+      }
+      return triangles;
+   };
+
+   SECTION("TEST U.1: insert points into an existing triangulation")
+   {
+      Delaunay triGen(basePoints);
+      triGen.Triangulate(dbgOutput);
+      triGen.insertPoints(newPoints);
+
+      std::vector<Delaunay::Point> allPoints(basePoints);
+      allPoints.insert(allPoints.end(), newPoints.begin(), newPoints.end());
+
+      Delaunay triGenExpected(allPoints);
+      triGenExpected.Triangulate(dbgOutput);
+
+      REQUIRE(triGen.triangleCount() == triGenExpected.triangleCount());
+      REQUIRE(triGen.hullSize() == triGenExpected.hullSize());
+      REQUIRE(triGen.edgeCount() == triGenExpected.edgeCount());
+      REQUIRE(collectTriangles(triGen) == collectTriangles(triGenExpected));
+   }
+
+   SECTION("TEST U.2: remove points from an existing triangulation")
+   {
+      std::vector<int> removedIdx;
+      std::vector<Delaunay::Point> remainingPoints;
+
+      for (int i = 0; i < (int)basePoints.size(); ++i)
+      {
+         if (i > 4 && i % 7 == 0)
+         {
+            removedIdx.push_back(i);
+         }
+         else
+         {
+            remainingPoints.push_back(basePoints[i]);
+         }
+      }
+
+      Delaunay triGen(basePoints);
+      triGen.Triangulate(dbgOutput);
+      REQUIRE(triGen.removePoints(removedIdx));
+
+      Delaunay triGenExpected(remainingPoints);
+      triGenExpected.Triangulate(dbgOutput);
+
+      REQUIRE(triGen.triangleCount() == triGenExpected.triangleCount());
+      REQUIRE(triGen.hullSize() == triGenExpected.hullSize());
+      REQUIRE(collectTriangles(triGen) == collectTriangles(triGenExpected));
+      REQUIRE(triGen.pointAtVertexId(5) == remainingPoints[5]);
+
+      REQUIRE(!triGen.removePoints({ (int)remainingPoints.size() }));
+   }
+
+   SECTION("TEST U.3: points outside of the hull and quality triangulations")
+   {
+      std::vector<Delaunay::Point> outerPoints = { Delaunay::Point(200.0, 50.0), Delaunay::Point(50.0, -200.0) };
+
+      Delaunay triGen(basePoints);
+      triGen.Triangulate(dbgOutput);
+      triGen.insertPoints(outerPoints);
+      REQUIRE(triGen.removePoints({ 0, 1 }));
+
+      std::vector<Delaunay::Point> allPoints(basePoints.begin() + 2, basePoints.end());
+      allPoints.insert(allPoints.end(), outerPoints.begin(), outerPoints.end());
+
+      Delaunay triGenExpected(allPoints);
+      triGenExpected.Triangulate(dbgOutput);
+
+      REQUIRE(collectTriangles(triGen) == collectTriangles(triGenExpected));
+
+      Delaunay triGenQuality(basePoints);
+      triGenQuality.setMinAngle(25.0f);
+      triGenQuality.Triangulate(true, dbgOutput);
+      int triangleCount = triGenQuality.triangleCount();
+
+      triGenQuality.insertPoints(newPoints);
+      REQUIRE(triGenQuality.triangleCount() > triangleCount);
+   }
+
+   SECTION("TEST U.4: repeated triangulations reusing the memory pools")
+   {
+      Delaunay triGenExpected(basePoints);
+      triGenExpected.Triangulate(dbgOutput);
+      auto expectedTriangles = collectTriangles(triGenExpected);
+
+      Delaunay triGenQualityExpected(basePoints);
+      triGenQualityExpected.setMinAngle(25.0f);
+      triGenQualityExpected.Triangulate(true, dbgOutput);
+
+      Delaunay triGen(basePoints);
+      triGen.enableMemoryPoolReuse();
+
+      for (int i = 0; i < 3; ++i)
+      {
+         triGen.removeQualityConstraints();
+         triGen.Triangulate(dbgOutput);
+         REQUIRE(collectTriangles(triGen) == expectedTriangles);
+
+         // other switches, other pool item sizes
+         triGen.setMinAngle(25.0f);
+         triGen.Triangulate(true, dbgOutput);
+         REQUIRE(triGen.triangleCount() == triGenQualityExpected.triangleCount());
+      }
+
+      triGen.insertPoints(newPoints);
+      REQUIRE(triGen.triangleCount() > triGenQualityExpected.triangleCount());
+   }
+}
+
+
+TEST_CASE("Memory used by a triangulation", "[trpp]")
+{
+   std::vector<Delaunay::Point> randomPoints;
+   std::mt19937 randGen(815);
+   std::uniform_real_distribution<double> coord(0.0, 100.0);
+
+   for (int i = 0; i < 20000; ++i)
+   {
+      randomPoints.push_back(Delaunay::Point(coord(randGen), coord(randGen)));
+   }
+
+   Delaunay triGenExpected(randomPoints);
+   triGenExpected.setMinAngle(20.0f);
+   triGenExpected.Triangulate(true, dbgOutput);
+
+   SECTION("TEST M.1: triangulation in a memory arena")
+   {
+      std::pmr::monotonic_buffer_resource arena;
+      std::pmr::memory_resource* resource = &arena;
+
+      Delaunay triGen(randomPoints);
+      triGen.setMemoryResource(resource);
+      triGen.setMinAngle(20.0f);
+      triGen.Triangulate(true, dbgOutput);
+
+      REQUIRE(triGen.triangleCount() == triGenExpected.triangleCount());
+
+      triGen.Tesselate(false, dbgOutput);
+      REQUIRE(triGen.voronoiPointCount() == triGen.triangleCount());
+   }
+
+   SECTION("TEST M.2: memory limit exceeded")
+   {
+      Delaunay triGen(randomPoints);
+      triGen.setMemoryLimit(1024 * 1024);
+      triGen.setMinAngle(20.0f);
+
+      REQUIRE_THROWS_AS(triGen.Triangulate(true, dbgOutput), std::bad_alloc);
+      REQUIRE(!triGen.hasTriangulation());
+
+      triGen.setMemoryLimit(0);
+      triGen.Triangulate(true, dbgOutput);
+
+      REQUIRE(triGen.triangleCount() == triGenExpected.triangleCount());
+   }
+
+   SECTION("TEST M.3: memory reserved for the mesh")
+   {
+      Delaunay triGenEstimated(randomPoints);
+      triGenEstimated.reserve();
+      triGenEstimated.setMinAngle(20.0f);
+      triGenEstimated.Triangulate(true, dbgOutput);
+
+      REQUIRE(triGenEstimated.triangleCount() == triGenExpected.triangleCount());
+
+      Delaunay triGenReserved(randomPoints);
+      triGenReserved.reserve(100000, 200000, 1000);
+      triGenReserved.setThreadCount(2);
+      triGenReserved.setMinAngle(20.0f);
+      triGenReserved.Triangulate(true, dbgOutput);
+
+      REQUIRE(triGenReserved.triangleCount() > 2 * (int)randomPoints.size() - triGenReserved.hullSize() - 2);
+   }
+
+   SECTION("TEST M.4: memory reserved for reused pools")
+   {
+      Delaunay triGen(randomPoints);
+      triGen.enableMemoryPoolReuse();
+      triGen.setMemoryLimit(64 * 1024 * 1024);
+      triGen.Triangulate(false, dbgOutput);
+
+      int triangleCount = triGen.triangleCount();
+
+      // the kept first blocks are too small, so the reserved ones are allocated and exceed the limit
+      triGen.reserve(4000000, 8000000);
+      REQUIRE_THROWS_AS(triGen.Triangulate(false, dbgOutput), std::bad_alloc);
+
+      triGen.reserve(100000, 200000);
+      triGen.Triangulate(false, dbgOutput);
+
+      REQUIRE(triGen.triangleCount() == triangleCount);
+   }
+}
+
+
+TEST_CASE("Control of long triangulations", "[trpp]")
+{
+   // a square with a square hole in the middle, filled with random points
+   std::vector<Delaunay::Point> pslgPoints = {
+      { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 },
+      { 40, 40 }, { 60, 40 }, { 60, 60 }, { 40, 60 } };
+   std::vector<int> segments = { 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4 };
+   std::vector<Delaunay::Point> holes = { { 50, 50 } };
+
+   std::mt19937 randGen(4711);
+   std::uniform_real_distribution<double> coord(0.5, 99.5);
+
+   while (pslgPoints.size() < 20008)
+   {
+      Delaunay::Point p(coord(randGen), coord(randGen));
+      if (p[0] < 39.5 || p[0] > 60.5 || p[1] < 39.5 || p[1] > 60.5)
+      {
+         pslgPoints.push_back(p);
+      }
+   }
+
+   auto setInput = [&](Delaunay& triGen)
+   {
+      triGen.setSegmentConstraint(segments);
+      triGen.setHolesConstraint(holes);
+      triGen.setMinAngle(30.0f);
+      triGen.setMaxArea(0.05f);
+   };
+
+   SECTION("TEST C.1: progress reported for each phase")
+   {
+      for (unsigned threads : { 1u, 2u })
+      {
+         std::vector<TriangulationProgress> reports;
+
+         RunControl control;
+         control.progressIntervalSeconds = 0.0;
+         control.progress = [&](const TriangulationProgress& progress) { reports.push_back(progress); };
+
+         Delaunay triGen(pslgPoints);
+         triGen.setThreadCount(threads);
+         triGen.setRunControl(control);
+         setInput(triGen);
+         triGen.Triangulate(true, dbgOutput);
+
+         REQUIRE(triGen.hasTriangulation());
+         REQUIRE(!triGen.refinementStopped());
+         REQUIRE(reports.size() > 8);
+
+         // each phase starts with nothing done and ends with everything done
+         const TriangulationPhase phases[] = { Triangulating, InsertingSegments, CarvingHoles, Refining };
+         size_t next = 0;
+
+         for (TriangulationPhase phase : phases)
+         {
+            REQUIRE(next < reports.size());
+            REQUIRE(reports[next].phase == phase);
+            REQUIRE(reports[next].done == 0);
+
+            while (next + 1 < reports.size() && reports[next + 1].phase == phase)
+            {
+               REQUIRE(reports[next + 1].done >= reports[next].done);
+               REQUIRE(reports[next + 1].elapsedSeconds >= reports[next].elapsedSeconds);
+               ++next;
+            }
+
+            REQUIRE(reports[next].done == reports[next].total);
+            ++next;
+         }
+         REQUIRE(next == reports.size());
+
+         REQUIRE(reports[0].total == pslgPoints.size());
+         REQUIRE(reports.back().done == (size_t)triGen.verticeCount() - pslgPoints.size());
+      }
+   }
+
+   SECTION("TEST C.2: Steiner point budget")
+   {
+      RunControl control;
+      control.maxSteinerPoints = 500;
+
+      Delaunay triGen(pslgPoints);
+      triGen.setRunControl(control);
+      setInput(triGen);
+      triGen.Triangulate(true, dbgOutput);
+
+      REQUIRE(triGen.hasTriangulation());
+      REQUIRE(triGen.refinementStopped());
+      REQUIRE(triGen.verticeCount() <= (int)pslgPoints.size() + 500);
+
+      control.maxSteinerPoints = -1;
+      triGen.setRunControl(control);
+      triGen.Triangulate(true, dbgOutput);
+
+      REQUIRE(!triGen.refinementStopped());
+      REQUIRE(triGen.verticeCount() > (int)pslgPoints.size() + 500);
+   }
+
+   SECTION("TEST C.3: cancellation at a safe point")
+   {
+      for (TriangulationPhase cancelIn : { Triangulating, Refining })
+      {
+         for (AlgorithmType algorithm : { DivideConquer, Incremental, Sweepline })
+         {
+            RunControl control;
+            CancellationToken token = control.cancellation;
+            bool cancel = true;
+            control.progressIntervalSeconds = 0.0;
+
+            // as if cancelled by another thread
+            control.progress = [&](const TriangulationProgress& progress) 
+               {
+                  if (cancel && progress.phase == cancelIn && progress.done > 0) token.cancel();
+               };
+
+            Delaunay triGen(pslgPoints);
+            triGen.setAlgorithm(algorithm);
+            triGen.setThreadCount(2);
+            triGen.setRunControl(control);
+            setInput(triGen);
+
+            try
+            {
+               triGen.Triangulate(true, dbgOutput);
+               FAIL("Triangulation not cancelled");
+            }
+            catch (const TriangulationAborted& e)
+            {
+               REQUIRE(e.reason() == TriangulationAborted::Cancelled);
+               REQUIRE(e.phase() == cancelIn);
+            }
+            REQUIRE(!triGen.hasTriangulation());
+
+            // usable again
+            cancel = false;
+            token.reset();
+            triGen.Triangulate(true, dbgOutput);
+            REQUIRE(triGen.hasTriangulation());
+         }
+      }
+   }
+
+   SECTION("TEST C.4: time budget")
+   {
+      RunControl control;
+      control.timeBudgetSeconds = 1e-9;
+
+      Delaunay triGen(pslgPoints);
+      triGen.setRunControl(control);
+      setInput(triGen);
+
+      REQUIRE_THROWS_AS(triGen.Triangulate(true, dbgOutput), TriangulationAborted);
+      REQUIRE(!triGen.hasTriangulation());
+
+      // out of time while refining: the mesh is kept
+      control.timeBudgetSeconds = 2.0;
+      control.progress = [](const TriangulationProgress& progress)
+         {
+            if (progress.phase == Refining && progress.done > 0)
+            {
+               std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+            }
+         };
+      triGen.setRunControl(control);
+      triGen.Triangulate(true, dbgOutput);
+
+      REQUIRE(triGen.hasTriangulation());
+      REQUIRE(triGen.refinementStopped());
+   }
 }
 
 